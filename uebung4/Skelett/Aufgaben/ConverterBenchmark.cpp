@@ -0,0 +1,209 @@
+#include "ConverterBenchmark.h"
+
+#include "ImageConverter.h"
+#include "ImageIO.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <random>
+
+namespace
+{
+	/// Minimum time and number of runs per measurement
+	const double min_seconds = 0.5;
+	const unsigned int min_runs = 5;
+
+	/// <summary>
+	/// Get the name of an instruction set
+	/// </summary>
+	/// <param name="instruction_set">Instruction set</param>
+	/// <returns>Name</returns>
+	const char* get_name(const cg::instruction_set_t instruction_set)
+	{
+		switch (instruction_set)
+		{
+		case cg::instruction_set_t::avx2:
+			return "AVX2";
+		case cg::instruction_set_t::sse4:
+			return "SSE4";
+		default:
+			return "scalar";
+		}
+	}
+
+	/// <summary>
+	/// Compare two images value by value
+	/// </summary>
+	/// <param name="first">First image</param>
+	/// <param name="second">Second image with the same extents</param>
+	/// <param name="max_difference">Largest difference of the values as floats</param>
+	/// <returns>Number of differing values</returns>
+	template <cg::color_space_t color_space, typename value_t>
+	std::size_t compare(const cg::image<color_space, value_t>& first, const cg::image<color_space, value_t>& second, float& max_difference)
+	{
+		using traits = cg::value_traits<value_t>;
+
+		const auto* first_values = first.data()->data();
+		const auto* second_values = second.data()->data();
+
+		const auto values = static_cast<std::size_t>(first.get_width()) * first.get_height() * cg::color_channels<color_space>::value;
+
+		std::size_t differences = 0;
+		max_difference = 0.0f;
+
+		for (std::size_t v = 0; v < values; ++v)
+		{
+			const float difference = std::abs(traits::to_float(first_values[v]) - traits::to_float(second_values[v]));
+
+			if (difference != 0.0f || std::memcmp(&first_values[v], &second_values[v], sizeof(value_t)) != 0)
+			{
+				++differences;
+				max_difference = std::max(max_difference, difference);
+			}
+		}
+
+		return differences;
+	}
+
+	template <cg::color_space_t color_space>
+	std::size_t compare(const cg::planar_image<color_space>& first, const cg::planar_image<color_space>& second, float& max_difference)
+	{
+		return compare(cg::image_converter::to_interleaved(first), cg::image_converter::to_interleaved(second), max_difference);
+	}
+
+	/// <summary>
+	/// Measure a conversion with all supported instruction sets and write a line per instruction set
+	/// </summary>
+	/// <param name="output">Stream for the results</param>
+	/// <param name="name">Name of the conversion</param>
+	/// <param name="type">Name of the storage type</param>
+	/// <param name="original">Original image</param>
+	/// <param name="conversion">Conversion, e.g., image_converter::rgb_to_gray<float></param>
+	template <typename original_t, typename conversion_t>
+	void measure(std::ostream& output, const char* name, const char* type, const original_t& original, const conversion_t& conversion)
+	{
+		const auto previous = cg::image_converter::get_instruction_set();
+		const auto pixels = static_cast<double>(original.get_width()) * original.get_height();
+
+		cg::image_converter::set_instruction_set(cg::instruction_set_t::scalar);
+		const auto reference = conversion(original);
+
+		for (auto instruction_set = cg::instruction_set_t::scalar; instruction_set <= cg::image_converter::get_supported_instruction_set();
+			instruction_set = static_cast<cg::instruction_set_t>(static_cast<int>(instruction_set) + 1))
+		{
+			cg::image_converter::set_instruction_set(instruction_set);
+
+			// Warm up, and keep the fastest run
+			auto converted = conversion(original);
+
+			double best = 0.0;
+			double total = 0.0;
+
+			for (unsigned int run = 0; run < min_runs || total < min_seconds; ++run)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				converted = conversion(original);
+				const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+				best = (run == 0) ? duration.count() : std::min(best, duration.count());
+				total += duration.count();
+			}
+
+			float max_difference;
+			const auto differences = compare(converted, reference, max_difference);
+
+			output << std::left << std::setw(12) << name << std::setw(10) << type << std::setw(8) << get_name(instruction_set)
+				<< std::right << std::fixed << std::setprecision(1) << std::setw(10) << pixels / best / 1.0e6
+				<< std::setw(12) << differences << std::scientific << std::setprecision(2) << std::setw(12) << max_difference
+				<< std::defaultfloat << std::endl;
+		}
+
+		cg::image_converter::set_instruction_set(previous);
+	}
+
+	/// <summary>
+	/// Measure all conversions for a storage type
+	/// </summary>
+	/// <param name="output">Stream for the results</param>
+	/// <param name="type">Name of the storage type</param>
+	/// <param name="original">Original RGB image</param>
+	template <typename value_t>
+	void measure_all(std::ostream& output, const char* type, const cg::image<cg::color_space_t::RGB, float>& original)
+	{
+		const auto rgb = cg::image_converter::convert_storage<value_t>(original);
+		const auto hsv = cg::image_converter::rgb_to_hsv(rgb);
+		const auto gray = cg::image_converter::rgb_to_gray(rgb);
+
+		measure(output, "rgb_to_hsv", type, rgb, cg::image_converter::rgb_to_hsv<value_t>);
+		measure(output, "hsv_to_rgb", type, hsv, cg::image_converter::hsv_to_rgb<value_t>);
+		measure(output, "rgb_to_gray", type, rgb, cg::image_converter::rgb_to_gray<value_t>);
+		measure(output, "gray_to_bw", type, gray, cg::image_converter::gray_to_bw<value_t>);
+	}
+
+	/// <summary>
+	/// Measure all conversions of planar float images
+	/// </summary>
+	/// <param name="output">Stream for the results</param>
+	/// <param name="original">Original RGB image</param>
+	void measure_planar(std::ostream& output, const cg::image<cg::color_space_t::RGB, float>& original)
+	{
+		const auto rgb = cg::image_converter::to_planar(original);
+		const auto hsv = cg::image_converter::rgb_to_hsv(rgb);
+		const auto gray = cg::image_converter::rgb_to_gray(rgb);
+
+		measure(output, "rgb_to_hsv", "planar", rgb, [](const cg::planar_image<cg::color_space_t::RGB>& image) { return cg::image_converter::rgb_to_hsv(image); });
+		measure(output, "hsv_to_rgb", "planar", hsv, [](const cg::planar_image<cg::color_space_t::HSV>& image) { return cg::image_converter::hsv_to_rgb(image); });
+		measure(output, "rgb_to_gray", "planar", rgb, [](const cg::planar_image<cg::color_space_t::RGB>& image) { return cg::image_converter::rgb_to_gray(image); });
+		measure(output, "gray_to_bw", "planar", gray, [](const cg::planar_image<cg::color_space_t::Gray>& image) { return cg::image_converter::gray_to_bw(image); });
+	}
+
+	/// <summary>
+	/// Measure all conversions for all storage types
+	/// </summary>
+	/// <param name="output">Stream for the results</param>
+	/// <param name="original">Original RGB image</param>
+	void measure_all(std::ostream& output, const cg::image<cg::color_space_t::RGB, float>& original)
+	{
+		output << original.get_width() << "x" << original.get_height() << " pixels, megapixels per second (MP/s) of the fastest of at least "
+			<< min_runs << " runs, and differences to the scalar kernels" << std::endl;
+
+		output << std::left << std::setw(12) << "conversion" << std::setw(10) << "type" << std::setw(8) << "kernel"
+			<< std::right << std::setw(10) << "MP/s" << std::setw(12) << "differences" << std::setw(12) << "max. diff." << std::endl;
+
+		measure_all<float>(output, "float", original);
+		measure_all<cg::half>(output, "half", original);
+		measure_all<std::uint8_t>(output, "uint8", original);
+		measure_all<std::uint16_t>(output, "uint16", original);
+		measure_planar(output, original);
+	}
+}
+
+void cg::converter_benchmark::run(std::ostream& output, const unsigned int width, const unsigned int height)
+{
+	image<color_space_t::RGB, float> original(width, height);
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+	for (unsigned int j = 0; j < height; ++j)
+	{
+		for (unsigned int i = 0; i < width; ++i)
+		{
+			for (auto& value : original(i, j))
+			{
+				value = distribution(generator);
+			}
+		}
+	}
+
+	measure_all(output, original);
+}
+
+void cg::converter_benchmark::run(std::ostream& output, const std::string& path)
+{
+	measure_all(output, image_io::load_rgb_image(path));
+}
\ No newline at end of file
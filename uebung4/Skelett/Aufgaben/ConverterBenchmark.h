@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+namespace cg
+{
+	/// <summary>
+	/// Namespace and functions for measuring the throughput of the color space conversions of the image converter
+	///
+	/// Each conversion is run with every instruction set the processor supports, every storage type and the
+	/// planar float layout, and reported in megapixels per second, together with the number of values differing
+	/// from the scalar kernel and the largest difference.
+	/// </summary>
+	namespace converter_benchmark
+	{
+		/// <summary>
+		/// Measure the conversions of a random image
+		/// </summary>
+		/// <param name="output">Stream for the results</param>
+		/// <param name="width">Image width</param>
+		/// <param name="height">Image height</param>
+		void run(std::ostream& output, unsigned int width = 1920, unsigned int height = 1080);
+
+		/// <summary>
+		/// Measure the conversions of an image file
+		/// </summary>
+		/// <param name="output">Stream for the results</param>
+		/// <param name="path">Path to the RGB image file (PPM)</param>
+		void run(std::ostream& output, const std::string& path);
+	}
+}
\ No newline at end of file
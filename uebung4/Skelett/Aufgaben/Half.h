@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace cg
+{
+	/// <summary>
+	/// Half-precision (IEEE 754 binary16) floating point number for storing color values in two bytes
+	///
+	/// Only storage is provided: values are converted from floats, rounding to the nearest even value,
+	/// and back to floats for any arithmetic.
+	/// </summary>
+	class half
+	{
+	public:
+		/// <summary>
+		/// Constructor, initializing with zero
+		/// </summary>
+		half() : m_bits(0) { }
+
+		/// <summary>
+		/// Constructor, converting a float
+		/// </summary>
+		/// <param name="value">Value, which is rounded to the nearest representable one</param>
+		explicit half(float value);
+
+		/// <summary>
+		/// Convert to float, which is exact
+		/// </summary>
+		/// <returns>Value</returns>
+		operator float() const;
+
+		/// <summary>
+		/// Get the binary16 representation
+		/// </summary>
+		/// <returns>Sign, exponent and mantissa bits</returns>
+		std::uint16_t get_bits() const { return m_bits; }
+
+	private:
+		/// Sign, exponent and mantissa bits
+		std::uint16_t m_bits;
+	};
+}
+
+inline cg::half::half(const float value)
+{
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	const std::uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	if (bits >= (127u + 16u) << 23)
+	{
+		// Too large values become infinity, NaN stays a (quiet) NaN
+		this->m_bits = (bits > 255u << 23) ? 0x7E00 : 0x7C00;
+	}
+	else if (bits < (127u - 14u) << 23)
+	{
+		// Subnormal values: adding 0.5 aligns the mantissa, so that the float addition does the rounding
+		const std::uint32_t magic_bits = 126u << 23;
+
+		float magic, aligned;
+		std::memcpy(&magic, &magic_bits, sizeof(magic));
+		std::memcpy(&aligned, &bits, sizeof(aligned));
+
+		aligned += magic;
+		std::memcpy(&bits, &aligned, sizeof(bits));
+
+		this->m_bits = static_cast<std::uint16_t>(bits - magic_bits);
+	}
+	else
+	{
+		// Normal values: rebias the exponent and round the mantissa to the nearest even value
+		const std::uint32_t odd = (bits >> 13) & 1;
+
+		bits += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xFFF + odd;
+
+		this->m_bits = static_cast<std::uint16_t>(bits >> 13);
+	}
+
+	this->m_bits |= static_cast<std::uint16_t>(sign >> 16);
+}
+
+inline cg::half::operator float() const
+{
+	const std::uint32_t exponent_mask = 0x7C00u << 13;
+
+	std::uint32_t bits = (this->m_bits & 0x7FFFu) << 13;
+	const std::uint32_t exponent = bits & exponent_mask;
+
+	bits += (127u - 15u) << 23;
+
+	float value;
+
+	if (exponent == exponent_mask)
+	{
+		// Infinity or NaN
+		bits += (128u - 16u) << 23;
+		std::memcpy(&value, &bits, sizeof(value));
+	}
+	else if (exponent == 0)
+	{
+		// Zero or subnormal value, renormalized by a float subtraction
+		const std::uint32_t magic_bits = 113u << 23;
+
+		bits += 1u << 23;
+
+		float magic;
+		std::memcpy(&value, &bits, sizeof(value));
+		std::memcpy(&magic, &magic_bits, sizeof(magic));
+
+		value -= magic;
+	}
+	else
+	{
+		std::memcpy(&value, &bits, sizeof(value));
+	}
+
+	return (this->m_bits & 0x8000u) != 0 ? -value : value;
+}
\ No newline at end of file
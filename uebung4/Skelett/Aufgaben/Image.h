@@ -2,8 +2,10 @@
 
 #include "ImageTraits.h"
 #include "ImageBase.h"
+#include "ImageView.h"
 
 #include <array>
+#include <cstddef>
 #include <exception>
 #include <iostream>
 #include <fstream>
@@ -15,12 +17,14 @@ namespace cg
 	/// Image class
 	/// </summary>
 	/// <tparam name="color_space">Color space (RGB, HSV, ...)</tparam>
-	template <color_space_t color_space = color_space_t::RGB>
+	/// <tparam name="value_t">Storage type of the color values (float, half, std::uint8_t or std::uint16_t), see value_traits</tparam>
+	/// <tparam name="layout">Memory layout: interleaved tuples here, planes for planar images (see PlanarImage.h)</tparam>
+	template <color_space_t color_space = color_space_t::RGB, typename value_t = float, layout_t layout = layout_t::interleaved>
 	class image : public image_base
 	{
 	public:
 		/// Integer or floating point type for representing the color values
-		using value_type = float;
+		using value_type = value_t;
 
 		/// Tuple type for storing all color channels of a pixel
 		using tuple_type = std::array<value_type, color_channels<color_space>::value>;
@@ -73,6 +77,14 @@ namespace cg
 		tuple_type* data() noexcept { return m_data.data(); }
 		const tuple_type* data() const noexcept { return m_data.data(); }
 
+		/// <summary>
+		/// Get a view of a single channel, which refers to the pixels of this image without copying them
+		/// </summary>
+		/// <param name="c">Channel index</param>
+		/// <returns>Channel view</returns>
+		channel_view<value_type> get_channel_view(unsigned int c);
+		channel_view<const value_type> get_channel_view(unsigned int c) const;
+
 		/// <summary>
 		/// Access pixel
 		/// </summary>
@@ -97,23 +109,29 @@ namespace cg
 		/// Image data
 		data_type m_data;
 	};
+
+	/// <summary>
+	/// Image storing each channel in a plane of its own, defined in PlanarImage.h
+	/// </summary>
+	template <color_space_t color_space, typename value_t>
+	class image<color_space, value_t, layout_t::planar>;
 }
 
-template <cg::color_space_t color_space>
-inline cg::image<color_space>::image(const unsigned int width, const unsigned int height)
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline cg::image<color_space, value_t, layout>::image(const unsigned int width, const unsigned int height)
 	: cg::image_base(width, height)
 {
 	this->m_data.resize(width * height);
 }
 
-template <cg::color_space_t color_space>
-inline cg::image<color_space>::image(const image & other)
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline cg::image<color_space, value_t, layout>::image(const image & other)
 	: cg::image_base(other.width, other.height), m_data(other.m_data)
 {
 }
 
-template <cg::color_space_t color_space>
-inline cg::image<color_space>& cg::image<color_space>::operator=(const image& rhs)
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline cg::image<color_space, value_t, layout>& cg::image<color_space, value_t, layout>::operator=(const image& rhs)
 {
 	if (this != &rhs) {
 		image tmp(rhs);
@@ -125,20 +143,20 @@ inline cg::image<color_space>& cg::image<color_space>::operator=(const image& rh
 	return *this;
 }
 
-template <cg::color_space_t color_space>
-inline cg::color_space_t cg::image<color_space>::get_color_space() const
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline cg::color_space_t cg::image<color_space, value_t, layout>::get_color_space() const
 {
 	return color_space;
 }
 
-template <cg::color_space_t color_space>
-inline void cg::image<color_space>::initialize()
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline void cg::image<color_space, value_t, layout>::initialize()
 {
 	initialize(static_cast<value_type>(0));
 }
 
-template <cg::color_space_t color_space>
-inline void cg::image<color_space>::initialize(const value_type initial_value)
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline void cg::image<color_space, value_t, layout>::initialize(const value_type initial_value)
 {
 	tuple_type tuple;
 
@@ -150,8 +168,8 @@ inline void cg::image<color_space>::initialize(const value_type initial_value)
 	initialize(tuple);
 }
 
-template <cg::color_space_t color_space>
-inline void cg::image<color_space>::initialize(const tuple_type& initial_value)
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline void cg::image<color_space, value_t, layout>::initialize(const tuple_type& initial_value)
 {
 	for (auto& tuple : this->m_data)
 	{
@@ -159,32 +177,56 @@ inline void cg::image<color_space>::initialize(const tuple_type& initial_value)
 	}
 }
 
-template <cg::color_space_t color_space>
-inline const typename cg::image<color_space>::tuple_type& cg::image<color_space>::at(const unsigned int i, const unsigned int j) const
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline const typename cg::image<color_space, value_t, layout>::tuple_type& cg::image<color_space, value_t, layout>::at(const unsigned int i, const unsigned int j) const
 {
 	return this->m_data[index(i, j)];
 }
 
-template <cg::color_space_t color_space>
-inline typename cg::image<color_space>::tuple_type& cg::image<color_space>::at(const unsigned int i, const unsigned int j)
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline typename cg::image<color_space, value_t, layout>::tuple_type& cg::image<color_space, value_t, layout>::at(const unsigned int i, const unsigned int j)
 {
 	return this->m_data[index(i, j)];
 }
 
-template <cg::color_space_t color_space>
-inline const typename cg::image<color_space>::tuple_type& cg::image<color_space>::operator()(const unsigned int i, const unsigned int j) const
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline const typename cg::image<color_space, value_t, layout>::tuple_type& cg::image<color_space, value_t, layout>::operator()(const unsigned int i, const unsigned int j) const
 {
 	return at(i, j);
 }
 
-template <cg::color_space_t color_space>
-inline typename cg::image<color_space>::tuple_type& cg::image<color_space>::operator()(const unsigned int i, const unsigned int j)
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline typename cg::image<color_space, value_t, layout>::tuple_type& cg::image<color_space, value_t, layout>::operator()(const unsigned int i, const unsigned int j)
 {
 	return at(i, j);
 }
 
-template <cg::color_space_t color_space>
-inline unsigned int cg::image<color_space>::index(const unsigned int i, const unsigned int j) const
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline cg::channel_view<value_t> cg::image<color_space, value_t, layout>::get_channel_view(const unsigned int c)
+{
+	if (c >= color_channels<color_space>::value)
+	{
+		throw std::runtime_error("Illegal channel");
+	}
+
+	return channel_view<value_t>(this->m_data.data()->data() + c, this->width, this->height, color_channels<color_space>::value,
+		static_cast<std::size_t>(this->width) * color_channels<color_space>::value);
+}
+
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline cg::channel_view<const value_t> cg::image<color_space, value_t, layout>::get_channel_view(const unsigned int c) const
+{
+	if (c >= color_channels<color_space>::value)
+	{
+		throw std::runtime_error("Illegal channel");
+	}
+
+	return channel_view<const value_t>(this->m_data.data()->data() + c, this->width, this->height, color_channels<color_space>::value,
+		static_cast<std::size_t>(this->width) * color_channels<color_space>::value);
+}
+
+template <cg::color_space_t color_space, typename value_t, cg::layout_t layout>
+inline unsigned int cg::image<color_space, value_t, layout>::index(const unsigned int i, const unsigned int j) const
 {
 	if (i >= this->width || j >= this->height)
 	{
@@ -1,19 +1,58 @@
 #include "ImageConverter.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
-cg::image<cg::color_space_t::HSV> cg::image_converter::rgb_to_hsv(const image<color_space_t::RGB>& original)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CG_CONVERTER_X86
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CG_TARGET(instruction_set)
+#else
+#define CG_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#endif
+
+#define CG_KERNEL(kernel) kernel
+#else
+#define CG_KERNEL(kernel) nullptr
+#endif
+
+namespace
 {
-	// Convert RGB to HSV
-	cg::image<cg::color_space_t::HSV> converted(original.get_width(), original.get_height());
+	/// <summary>
+	/// Kernel converting rows of floats, one row per channel
+	/// </summary>
+	/// <param name="input">Rows of the original channels</param>
+	/// <param name="output">Rows of the converted channels</param>
+	/// <param name="count">Number of values per row, a multiple of vector_size</param>
+	using kernel_t = void (*)(const float* const* input, float* const* output, std::size_t count);
+
+	/// Number of floats in the widest vector, to which the rows are padded
+	const std::size_t vector_size = 8;
+
+	/// Number of pixels below which converting on another thread does not pay off
+	const std::size_t pixels_per_thread = 1 << 16;
+
+	/// Weights of the channels for the grayscale value
+	const float r_weight = 0.2989f;
+	const float g_weight = 0.5870f;
+	const float b_weight = 0.1140f;
 
-	for (unsigned int j = 0; j < original.get_height(); ++j)
+	void rgb_to_hsv_scalar(const float* const* input, float* const* output, const std::size_t count)
 	{
-		for (unsigned int i = 0; i < original.get_width(); ++i)
+		for (std::size_t i = 0; i < count; ++i)
 		{
-			const float r = original(i, j)[0];
-			const float g = original(i, j)[1];
-			const float b = original(i, j)[2];
+			const float r = input[0][i];
+			const float g = input[1][i];
+			const float b = input[2][i];
 
 			const float c_max = std::max(std::max(r, g), b);
 			const float c_min = std::min(std::min(r, g), b);
@@ -41,30 +80,19 @@ cg::image<cg::color_space_t::HSV> cg::image_converter::rgb_to_hsv(const image<co
 				h = ((r - g) / delta + 4.0f) / 6.0f;
 			}
 
-			const float s = (c_max == 0.0f) ? 0.0f : delta / c_max;
-			const float v = c_max;
-
-			converted(i, j)[0] = h;
-			converted(i, j)[1] = s;
-			converted(i, j)[2] = v;
+			output[0][i] = h;
+			output[1][i] = (c_max == 0.0f) ? 0.0f : delta / c_max;
+			output[2][i] = c_max;
 		}
 	}
 
-	return converted;
-}
-
-cg::image<cg::color_space_t::RGB> cg::image_converter::hsv_to_rgb(const image<color_space_t::HSV>& original)
-{
-	// Convert HSV to RGB
-	image<color_space_t::RGB> converted(original.get_width(), original.get_height());
-
-	for (unsigned int j = 0; j < original.get_height(); ++j)
+	void hsv_to_rgb_scalar(const float* const* input, float* const* output, const std::size_t count)
 	{
-		for (unsigned int i = 0; i < original.get_width(); ++i)
+		for (std::size_t i = 0; i < count; ++i)
 		{
-			const float h = original(i, j)[0];
-			const float s = original(i, j)[1];
-			const float v = original(i, j)[2];
+			const float h = input[0][i];
+			const float s = input[1][i];
+			const float v = input[2][i];
 
 			const float h6 = h * 6.0f;
 
@@ -111,51 +139,583 @@ cg::image<cg::color_space_t::RGB> cg::image_converter::hsv_to_rgb(const image<co
 				b = x;
 			}
 
-			r += m;
-			g += m;
-			b += m;
+			output[0][i] = r + m;
+			output[1][i] = g + m;
+			output[2][i] = b + m;
+		}
+	}
 
-			converted(i, j)[0] = r;
-			converted(i, j)[1] = g;
-			converted(i, j)[2] = b;
+	void rgb_to_gray_scalar(const float* const* input, float* const* output, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			output[0][i] = r_weight * input[0][i] + g_weight * input[1][i] + b_weight * input[2][i];
 		}
 	}
 
-	return converted;
-}
+	void gray_to_bw_scalar(const float* const* input, float* const* output, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			output[0][i] = (input[0][i] >= 0.5f) ? 1.0f : 0.0f;
+		}
+	}
 
-cg::image<cg::color_space_t::Gray> cg::image_converter::rgb_to_gray(const image<color_space_t::RGB>& original)
-{
-	// Convert RGB to grayscale
-	image<color_space_t::Gray> converted(original.get_width(), original.get_height());
+#if defined(CG_CONVERTER_X86)
+	// The vectorized kernels compute the same operations in the same order as the scalar ones, and select
+	// the results of the branches with blends. Note that std::max(a, b) corresponds to _mm_max_ps(b, a) for
+	// ties and signed zeros, and that the remainder of the hue is the quotient itself, as |g - b| <= delta.
 
-	const float r_weight = 0.2989f;
-	const float g_weight = 0.5870f;
-	const float b_weight = 0.1140f;
+	CG_TARGET("sse4.1") void rgb_to_hsv_sse4(const float* const* input, float* const* output, const std::size_t count)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 four = _mm_set1_ps(4.0f);
+		const __m128 six = _mm_set1_ps(6.0f);
+
+		for (std::size_t i = 0; i < count; i += 4)
+		{
+			const __m128 r = _mm_load_ps(input[0] + i);
+			const __m128 g = _mm_load_ps(input[1] + i);
+			const __m128 b = _mm_load_ps(input[2] + i);
+
+			const __m128 c_max = _mm_max_ps(b, _mm_max_ps(g, r));
+			const __m128 c_min = _mm_min_ps(b, _mm_min_ps(g, r));
+			const __m128 delta = _mm_sub_ps(c_max, c_min);
+
+			__m128 remainder = _mm_div_ps(_mm_sub_ps(g, b), delta);
+			remainder = _mm_add_ps(remainder, _mm_and_ps(_mm_cmplt_ps(remainder, zero), six));
+
+			const __m128 h_r = _mm_div_ps(remainder, six);
+			const __m128 h_g = _mm_div_ps(_mm_add_ps(_mm_div_ps(_mm_sub_ps(b, r), delta), two), six);
+			const __m128 h_b = _mm_div_ps(_mm_add_ps(_mm_div_ps(_mm_sub_ps(r, g), delta), four), six);
+
+			__m128 h = _mm_blendv_ps(h_b, h_g, _mm_cmpeq_ps(c_max, g));
+			h = _mm_blendv_ps(h, h_r, _mm_cmpeq_ps(c_max, r));
+			h = _mm_andnot_ps(_mm_cmpeq_ps(delta, zero), h);
+
+			_mm_store_ps(output[0] + i, h);
+			_mm_store_ps(output[1] + i, _mm_andnot_ps(_mm_cmpeq_ps(c_max, zero), _mm_div_ps(delta, c_max)));
+			_mm_store_ps(output[2] + i, c_max);
+		}
+	}
+
+	CG_TARGET("sse4.1") void hsv_to_rgb_sse4(const float* const* input, float* const* output, const std::size_t count)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 six = _mm_set1_ps(6.0f);
+		const __m128 sign = _mm_set1_ps(-0.0f);
+
+		for (std::size_t i = 0; i < count; i += 4)
+		{
+			const __m128 h = _mm_load_ps(input[0] + i);
+			const __m128 s = _mm_load_ps(input[1] + i);
+			const __m128 v = _mm_load_ps(input[2] + i);
+
+			const __m128 h6 = _mm_mul_ps(h, six);
+
+			// Remainder of h6 / 2 with the sign of h6, like std::fmod, which is exact
+			const __m128 quotient = _mm_round_ps(_mm_mul_ps(h6, half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			const __m128 remainder = _mm_sub_ps(h6, _mm_mul_ps(quotient, two));
+
+			const __m128 c = _mm_mul_ps(s, v);
+			const __m128 x = _mm_mul_ps(c, _mm_sub_ps(one, _mm_andnot_ps(sign, _mm_sub_ps(remainder, one))));
+			const __m128 m = _mm_sub_ps(v, c);
+
+			// Select the sectors from the last to the first, so that the first matching one wins
+			__m128 r = c;
+			__m128 g = zero;
+			__m128 b = x;
+
+			__m128 mask = _mm_cmplt_ps(h6, _mm_set1_ps(5.0f));
+			r = _mm_blendv_ps(r, x, mask);
+			b = _mm_blendv_ps(b, c, mask);
+
+			mask = _mm_cmplt_ps(h6, _mm_set1_ps(4.0f));
+			r = _mm_blendv_ps(r, zero, mask);
+			g = _mm_blendv_ps(g, x, mask);
+
+			mask = _mm_cmplt_ps(h6, _mm_set1_ps(3.0f));
+			g = _mm_blendv_ps(g, c, mask);
+			b = _mm_blendv_ps(b, x, mask);
+
+			mask = _mm_cmplt_ps(h6, two);
+			r = _mm_blendv_ps(r, x, mask);
+			b = _mm_blendv_ps(b, zero, mask);
+
+			mask = _mm_cmplt_ps(h6, one);
+			r = _mm_blendv_ps(r, c, mask);
+			g = _mm_blendv_ps(g, x, mask);
+
+			_mm_store_ps(output[0] + i, _mm_add_ps(r, m));
+			_mm_store_ps(output[1] + i, _mm_add_ps(g, m));
+			_mm_store_ps(output[2] + i, _mm_add_ps(b, m));
+		}
+	}
 
-	for (unsigned int j = 0; j < original.get_height(); ++j)
+	CG_TARGET("sse4.1") void rgb_to_gray_sse4(const float* const* input, float* const* output, const std::size_t count)
 	{
-		for (unsigned int i = 0; i < original.get_width(); ++i)
+		const __m128 r_weights = _mm_set1_ps(r_weight);
+		const __m128 g_weights = _mm_set1_ps(g_weight);
+		const __m128 b_weights = _mm_set1_ps(b_weight);
+
+		for (std::size_t i = 0; i < count; i += 4)
+		{
+			const __m128 r = _mm_mul_ps(r_weights, _mm_load_ps(input[0] + i));
+			const __m128 g = _mm_mul_ps(g_weights, _mm_load_ps(input[1] + i));
+			const __m128 b = _mm_mul_ps(b_weights, _mm_load_ps(input[2] + i));
+
+			_mm_store_ps(output[0] + i, _mm_add_ps(_mm_add_ps(r, g), b));
+		}
+	}
+
+	CG_TARGET("sse4.1") void gray_to_bw_sse4(const float* const* input, float* const* output, const std::size_t count)
+	{
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		for (std::size_t i = 0; i < count; i += 4)
+		{
+			_mm_store_ps(output[0] + i, _mm_and_ps(_mm_cmpge_ps(_mm_load_ps(input[0] + i), half), one));
+		}
+	}
+
+	CG_TARGET("avx2") void rgb_to_hsv_avx2(const float* const* input, float* const* output, const std::size_t count)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 two = _mm256_set1_ps(2.0f);
+		const __m256 four = _mm256_set1_ps(4.0f);
+		const __m256 six = _mm256_set1_ps(6.0f);
+
+		for (std::size_t i = 0; i < count; i += 8)
+		{
+			const __m256 r = _mm256_load_ps(input[0] + i);
+			const __m256 g = _mm256_load_ps(input[1] + i);
+			const __m256 b = _mm256_load_ps(input[2] + i);
+
+			const __m256 c_max = _mm256_max_ps(b, _mm256_max_ps(g, r));
+			const __m256 c_min = _mm256_min_ps(b, _mm256_min_ps(g, r));
+			const __m256 delta = _mm256_sub_ps(c_max, c_min);
+
+			__m256 remainder = _mm256_div_ps(_mm256_sub_ps(g, b), delta);
+			remainder = _mm256_add_ps(remainder, _mm256_and_ps(_mm256_cmp_ps(remainder, zero, _CMP_LT_OQ), six));
+
+			const __m256 h_r = _mm256_div_ps(remainder, six);
+			const __m256 h_g = _mm256_div_ps(_mm256_add_ps(_mm256_div_ps(_mm256_sub_ps(b, r), delta), two), six);
+			const __m256 h_b = _mm256_div_ps(_mm256_add_ps(_mm256_div_ps(_mm256_sub_ps(r, g), delta), four), six);
+
+			__m256 h = _mm256_blendv_ps(h_b, h_g, _mm256_cmp_ps(c_max, g, _CMP_EQ_OQ));
+			h = _mm256_blendv_ps(h, h_r, _mm256_cmp_ps(c_max, r, _CMP_EQ_OQ));
+			h = _mm256_andnot_ps(_mm256_cmp_ps(delta, zero, _CMP_EQ_OQ), h);
+
+			_mm256_store_ps(output[0] + i, h);
+			_mm256_store_ps(output[1] + i, _mm256_andnot_ps(_mm256_cmp_ps(c_max, zero, _CMP_EQ_OQ), _mm256_div_ps(delta, c_max)));
+			_mm256_store_ps(output[2] + i, c_max);
+		}
+	}
+
+	CG_TARGET("avx2") void hsv_to_rgb_avx2(const float* const* input, float* const* output, const std::size_t count)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 two = _mm256_set1_ps(2.0f);
+		const __m256 six = _mm256_set1_ps(6.0f);
+		const __m256 sign = _mm256_set1_ps(-0.0f);
+
+		for (std::size_t i = 0; i < count; i += 8)
+		{
+			const __m256 h = _mm256_load_ps(input[0] + i);
+			const __m256 s = _mm256_load_ps(input[1] + i);
+			const __m256 v = _mm256_load_ps(input[2] + i);
+
+			const __m256 h6 = _mm256_mul_ps(h, six);
+
+			const __m256 quotient = _mm256_round_ps(_mm256_mul_ps(h6, half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			const __m256 remainder = _mm256_sub_ps(h6, _mm256_mul_ps(quotient, two));
+
+			const __m256 c = _mm256_mul_ps(s, v);
+			const __m256 x = _mm256_mul_ps(c, _mm256_sub_ps(one, _mm256_andnot_ps(sign, _mm256_sub_ps(remainder, one))));
+			const __m256 m = _mm256_sub_ps(v, c);
+
+			__m256 r = c;
+			__m256 g = zero;
+			__m256 b = x;
+
+			__m256 mask = _mm256_cmp_ps(h6, _mm256_set1_ps(5.0f), _CMP_LT_OQ);
+			r = _mm256_blendv_ps(r, x, mask);
+			b = _mm256_blendv_ps(b, c, mask);
+
+			mask = _mm256_cmp_ps(h6, _mm256_set1_ps(4.0f), _CMP_LT_OQ);
+			r = _mm256_blendv_ps(r, zero, mask);
+			g = _mm256_blendv_ps(g, x, mask);
+
+			mask = _mm256_cmp_ps(h6, _mm256_set1_ps(3.0f), _CMP_LT_OQ);
+			g = _mm256_blendv_ps(g, c, mask);
+			b = _mm256_blendv_ps(b, x, mask);
+
+			mask = _mm256_cmp_ps(h6, two, _CMP_LT_OQ);
+			r = _mm256_blendv_ps(r, x, mask);
+			b = _mm256_blendv_ps(b, zero, mask);
+
+			mask = _mm256_cmp_ps(h6, one, _CMP_LT_OQ);
+			r = _mm256_blendv_ps(r, c, mask);
+			g = _mm256_blendv_ps(g, x, mask);
+
+			_mm256_store_ps(output[0] + i, _mm256_add_ps(r, m));
+			_mm256_store_ps(output[1] + i, _mm256_add_ps(g, m));
+			_mm256_store_ps(output[2] + i, _mm256_add_ps(b, m));
+		}
+	}
+
+	CG_TARGET("avx2") void rgb_to_gray_avx2(const float* const* input, float* const* output, const std::size_t count)
+	{
+		const __m256 r_weights = _mm256_set1_ps(r_weight);
+		const __m256 g_weights = _mm256_set1_ps(g_weight);
+		const __m256 b_weights = _mm256_set1_ps(b_weight);
+
+		for (std::size_t i = 0; i < count; i += 8)
+		{
+			const __m256 r = _mm256_mul_ps(r_weights, _mm256_load_ps(input[0] + i));
+			const __m256 g = _mm256_mul_ps(g_weights, _mm256_load_ps(input[1] + i));
+			const __m256 b = _mm256_mul_ps(b_weights, _mm256_load_ps(input[2] + i));
+
+			_mm256_store_ps(output[0] + i, _mm256_add_ps(_mm256_add_ps(r, g), b));
+		}
+	}
+
+	CG_TARGET("avx2") void gray_to_bw_avx2(const float* const* input, float* const* output, const std::size_t count)
+	{
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 one = _mm256_set1_ps(1.0f);
+
+		for (std::size_t i = 0; i < count; i += 8)
 		{
-			converted(i, j)[0] = r_weight * original(i, j)[0] + g_weight * original(i, j)[1] + b_weight * original(i, j)[2];
+			_mm256_store_ps(output[0] + i, _mm256_and_ps(_mm256_cmp_ps(_mm256_load_ps(input[0] + i), half, _CMP_GE_OQ), one));
 		}
 	}
+#endif
+
+	/// <summary>
+	/// Detect the fastest instruction set supported by the processor and the operating system
+	/// </summary>
+	/// <returns>Instruction set</returns>
+	cg::instruction_set_t detect_instruction_set()
+	{
+#if defined(CG_CONVERTER_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int max_leaf = info[0];
+
+		__cpuid(info, 1);
+		const bool sse4 = (info[2] & (1 << 19)) != 0;
+		const bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+
+		bool avx2 = false;
+
+		if (max_leaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = avx && (info[1] & (1 << 5)) != 0;
+		}
+#elif defined(CG_CONVERTER_X86)
+		__builtin_cpu_init();
+
+		const bool sse4 = __builtin_cpu_supports("sse4.1") != 0;
+		const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#else
+		const bool sse4 = false;
+		const bool avx2 = false;
+#endif
 
-	return converted;
+		return avx2 ? cg::instruction_set_t::avx2 : (sse4 ? cg::instruction_set_t::sse4 : cg::instruction_set_t::scalar);
+	}
+
+	/// <summary>
+	/// Get the instruction set used by the conversions
+	/// </summary>
+	/// <returns>Instruction set, which may be changed</returns>
+	std::atomic<cg::instruction_set_t>& selected_instruction_set()
+	{
+		static std::atomic<cg::instruction_set_t> instruction_set(cg::image_converter::get_supported_instruction_set());
+
+		return instruction_set;
+	}
+
+	/// <summary>
+	/// Select the kernel for the instruction set used
+	/// </summary>
+	/// <param name="scalar">Scalar kernel</param>
+	/// <param name="sse4">SSE4 kernel</param>
+	/// <param name="avx2">AVX2 kernel</param>
+	/// <returns>Kernel</returns>
+	kernel_t select_kernel(const kernel_t scalar, const kernel_t sse4, const kernel_t avx2)
+	{
+		switch (selected_instruction_set().load())
+		{
+		case cg::instruction_set_t::avx2:
+			return avx2;
+		case cg::instruction_set_t::sse4:
+			return sse4;
+		default:
+			return scalar;
+		}
+	}
+
+	/// <summary>
+	/// Call a function for bands of rows on all hardware threads, or on the calling thread for small images
+	/// </summary>
+	/// <param name="width">Image width</param>
+	/// <param name="height">Image height</param>
+	/// <param name="function">Function taking the first row and the row after the last one of a band</param>
+	template <typename function_t>
+	void for_each_band(const unsigned int width, const unsigned int height, const function_t& function)
+	{
+		const auto pixels = static_cast<std::size_t>(width) * height;
+
+		auto threads = static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+		threads = std::min(std::min(threads, pixels / pixels_per_thread), static_cast<std::size_t>(height));
+
+		if (threads <= 1)
+		{
+			function(0u, height);
+			return;
+		}
+
+		// Exceptions are passed on to the calling thread after all threads have finished
+		std::vector<std::exception_ptr> errors(threads);
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+
+		const auto band = [&](const std::size_t t)
+		{
+			try
+			{
+				function(static_cast<unsigned int>(height * t / threads), static_cast<unsigned int>(height * (t + 1) / threads));
+			}
+			catch (...)
+			{
+				errors[t] = std::current_exception();
+			}
+		};
+
+		for (std::size_t t = 1; t < threads; ++t)
+		{
+			workers.emplace_back(band, t);
+		}
+
+		band(0);
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+
+		for (const auto& error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Convert an image row by row, converting the values of each row to rows of floats for the kernel
+	/// </summary>
+	/// <param name="original">Original image</param>
+	/// <param name="kernel">Kernel</param>
+	/// <returns>Converted image</returns>
+	template <cg::color_space_t target, cg::color_space_t source, typename value_t>
+	cg::image<target, value_t> convert_rows(const cg::image<source, value_t>& original, const kernel_t kernel)
+	{
+		using traits = cg::value_traits<value_t>;
+
+		const auto input_channels = cg::color_channels<source>::value;
+		const auto output_channels = cg::color_channels<target>::value;
+
+		const auto width = original.get_width();
+		const auto stride = (static_cast<std::size_t>(width) + vector_size - 1) / vector_size * vector_size;
+
+		cg::image<target, value_t> converted(width, original.get_height());
+
+		for_each_band(width, original.get_height(), [&](const unsigned int first, const unsigned int last)
+		{
+			// Aligned rows, whose padding stays zero
+			std::vector<float, cg::aligned_allocator<float, 64>> rows((input_channels + output_channels) * stride);
+
+			float* input[input_channels];
+			float* output[output_channels];
+
+			for (unsigned int c = 0; c < input_channels; ++c)
+			{
+				input[c] = rows.data() + c * stride;
+			}
+
+			for (unsigned int c = 0; c < output_channels; ++c)
+			{
+				output[c] = rows.data() + (input_channels + c) * stride;
+			}
+
+			for (unsigned int j = first; j < last; ++j)
+			{
+				const auto* source_row = original.data() + static_cast<std::size_t>(width) * j;
+				auto* target_row = converted.data() + static_cast<std::size_t>(width) * j;
+
+				for (unsigned int i = 0; i < width; ++i)
+				{
+					for (unsigned int c = 0; c < input_channels; ++c)
+					{
+						input[c][i] = traits::to_float(source_row[i][c]);
+					}
+				}
+
+				kernel(input, output, stride);
+
+				for (unsigned int i = 0; i < width; ++i)
+				{
+					for (unsigned int c = 0; c < output_channels; ++c)
+					{
+						target_row[i][c] = traits::from_float(output[c][i]);
+					}
+				}
+			}
+		});
+
+		return converted;
+	}
+
+	static_assert(cg::planar_image<>::alignment % (vector_size * sizeof(float)) == 0, "Plane rows must be padded to whole vectors");
+
+	/// <summary>
+	/// Convert a planar float image row by row, passing the rows of the planes to the kernel; as the kernels
+	/// map zero to zero, the padding of the converted rows stays zero
+	/// </summary>
+	/// <param name="original">Original image</param>
+	/// <param name="kernel">Kernel</param>
+	/// <returns>Converted image</returns>
+	template <cg::color_space_t target, cg::color_space_t source>
+	cg::planar_image<target> convert_planes(const cg::planar_image<source>& original, const kernel_t kernel)
+	{
+		const auto input_channels = cg::color_channels<source>::value;
+		const auto output_channels = cg::color_channels<target>::value;
+
+		cg::planar_image<target> converted(original.get_width(), original.get_height());
+
+		for_each_band(original.get_width(), original.get_height(), [&](const unsigned int first, const unsigned int last)
+		{
+			const float* input[input_channels];
+			float* output[output_channels];
+
+			for (unsigned int j = first; j < last; ++j)
+			{
+				for (unsigned int c = 0; c < input_channels; ++c)
+				{
+					input[c] = original.row(c, j);
+				}
+
+				for (unsigned int c = 0; c < output_channels; ++c)
+				{
+					output[c] = converted.row(c, j);
+				}
+
+				kernel(input, output, original.get_stride());
+			}
+		});
+
+		return converted;
+	}
+}
+
+template <typename value_t>
+cg::image<cg::color_space_t::HSV, value_t> cg::image_converter::rgb_to_hsv(const image<color_space_t::RGB, value_t>& original)
+{
+	// Convert RGB to HSV
+	return convert_rows<color_space_t::HSV>(original, select_kernel(rgb_to_hsv_scalar, CG_KERNEL(rgb_to_hsv_sse4), CG_KERNEL(rgb_to_hsv_avx2)));
+}
+
+template <typename value_t>
+cg::image<cg::color_space_t::RGB, value_t> cg::image_converter::hsv_to_rgb(const image<color_space_t::HSV, value_t>& original)
+{
+	// Convert HSV to RGB
+	return convert_rows<color_space_t::RGB>(original, select_kernel(hsv_to_rgb_scalar, CG_KERNEL(hsv_to_rgb_sse4), CG_KERNEL(hsv_to_rgb_avx2)));
 }
 
-cg::image<cg::color_space_t::BW> cg::image_converter::gray_to_bw(const image<color_space_t::Gray>& original)
+template <typename value_t>
+cg::image<cg::color_space_t::Gray, value_t> cg::image_converter::rgb_to_gray(const image<color_space_t::RGB, value_t>& original)
+{
+	// Convert RGB to grayscale
+	return convert_rows<color_space_t::Gray>(original, select_kernel(rgb_to_gray_scalar, CG_KERNEL(rgb_to_gray_sse4), CG_KERNEL(rgb_to_gray_avx2)));
+}
+
+template <typename value_t>
+cg::image<cg::color_space_t::BW, value_t> cg::image_converter::gray_to_bw(const image<color_space_t::Gray, value_t>& original)
 {
 	// Convert grayscale to black and white
-	image<color_space_t::BW> converted(original.get_width(), original.get_height());
+	return convert_rows<color_space_t::BW>(original, select_kernel(gray_to_bw_scalar, CG_KERNEL(gray_to_bw_sse4), CG_KERNEL(gray_to_bw_avx2)));
+}
 
-	for (unsigned int j = 0; j < original.get_height(); ++j)
+cg::planar_image<cg::color_space_t::HSV> cg::image_converter::rgb_to_hsv(const planar_image<color_space_t::RGB>& original)
+{
+	return convert_planes<color_space_t::HSV>(original, select_kernel(rgb_to_hsv_scalar, CG_KERNEL(rgb_to_hsv_sse4), CG_KERNEL(rgb_to_hsv_avx2)));
+}
+
+cg::planar_image<cg::color_space_t::RGB> cg::image_converter::hsv_to_rgb(const planar_image<color_space_t::HSV>& original)
+{
+	return convert_planes<color_space_t::RGB>(original, select_kernel(hsv_to_rgb_scalar, CG_KERNEL(hsv_to_rgb_sse4), CG_KERNEL(hsv_to_rgb_avx2)));
+}
+
+cg::planar_image<cg::color_space_t::Gray> cg::image_converter::rgb_to_gray(const planar_image<color_space_t::RGB>& original)
+{
+	return convert_planes<color_space_t::Gray>(original, select_kernel(rgb_to_gray_scalar, CG_KERNEL(rgb_to_gray_sse4), CG_KERNEL(rgb_to_gray_avx2)));
+}
+
+cg::planar_image<cg::color_space_t::BW> cg::image_converter::gray_to_bw(const planar_image<color_space_t::Gray>& original)
+{
+	return convert_planes<color_space_t::BW>(original, select_kernel(gray_to_bw_scalar, CG_KERNEL(gray_to_bw_sse4), CG_KERNEL(gray_to_bw_avx2)));
+}
+
+cg::instruction_set_t cg::image_converter::get_supported_instruction_set()
+{
+	static const auto instruction_set = detect_instruction_set();
+
+	return instruction_set;
+}
+
+cg::instruction_set_t cg::image_converter::get_instruction_set()
+{
+	return selected_instruction_set().load();
+}
+
+void cg::image_converter::set_instruction_set(const instruction_set_t instruction_set)
+{
+	if (instruction_set > get_supported_instruction_set())
 	{
-		for (unsigned int i = 0; i < original.get_width(); ++i)
-		{
-			converted(i, j)[0] = (original(i, j)[0] >= 0.5f) ? 1.0f : 0.0f;
-		}
+		throw std::runtime_error("Instruction set not supported");
 	}
 
-	return converted;
-}
\ No newline at end of file
+	selected_instruction_set().store(instruction_set);
+}
+
+template cg::image<cg::color_space_t::HSV, float> cg::image_converter::rgb_to_hsv(const image<color_space_t::RGB, float>&);
+template cg::image<cg::color_space_t::HSV, cg::half> cg::image_converter::rgb_to_hsv(const image<color_space_t::RGB, half>&);
+template cg::image<cg::color_space_t::HSV, std::uint8_t> cg::image_converter::rgb_to_hsv(const image<color_space_t::RGB, std::uint8_t>&);
+template cg::image<cg::color_space_t::HSV, std::uint16_t> cg::image_converter::rgb_to_hsv(const image<color_space_t::RGB, std::uint16_t>&);
+
+template cg::image<cg::color_space_t::RGB, float> cg::image_converter::hsv_to_rgb(const image<color_space_t::HSV, float>&);
+template cg::image<cg::color_space_t::RGB, cg::half> cg::image_converter::hsv_to_rgb(const image<color_space_t::HSV, half>&);
+template cg::image<cg::color_space_t::RGB, std::uint8_t> cg::image_converter::hsv_to_rgb(const image<color_space_t::HSV, std::uint8_t>&);
+template cg::image<cg::color_space_t::RGB, std::uint16_t> cg::image_converter::hsv_to_rgb(const image<color_space_t::HSV, std::uint16_t>&);
+
+template cg::image<cg::color_space_t::Gray, float> cg::image_converter::rgb_to_gray(const image<color_space_t::RGB, float>&);
+template cg::image<cg::color_space_t::Gray, cg::half> cg::image_converter::rgb_to_gray(const image<color_space_t::RGB, half>&);
+template cg::image<cg::color_space_t::Gray, std::uint8_t> cg::image_converter::rgb_to_gray(const image<color_space_t::RGB, std::uint8_t>&);
+template cg::image<cg::color_space_t::Gray, std::uint16_t> cg::image_converter::rgb_to_gray(const image<color_space_t::RGB, std::uint16_t>&);
+
+template cg::image<cg::color_space_t::BW, float> cg::image_converter::gray_to_bw(const image<color_space_t::Gray, float>&);
+template cg::image<cg::color_space_t::BW, cg::half> cg::image_converter::gray_to_bw(const image<color_space_t::Gray, half>&);
+template cg::image<cg::color_space_t::BW, std::uint8_t> cg::image_converter::gray_to_bw(const image<color_space_t::Gray, std::uint8_t>&);
+template cg::image<cg::color_space_t::BW, std::uint16_t> cg::image_converter::gray_to_bw(const image<color_space_t::Gray, std::uint16_t>&);
\ No newline at end of file
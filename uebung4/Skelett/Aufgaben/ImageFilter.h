@@ -2,6 +2,7 @@
 #define ImageFilter_hpp
 
 #include <algorithm>
+#include <array>
 #include <utility>
 
 #include "Image.h"
@@ -25,9 +26,9 @@ namespace cg
 			 * @param offset Offset values that are applied to the input coordinates.
 			 * @param border_policy Policy for handling out of bounds coordinates.
 			 */
-			template <cg::color_space_t color_space>
+			template <cg::color_space_t color_space, typename value_t>
 			std::pair<unsigned int, unsigned int> offsetImageCoordinates(
-				image<color_space> const& image,
+				image<color_space, value_t> const& image,
 				std::pair<unsigned int, unsigned int> coordinates,
 				std::pair<int, int> offset,
 				BorderPolicy border_policy)
@@ -140,32 +141,41 @@ namespace cg
 		/** Create a simple 3x3 edge detection filter kernel. */
 		Kernel buildEdgeDetectionKernel();
 
-		/** Apply a filter kernel to an image. */
-		template <color_space_t color_space>
-		image<color_space> filterImage(image<color_space> const& original, Kernel const& filter_kernel, BorderPolicy border_policy = CLAMP_TO_EDGE);
+		/**
+		 * Apply a filter kernel to an image.
+		 * Images of any storage type are filtered with floats, see value_traits.
+		 */
+		template <color_space_t color_space, typename value_t>
+		image<color_space, value_t> filterImage(image<color_space, value_t> const& original, Kernel const& filter_kernel, BorderPolicy border_policy = CLAMP_TO_EDGE);
 	}
 }
 
-template <cg::color_space_t color_space>
-cg::image<color_space> cg::filter::filterImage(image<color_space> const& original, Kernel const& filter_kernel, BorderPolicy border_policy)
+template <cg::color_space_t color_space, typename value_t>
+cg::image<color_space, value_t> cg::filter::filterImage(image<color_space, value_t> const& original, Kernel const& filter_kernel, BorderPolicy border_policy)
 {
-	cg::image<color_space> filtered(original.get_width(), original.get_height());
+	using traits = value_traits<value_t>;
+
+	cg::image<color_space, value_t> filtered(original.get_width(), original.get_height());
 
 	for (unsigned int j = 0; j < original.get_height(); ++j)
 	{
 		for (unsigned int i = 0; i < original.get_width(); ++i)
 		{
-			cg::image<color_space>::tuple_type pixel_value;
+			std::array<float, color_channels<color_space>::value> pixel_value;
 			for (auto& channel : pixel_value)
 				channel = 0;
 
 			///////
 			// TODO
 			// Implement image filtering using the given filter kernel.
-			// Use "pixel_value" as intermediate storage for the computation and store the final result in "filtered".
+			// Use "pixel_value" as intermediate storage for the computation, whose final result is stored in "filtered" below.
 			// Iterate over the kernel and use the function "offsetImageCoordinates" to get valid image coordinates for
-			// accessing the original image data.
-			
+			// accessing the original image data, and "traits::to_float" to convert its values to floats.
+
+			for (unsigned int c = 0; c < pixel_value.size(); ++c)
+			{
+				filtered(i, j)[c] = traits::from_float(pixel_value[c]);
+			}
 		}
 	}
 
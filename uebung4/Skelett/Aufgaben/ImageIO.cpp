@@ -1,10 +1,16 @@
 #include "ImageIO.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 namespace
 {
@@ -24,119 +30,195 @@ namespace
 		unsigned int max_value;
 	};
 
-	unsigned int read_value(std::ifstream& stream)
+	/// <summary>
+	/// Test whether a character separates values in a Netpbm header
+	/// </summary>
+	/// <param name="character">Character</param>
+	/// <returns>True for whitespace</returns>
+	bool is_whitespace(const unsigned char character)
 	{
-		std::vector<char> buffer;
-		char next_char;
-
-		enum state_t
-		{
-			READY,		// Ready to read in the value
-			COMMENT,	// Inside a comment
-			READING,	// Currently reading (part of) the value
-			FINISHED	// Finished reading the value
-		} state = READY;
+		return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\v' || character == '\f';
+	}
 
-		while (state != FINISHED)
+	/// <summary>
+	/// Skip whitespace and comments, which extend to the end of the line
+	/// </summary>
+	/// <param name="position">Current position, moved to the next value</param>
+	/// <param name="end">End of the file</param>
+	void skip_whitespace(const unsigned char*& position, const unsigned char* end)
+	{
+		while (position != end && (is_whitespace(*position) || *position == '#'))
 		{
-			stream.read(&next_char, 1);
-
-			switch (state)
+			if (*position == '#')
 			{
-			case READY:
-				if (next_char == '#')
-				{
-					state = COMMENT;
-				}
-				else if (next_char != '\n' && next_char != '\r' && next_char != '\t' && next_char != ' ')
+				while (position != end && *position != '\n' && *position != '\r')
 				{
-					state = READING;
-					buffer.push_back(next_char);
+					++position;
 				}
+			}
+			else
+			{
+				++position;
+			}
+		}
+	}
 
-				break;
-			case COMMENT:
-				if (next_char == '\n' || next_char == '\r')
-				{
-					state = READY;
-				}
+	/// <summary>
+	/// Parse a decimal value of the header or of a plain image
+	/// </summary>
+	/// <param name="position">Current position, moved behind the value</param>
+	/// <param name="end">End of the file</param>
+	/// <returns>Value</returns>
+	unsigned int read_value(const unsigned char*& position, const unsigned char* end)
+	{
+		skip_whitespace(position, end);
 
-				break;
-			case READING:
-				if (next_char != '\n' && next_char != '\r' && next_char != '\t' && next_char != ' ')
-				{
-					buffer.push_back(next_char);
-				}
-				else
-				{
-					state = FINISHED;
-				}
+		if (position == end || *position < '0' || *position > '9')
+		{
+			throw std::runtime_error("Invalid value");
+		}
+
+		unsigned long long value = 0;
+
+		while (position != end && *position >= '0' && *position <= '9')
+		{
+			value = 10 * value + (*position++ - '0');
+
+			if (value > std::numeric_limits<unsigned int>::max())
+			{
+				throw std::runtime_error("Invalid value");
 			}
 		}
 
-		std::string buffer_string(buffer.begin(), buffer.end());
-		return static_cast<unsigned int>(std::stoul(buffer_string));
+		return static_cast<unsigned int>(value);
+	}
+
+	/// <summary>
+	/// Parse a pixel of a plain PBM image, which is a single digit that need not be separated from the next one
+	/// </summary>
+	/// <param name="position">Current position, moved behind the pixel</param>
+	/// <param name="end">End of the file</param>
+	/// <returns>Pixel value</returns>
+	unsigned int read_bit(const unsigned char*& position, const unsigned char* end)
+	{
+		skip_whitespace(position, end);
+
+		if (position == end || (*position != '0' && *position != '1'))
+		{
+			throw std::runtime_error("Invalid value");
+		}
+
+		return static_cast<unsigned int>(*position++ - '0');
 	}
 
-	header load_header(std::ifstream& stream)
+	header load_header(const unsigned char*& position, const unsigned char* end)
 	{
 		header file_header;
 
 		// Read magic number
-		std::array<char, 2> magic_number;
-		stream.read(magic_number.data(), magic_number.size());
+		if (end - position >= 2 && position[0] == 'P' && position[1] >= '1' && position[1] <= '6')
+		{
+			const header::file_t file_types[] = { header::PLAIN_PBM, header::PLAIN_PGM, header::PLAIN_PPM, header::PBM, header::PGM, header::PPM };
 
-		if (magic_number[0] == 'P')
+			file_header.file_type = file_types[position[1] - '1'];
+			position += 2;
+		}
+		else
 		{
-			if (magic_number[1] == '1')
-			{
-				file_header.file_type = header::file_t::PLAIN_PBM;
-			}
-			else if (magic_number[1] == '2')
-			{
-				file_header.file_type = header::file_t::PLAIN_PGM;
-			}
-			else if (magic_number[1] == '3')
-			{
-				file_header.file_type = header::file_t::PLAIN_PPM;
-			}
-			else if (magic_number[1] == '4')
-			{
-				file_header.file_type = header::file_t::PBM;
-			}
-			else if (magic_number[1] == '5')
-			{
-				file_header.file_type = header::file_t::PGM;
-			}
-			else if (magic_number[1] == '6')
-			{
-				file_header.file_type = header::file_t::PPM;
-			}
-			else
+			throw std::runtime_error("Invalid file format");
+		}
+
+		// Read extents (width, height, max. value)
+		file_header.width = read_value(position, end);
+		file_header.height = read_value(position, end);
+		file_header.max_value = 1;
+
+		if (file_header.file_type != header::PLAIN_PBM && file_header.file_type != header::PBM)
+		{
+			file_header.max_value = read_value(position, end);
+
+			if (file_header.max_value == 0 || file_header.max_value > 65535)
 			{
-				file_header.file_type = header::file_t::INVALID;
+				throw std::runtime_error("Invalid maximum value");
 			}
 		}
-		else
+
+		// The pixels of binary images follow a single whitespace character
+		if (file_header.file_type == header::PBM || file_header.file_type == header::PGM || file_header.file_type == header::PPM)
 		{
-			file_header.file_type = header::file_t::INVALID;
+			if (position == end || !is_whitespace(*position))
+			{
+				throw std::runtime_error("Invalid header");
+			}
+
+			++position;
 		}
 
-		if (file_header.file_type == header::file_t::INVALID)
+		return file_header;
+	}
+
+	/// <summary>
+	/// Map an image file into memory and read its header
+	/// </summary>
+	/// <param name="path">Path to image file</param>
+	/// <param name="file_header">Header</param>
+	/// <param name="position">Position of the first pixel</param>
+	/// <returns>Mapped file</returns>
+	std::shared_ptr<const cg::mapped_file> open_image(const std::string& path, header& file_header, const unsigned char*& position)
+	{
+		auto file = std::make_shared<const cg::mapped_file>(path);
+
+		position = file->data();
+		file_header = load_header(position, file->data() + file->size());
+
+		return file;
+	}
+
+	/// <summary>
+	/// Locate the pixels of a binary image in its mapped file
+	/// </summary>
+	/// <param name="file">Mapped file</param>
+	/// <param name="file_header">Header</param>
+	/// <param name="position">Position of the first pixel</param>
+	/// <returns>Mapped image</returns>
+	cg::image_io::mapped_image map_pixels(const std::shared_ptr<const cg::mapped_file>& file, const header& file_header, const unsigned char* position)
+	{
+		cg::image_io::mapped_image image;
+		image.file = file;
+		image.width = file_header.width;
+		image.height = file_header.height;
+		image.max_value = file_header.max_value;
+		image.pixels = position;
+
+		const std::size_t bytes = (file_header.max_value >= 256) ? 2 : 1;
+
+		switch (file_header.file_type)
 		{
-			throw std::runtime_error("Invalid file format");
-		}
+		case header::PBM:
+			image.color_space = cg::color_space_t::BW;
+			image.row_size = (static_cast<std::size_t>(file_header.width) + 7) / 8;
 
-		// Read extents (width, height, max. value)
-		file_header.width = read_value(stream);
-		file_header.height = read_value(stream);
+			break;
+		case header::PGM:
+			image.color_space = cg::color_space_t::Gray;
+			image.row_size = static_cast<std::size_t>(file_header.width) * bytes;
+
+			break;
+		case header::PPM:
+			image.color_space = cg::color_space_t::RGB;
+			image.row_size = 3 * static_cast<std::size_t>(file_header.width) * bytes;
+
+			break;
+		default:
+			throw std::runtime_error("Only binary images (P4, P5, P6) can be mapped");
+		}
 
-		if (file_header.file_type == header::file_t::PGM || file_header.file_type == header::file_t::PPM)
+		if (image.row_size * file_header.height > static_cast<std::size_t>(file->data() + file->size() - position))
 		{
-			file_header.max_value = read_value(stream);
+			throw std::runtime_error("Unexpected end of file");
 		}
 
-		return file_header;
+		return image;
 	}
 
 	void save_header(std::ofstream& stream, const header& file_header)
@@ -175,274 +257,356 @@ namespace
 		// Save extents
 		stream << file_header.width << " " << file_header.height << "\n";
 
-		if (file_header.file_type == header::file_t::PGM || file_header.file_type == header::file_t::PPM)
+		if (file_header.file_type != header::file_t::PLAIN_PBM && file_header.file_type != header::file_t::PBM)
 		{
 			stream << file_header.max_value << std::endl;
 		}
 	}
 
-	cg::image<cg::color_space_t::BW> load_plain_pbm(std::ifstream& stream, const header& header)
+	/// <summary>
+	/// Conversion between the samples of a file, i.e., integers in [0, max_value], and color values
+	/// </summary>
+	/// <tparam name="value_t">Storage type of the color values</tparam>
+	template <typename value_t, bool is_integer = std::is_integral<value_t>::value>
+	struct sample_converter
 	{
-		// Create image
-		cg::image<cg::color_space_t::BW> image(header.width, header.height);
+		explicit sample_converter(const unsigned int max_value) : max_value(static_cast<float>(max_value)) { }
 
-		std::size_t index = 0;
+		value_t from_sample(const unsigned int sample) const
+		{
+			return static_cast<value_t>(static_cast<float>(sample) / this->max_value);
+		}
 
-		for (unsigned int j = 0; j < header.height; ++j)
+		unsigned int to_sample(const value_t value) const
 		{
-			for (unsigned int i = 0; i < header.width; ++i)
-			{
-				image(i, j)[0] = (read_value(stream) != 0) ? 1.0f : 0.0f;
-			}
+			return static_cast<unsigned int>(static_cast<float>(value) * this->max_value);
 		}
 
-		return image;
-	}
+		float max_value;
+	};
 
-	cg::image<cg::color_space_t::Gray> load_plain_pgm(std::ifstream& stream, const header& header)
+	/// <summary>
+	/// Conversion between the samples of a file and integer color values, which are copied if the file has the
+	/// same depth and rescaled with rounding otherwise
+	/// </summary>
+	/// <tparam name="value_t">Storage type of the color values</tparam>
+	template <typename value_t>
+	struct sample_converter<value_t, true>
 	{
-		// Create image
-		cg::image<cg::color_space_t::Gray> image(header.width, header.height);
+		explicit sample_converter(const unsigned int max_value) : max_value(max_value), native(max_value == cg::value_traits<value_t>::max_value) { }
 
-		std::size_t index = 0;
+		value_t from_sample(const unsigned int sample) const
+		{
+			return this->native ? static_cast<value_t>(sample)
+				: static_cast<value_t>((static_cast<unsigned long long>(sample) * cg::value_traits<value_t>::max_value + this->max_value / 2) / this->max_value);
+		}
 
-		for (unsigned int j = 0; j < header.height; ++j)
+		unsigned int to_sample(const value_t value) const
 		{
-			for (unsigned int i = 0; i < header.width; ++i)
-			{
-				image(i, j)[0] = static_cast<float>(read_value(stream)) / static_cast<float>(header.max_value);
-			}
+			return this->native ? static_cast<unsigned int>(value)
+				: static_cast<unsigned int>((static_cast<unsigned long long>(value) * this->max_value + cg::value_traits<value_t>::max_value / 2) / cg::value_traits<value_t>::max_value);
 		}
 
-		return image;
-	}
+		unsigned int max_value;
+		bool native;
+	};
 
-	cg::image<cg::color_space_t::RGB> load_plain_ppm(std::ifstream& stream, const header& header)
+	/// <summary>
+	/// Parse the pixels of a plain PBM image
+	/// </summary>
+	/// <param name="position">Current position, moved behind the pixels</param>
+	/// <param name="end">End of the file</param>
+	/// <param name="pixels">Number of pixels</param>
+	/// <param name="target">Channel values of the image</param>
+	template <typename value_t>
+	void read_plain_bits(const unsigned char*& position, const unsigned char* end, const std::size_t pixels, value_t* target)
 	{
-		// Create image
-		cg::image<cg::color_space_t::RGB> image(header.width, header.height);
+		const auto one = sample_converter<value_t>(1).from_sample(1);
 
-		std::size_t index = 0;
+		for (std::size_t p = 0; p < pixels; ++p)
+		{
+			target[p] = (read_bit(position, end) != 0) ? one : value_t();
+		}
+	}
+
+	/// <summary>
+	/// Parse the pixels of a plain PGM or PPM image, padding each pixel with ones
+	/// </summary>
+	/// <param name="position">Current position, moved behind the pixels</param>
+	/// <param name="end">End of the file</param>
+	/// <param name="pixels">Number of pixels</param>
+	/// <param name="max_value">Maximum value</param>
+	/// <param name="target">Channel values of the image</param>
+	template <unsigned int channels, unsigned int image_channels, typename value_t>
+	void read_plain_values(const unsigned char*& position, const unsigned char* end, const std::size_t pixels, const unsigned int max_value, value_t* target)
+	{
+		const sample_converter<value_t> converter(max_value);
+		const auto one = sample_converter<value_t>(1).from_sample(1);
 
-		for (unsigned int j = 0; j < header.height; ++j)
+		for (std::size_t p = 0; p < pixels; ++p)
 		{
-			for (unsigned int i = 0; i < header.width; ++i)
+			for (unsigned int c = 0; c < channels; ++c)
+			{
+				target[p * image_channels + c] = converter.from_sample(read_value(position, end));
+			}
+
+			for (unsigned int c = channels; c < image_channels; ++c)
 			{
-				image(i, j)[0] = static_cast<float>(read_value(stream)) / static_cast<float>(header.max_value);
-				image(i, j)[1] = static_cast<float>(read_value(stream)) / static_cast<float>(header.max_value);
-				image(i, j)[2] = static_cast<float>(read_value(stream)) / static_cast<float>(header.max_value);
+				target[p * image_channels + c] = one;
 			}
 		}
+	}
+
+	template <typename value_t>
+	cg::image<cg::color_space_t::BW, value_t> load_plain_pbm(const unsigned char* position, const unsigned char* end, const header& header)
+	{
+		// Create image
+		cg::image<cg::color_space_t::BW, value_t> image(header.width, header.height);
+
+		read_plain_bits(position, end, static_cast<std::size_t>(header.width) * header.height, image.data()->data());
 
 		return image;
 	}
 
-	cg::image<cg::color_space_t::BW> load_pbm(std::ifstream& stream, const header& header)
+	template <typename value_t>
+	cg::image<cg::color_space_t::Gray, value_t> load_plain_pgm(const unsigned char* position, const unsigned char* end, const header& header)
 	{
-		// Read image
-		std::vector<char> buffer((header.width + header.width % 8) * header.height / 8);
-		const auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
+		// Create image
+		cg::image<cg::color_space_t::Gray, value_t> image(header.width, header.height);
 
-		stream.read(buffer.data(), buffer.size());
+		read_plain_values<1, 1>(position, end, static_cast<std::size_t>(header.width) * header.height, header.max_value, image.data()->data());
 
+		return image;
+	}
+
+	template <typename value_t>
+	cg::image<cg::color_space_t::RGB, value_t> load_plain_ppm(const unsigned char* position, const unsigned char* end, const header& header)
+	{
 		// Create image
-		cg::image<cg::color_space_t::BW> image(header.width, header.height);
+		cg::image<cg::color_space_t::RGB, value_t> image(header.width, header.height);
 
-		std::size_t index = buffer.size() - 1;
+		read_plain_values<3, 3>(position, end, static_cast<std::size_t>(header.width) * header.height, header.max_value, image.data()->data());
+
+		return image;
+	}
+
+	/// <summary>
+	/// Convert channel values stored in one byte each to color values, padding each pixel with ones
+	/// </summary>
+	/// <param name="source">Channel values of the file</param>
+	/// <param name="pixels">Number of pixels</param>
+	/// <param name="max_value">Maximum value</param>
+	/// <param name="target">Channel values of the image</param>
+	template <unsigned int channels, unsigned int image_channels, typename value_t>
+	void convert_bytes(const unsigned char* source, const std::size_t pixels, const unsigned int max_value, value_t* target)
+	{
+		const sample_converter<value_t> converter(max_value);
+		const auto one = sample_converter<value_t>(1).from_sample(1);
 
-		for (int j = header.height - 1; j >= 0; --j)
+		for (std::size_t p = 0; p < pixels; ++p)
 		{
-			for (int i = (header.width + header.width % 8) - 1; i >= 0; i -= 8)
+			for (unsigned int c = 0; c < channels; ++c)
 			{
-				image((i - 0) % header.width, j)[0] = ((cbuffer[index] & 1) != 0) ? 1.0f : 0.0f;
-				image((i - 1) % header.width, j)[0] = ((cbuffer[index] & 2) != 0) ? 1.0f : 0.0f;
-				image((i - 2) % header.width, j)[0] = ((cbuffer[index] & 4) != 0) ? 1.0f : 0.0f;
-				image((i - 3) % header.width, j)[0] = ((cbuffer[index] & 8) != 0) ? 1.0f : 0.0f;
-				image((i - 4) % header.width, j)[0] = ((cbuffer[index] & 16) != 0) ? 1.0f : 0.0f;
-				image((i - 5) % header.width, j)[0] = ((cbuffer[index] & 32) != 0) ? 1.0f : 0.0f;
-				image((i - 6) % header.width, j)[0] = ((cbuffer[index] & 64) != 0) ? 1.0f : 0.0f;
-				image((i - 7) % header.width, j)[0] = ((cbuffer[index] & 128) != 0) ? 1.0f : 0.0f;
-
-				--index;
+				target[p * image_channels + c] = converter.from_sample(source[p * channels + c]);
 			}
-		}
 
-		return image;
+			for (unsigned int c = channels; c < image_channels; ++c)
+			{
+				target[p * image_channels + c] = one;
+			}
+		}
 	}
 
-	cg::image<cg::color_space_t::Gray> load_pgm(std::ifstream& stream, const header& header)
+	/// <summary>
+	/// Convert channel values stored in two bytes each, the most significant one first, to color values,
+	/// padding each pixel with ones
+	/// </summary>
+	/// <param name="source">Channel values of the file</param>
+	/// <param name="pixels">Number of pixels</param>
+	/// <param name="max_value">Maximum value</param>
+	/// <param name="target">Channel values of the image</param>
+	template <unsigned int channels, unsigned int image_channels, typename value_t>
+	void convert_words(const unsigned char* source, const std::size_t pixels, const unsigned int max_value, value_t* target)
 	{
-		// Read image
-		std::vector<char> buffer(header.width * header.height * ((header.max_value >= 256) ? 2 : 1));
-		const auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
-		const auto* wbuffer = reinterpret_cast<char16_t*>(buffer.data());
+		const sample_converter<value_t> converter(max_value);
+		const auto one = sample_converter<value_t>(1).from_sample(1);
 
-		stream.read(buffer.data(), buffer.size());
-
-		// Create image
-		cg::image<cg::color_space_t::Gray> image(header.width, header.height);
+		for (std::size_t p = 0; p < pixels; ++p)
+		{
+			for (unsigned int c = 0; c < channels; ++c)
+			{
+				const auto value = static_cast<unsigned int>(source[2 * (p * channels + c)]) << 8 | source[2 * (p * channels + c) + 1];
 
-		std::size_t index = 0;
+				target[p * image_channels + c] = converter.from_sample(value);
+			}
 
-		for (unsigned int j = 0; j < header.height; ++j)
-		{
-			for (unsigned int i = 0; i < header.width; ++i)
+			for (unsigned int c = channels; c < image_channels; ++c)
 			{
-				if (header.max_value < 256)
-				{
-					image(i, j)[0] = static_cast<float>(cbuffer[index++]) / static_cast<float>(header.max_value);
-				}
-				else
-				{
-					image(i, j)[0] = static_cast<float>(wbuffer[index++]) / static_cast<float>(header.max_value);
-				}
+				target[p * image_channels + c] = one;
 			}
 		}
-
-		return image;
 	}
 
-	cg::image<cg::color_space_t::RGB> load_ppm(std::ifstream& stream, const header& header)
+	/// <summary>
+	/// Convert rows of a mapped PGM or PPM image in a single pass, padding each pixel with ones
+	/// </summary>
+	/// <param name="mapped">Mapped image with the given number of channels</param>
+	/// <param name="row">First row</param>
+	/// <param name="rows">Number of rows</param>
+	/// <param name="target">Channel values of the image</param>
+	template <unsigned int channels, unsigned int image_channels, typename value_t>
+	void convert_rows(const cg::image_io::mapped_image& mapped, const unsigned int row, const unsigned int rows, value_t* target)
 	{
-		// Read image
-		std::vector<char> buffer(3 * header.width * header.height * ((header.max_value >= 256) ? 2 : 1));
-		const auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
-		const auto* wbuffer = reinterpret_cast<char16_t*>(buffer.data());
+		const auto pixels = static_cast<std::size_t>(mapped.width) * rows;
+		const auto* source = mapped.pixels + row * mapped.row_size;
 
-		stream.read(buffer.data(), buffer.size());
-
-		// Create image
-		cg::image<cg::color_space_t::RGB> image(header.width, header.height);
+		if (mapped.max_value < 256)
+		{
+			convert_bytes<channels, image_channels>(source, pixels, mapped.max_value, target);
+		}
+		else
+		{
+			convert_words<channels, image_channels>(source, pixels, mapped.max_value, target);
+		}
+	}
 
-		std::size_t index = 0;
+	/// <summary>
+	/// Convert rows of a mapped PBM image, in which each byte holds eight pixels, the first one in the
+	/// most significant bit, and each row starts with a new byte
+	/// </summary>
+	/// <param name="mapped">Mapped PBM image</param>
+	/// <param name="row">First row</param>
+	/// <param name="rows">Number of rows</param>
+	/// <param name="target">Channel values of the image</param>
+	template <typename value_t>
+	void convert_bits(const cg::image_io::mapped_image& mapped, const unsigned int row, const unsigned int rows, value_t* target)
+	{
+		const auto one = sample_converter<value_t>(1).from_sample(1);
 
-		for (unsigned int j = 0; j < header.height; ++j)
+		for (unsigned int j = row; j < row + rows; ++j)
 		{
-			for (unsigned int i = 0; i < header.width; ++i)
+			const auto* source = mapped.pixels + j * mapped.row_size;
+
+			for (unsigned int i = 0; i < mapped.width; ++i)
 			{
-				if (header.max_value < 256)
-				{
-					image(i, j)[0] = static_cast<float>(cbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[1] = static_cast<float>(cbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[2] = static_cast<float>(cbuffer[index++]) / static_cast<float>(header.max_value);
-				}
-				else
-				{
-					image(i, j)[0] = static_cast<float>(wbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[1] = static_cast<float>(wbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[2] = static_cast<float>(wbuffer[index++]) / static_cast<float>(header.max_value);
-				}
+				*target++ = ((source[i / 8] >> (7 - i % 8) & 1) != 0) ? one : value_t();
 			}
 		}
-
-		return image;
 	}
 
-	cg::image<cg::color_space_t::RGBA> load_padded_ppm(std::ifstream& stream, const header& header)
+	/// <summary>
+	/// Convert the pixels of a mapped PGM or PPM image in a single pass over the contiguous image storage
+	/// </summary>
+	/// <param name="mapped">Mapped image with the given number of channels</param>
+	/// <returns>Image</returns>
+	template <cg::color_space_t color_space, unsigned int channels, typename value_t>
+	cg::image<color_space, value_t> load_pixels(const cg::image_io::mapped_image& mapped)
 	{
-		// Read image
-		std::vector<char> buffer(4 * header.width * header.height * ((header.max_value >= 256) ? 2 : 1));
-		const auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
-		const auto* wbuffer = reinterpret_cast<char16_t*>(buffer.data());
+		using tuple_type = typename cg::image<color_space, value_t>::tuple_type;
 
-		stream.read(buffer.data(), buffer.size());
+		static_assert(sizeof(tuple_type) == sizeof(value_t) * std::tuple_size<tuple_type>::value, "Pixels must be stored without padding");
 
 		// Create image
-		cg::image<cg::color_space_t::RGBA> image(header.width, header.height);
+		cg::image<color_space, value_t> image(mapped.width, mapped.height);
 
-		std::size_t index = 0;
+		convert_rows<channels, std::tuple_size<tuple_type>::value>(mapped, 0, mapped.height, image.data()->data());
 
-		for (unsigned int j = 0; j < header.height; ++j)
-		{
-			for (unsigned int i = 0; i < header.width; ++i)
-			{
-				if (header.max_value < 256)
-				{
-					image(i, j)[0] = static_cast<float>(cbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[1] = static_cast<float>(cbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[2] = static_cast<float>(cbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[3] = 1.0f;
-				}
-				else
-				{
-					image(i, j)[0] = static_cast<float>(wbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[1] = static_cast<float>(wbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[2] = static_cast<float>(wbuffer[index++]) / static_cast<float>(header.max_value);
-					image(i, j)[3] = 1.0f;
-				}
-			}
-		}
+		return image;
+	}
+
+	template <typename value_t>
+	cg::image<cg::color_space_t::BW, value_t> load_pbm(const cg::image_io::mapped_image& mapped)
+	{
+		// Create image
+		cg::image<cg::color_space_t::BW, value_t> image(mapped.width, mapped.height);
+
+		convert_bits(mapped, 0, mapped.height, image.data()->data());
 
 		return image;
 	}
 
-	void save_plain_pbm(std::ofstream& stream, const cg::image<cg::color_space_t::BW>& image)
+	template <typename value_t>
+	cg::image<cg::color_space_t::Gray, value_t> load_pgm(const cg::image_io::mapped_image& mapped)
+	{
+		return load_pixels<cg::color_space_t::Gray, 1, value_t>(mapped);
+	}
+
+	template <typename value_t>
+	cg::image<cg::color_space_t::RGB, value_t> load_ppm(const cg::image_io::mapped_image& mapped)
+	{
+		return load_pixels<cg::color_space_t::RGB, 3, value_t>(mapped);
+	}
+
+	template <typename value_t>
+	cg::image<cg::color_space_t::RGBA, value_t> load_padded_ppm(const cg::image_io::mapped_image& mapped)
+	{
+		return load_pixels<cg::color_space_t::RGBA, 3, value_t>(mapped);
+	}
+
+	template <typename value_t>
+	void save_plain_pbm(std::ofstream& stream, const cg::image<cg::color_space_t::BW, value_t>& image, const unsigned int first, const unsigned int rows)
 	{
-		for (unsigned int j = 0; j < image.get_height(); ++j)
+		for (unsigned int j = first; j < first + rows; ++j)
 		{
 			for (unsigned int i = 0; i < image.get_width() - 1; ++i)
 			{
-				stream << ((image(i, j)[0] != 0.0f) ? 1 : 0) << " ";
+				stream << ((static_cast<float>(image(i, j)[0]) != 0.0f) ? 1 : 0) << " ";
 			}
 
-			stream << ((image(image.get_width() - 1, j)[0] != 0.0f) ? 1 : 0) << std::endl;
+			stream << ((static_cast<float>(image(image.get_width() - 1, j)[0]) != 0.0f) ? 1 : 0) << std::endl;
 		}
 	}
 
-	void save_plain_pgm(std::ofstream& stream, const cg::image<cg::color_space_t::Gray>& image)
+	template <typename value_t>
+	void save_plain_pgm(std::ofstream& stream, const cg::image<cg::color_space_t::Gray, value_t>& image, const unsigned int first, const unsigned int rows)
 	{
-		for (unsigned int j = 0; j < image.get_height(); ++j)
+		const sample_converter<value_t> converter(255);
+
+		for (unsigned int j = first; j < first + rows; ++j)
 		{
 			for (unsigned int i = 0; i < image.get_width() - 1; ++i)
 			{
-				stream << static_cast<unsigned int>(image(i, j)[0] * 255.0f) << " ";
+				stream << converter.to_sample(image(i, j)[0]) << " ";
 			}
 
-			stream << static_cast<unsigned int>(image(image.get_width() - 1, j)[0] * 255.0f) << std::endl;
+			stream << converter.to_sample(image(image.get_width() - 1, j)[0]) << std::endl;
 		}
 	}
 
-	void save_plain_ppm(std::ofstream& stream, const cg::image<cg::color_space_t::RGB>& image)
+	template <typename value_t>
+	void save_plain_ppm(std::ofstream& stream, const cg::image<cg::color_space_t::RGB, value_t>& image, const unsigned int first, const unsigned int rows)
 	{
-		for (unsigned int j = 0; j < image.get_height(); ++j)
+		const sample_converter<value_t> converter(255);
+
+		for (unsigned int j = first; j < first + rows; ++j)
 		{
 			for (unsigned int i = 0; i < image.get_width() - 1; ++i)
 			{
-				stream << static_cast<unsigned int>(image(i, j)[0] * 255.0f) << " ";
-				stream << static_cast<unsigned int>(image(i, j)[1] * 255.0f) << " ";
-				stream << static_cast<unsigned int>(image(i, j)[2] * 255.0f) << "\t";
+				stream << converter.to_sample(image(i, j)[0]) << " ";
+				stream << converter.to_sample(image(i, j)[1]) << " ";
+				stream << converter.to_sample(image(i, j)[2]) << "\t";
 			}
 
-			stream << static_cast<unsigned int>(image(image.get_width() - 1, j)[0] * 255.0f) << " ";
-			stream << static_cast<unsigned int>(image(image.get_width() - 1, j)[1] * 255.0f) << " ";
-			stream << static_cast<unsigned int>(image(image.get_width() - 1, j)[2] * 255.0f) << std::endl;
+			stream << converter.to_sample(image(image.get_width() - 1, j)[0]) << " ";
+			stream << converter.to_sample(image(image.get_width() - 1, j)[1]) << " ";
+			stream << converter.to_sample(image(image.get_width() - 1, j)[2]) << std::endl;
 		}
 	}
 
-	void save_pbm(std::ofstream& stream, const cg::image<cg::color_space_t::BW>& image)
+	template <typename value_t>
+	void save_pbm(std::ofstream& stream, const cg::image<cg::color_space_t::BW, value_t>& image, const unsigned int first, const unsigned int rows)
 	{
-		// Create buffer
-		std::vector<char> buffer((image.get_width() + image.get_width() % 8) * image.get_height() / 8);
-		auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
+		// Create buffer, in which each row starts with a new byte
+		const std::size_t row_size = (image.get_width() + 7) / 8;
 
-		std::size_t index = 0;
+		std::vector<char> buffer(row_size * rows, 0);
+		auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
 
-		for (unsigned int j = 0; j < image.get_height(); ++j)
+		for (unsigned int j = 0; j < rows; ++j)
 		{
-			for (unsigned int i = 0; i < image.get_width(); i += 8)
+			for (unsigned int i = 0; i < image.get_width(); ++i)
 			{
-				cbuffer[index] = static_cast<unsigned char>(0);
-
-				cbuffer[index] |= (image((i + 0) % image.get_width(), j)[0] != 0.0f) ? 128 : 0;
-				cbuffer[index] |= (image((i + 1) % image.get_width(), j)[0] != 0.0f) ? 64 : 0;
-				cbuffer[index] |= (image((i + 2) % image.get_width(), j)[0] != 0.0f) ? 32 : 0;
-				cbuffer[index] |= (image((i + 3) % image.get_width(), j)[0] != 0.0f) ? 16 : 0;
-				cbuffer[index] |= (image((i + 4) % image.get_width(), j)[0] != 0.0f) ? 8 : 0;
-				cbuffer[index] |= (image((i + 5) % image.get_width(), j)[0] != 0.0f) ? 4 : 0;
-				cbuffer[index] |= (image((i + 6) % image.get_width(), j)[0] != 0.0f) ? 2 : 0;
-				cbuffer[index] |= (image((i + 7) % image.get_width(), j)[0] != 0.0f) ? 1 : 0;
-
-				++index;
+				cbuffer[j * row_size + i / 8] |= (static_cast<float>(image(i, first + j)[0]) != 0.0f) ? (128 >> (i % 8)) : 0;
 			}
 		}
 
@@ -450,26 +614,40 @@ namespace
 		stream.write(buffer.data(), buffer.size());
 	}
 
-	void save_pgm(std::ofstream& stream, const cg::image<cg::color_space_t::Gray>& image, const unsigned int max_value)
+	/// <summary>
+	/// Store a channel value in two bytes, the most significant one first as required by Netpbm
+	/// </summary>
+	/// <param name="buffer">Buffer</param>
+	/// <param name="index">Index of the value</param>
+	/// <param name="value">Value in [0, 65535]</param>
+	void write_word(unsigned char* buffer, const std::size_t index, const unsigned int value)
+	{
+		buffer[2 * index] = static_cast<unsigned char>(value >> 8);
+		buffer[2 * index + 1] = static_cast<unsigned char>(value & 0xFF);
+	}
+
+	template <typename value_t>
+	void save_pgm(std::ofstream& stream, const cg::image<cg::color_space_t::Gray, value_t>& image, const unsigned int first, const unsigned int rows, const unsigned int max_value)
 	{
+		const sample_converter<value_t> converter(max_value);
+
 		// Create buffer
-		std::vector<char> buffer(image.get_width() * image.get_height() * ((max_value >= 256) ? 2 : 1));
+		std::vector<char> buffer(static_cast<std::size_t>(image.get_width()) * rows * ((max_value >= 256) ? 2 : 1));
 		auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
-		auto* wbuffer = reinterpret_cast<char16_t*>(buffer.data());
 
 		std::size_t index = 0;
 
-		for (unsigned int j = 0; j < image.get_height(); ++j)
+		for (unsigned int j = first; j < first + rows; ++j)
 		{
 			for (unsigned int i = 0; i < image.get_width(); ++i)
 			{
 				if (max_value < 256)
 				{
-					cbuffer[index++] = static_cast<unsigned char>(image(i, j)[0] * max_value);
+					cbuffer[index++] = static_cast<unsigned char>(converter.to_sample(image(i, j)[0]));
 				}
 				else
 				{
-					wbuffer[index++] = static_cast<char16_t>(image(i, j)[0] * max_value);
+					write_word(cbuffer, index++, converter.to_sample(image(i, j)[0]));
 				}
 			}
 		}
@@ -478,30 +656,32 @@ namespace
 		stream.write(buffer.data(), buffer.size());
 	}
 
-	void save_ppm(std::ofstream& stream, const cg::image<cg::color_space_t::RGB>& image, const unsigned int max_value)
+	template <typename value_t>
+	void save_ppm(std::ofstream& stream, const cg::image<cg::color_space_t::RGB, value_t>& image, const unsigned int first, const unsigned int rows, const unsigned int max_value)
 	{
+		const sample_converter<value_t> converter(max_value);
+
 		// Create buffer
-		std::vector<char> buffer(3 * image.get_width() * image.get_height() * ((max_value >= 256) ? 2 : 1));
+		std::vector<char> buffer(3 * static_cast<std::size_t>(image.get_width()) * rows * ((max_value >= 256) ? 2 : 1));
 		auto* cbuffer = reinterpret_cast<unsigned char*>(buffer.data());
-		auto* wbuffer = reinterpret_cast<char16_t*>(buffer.data());
 
 		std::size_t index = 0;
 
-		for (unsigned int j = 0; j < image.get_height(); ++j)
+		for (unsigned int j = first; j < first + rows; ++j)
 		{
 			for (unsigned int i = 0; i < image.get_width(); ++i)
 			{
 				if (max_value < 256)
 				{
-					cbuffer[index++] = static_cast<unsigned char>(image(i, j)[0] * max_value);
-					cbuffer[index++] = static_cast<unsigned char>(image(i, j)[1] * max_value);
-					cbuffer[index++] = static_cast<unsigned char>(image(i, j)[2] * max_value);
+					cbuffer[index++] = static_cast<unsigned char>(converter.to_sample(image(i, j)[0]));
+					cbuffer[index++] = static_cast<unsigned char>(converter.to_sample(image(i, j)[1]));
+					cbuffer[index++] = static_cast<unsigned char>(converter.to_sample(image(i, j)[2]));
 				}
 				else
 				{
-					wbuffer[index++] = static_cast<char16_t>(image(i, j)[0] * max_value);
-					wbuffer[index++] = static_cast<char16_t>(image(i, j)[1] * max_value);
-					wbuffer[index++] = static_cast<char16_t>(image(i, j)[2] * max_value);
+					write_word(cbuffer, index++, converter.to_sample(image(i, j)[0]));
+					write_word(cbuffer, index++, converter.to_sample(image(i, j)[1]));
+					write_word(cbuffer, index++, converter.to_sample(image(i, j)[2]));
 				}
 			}
 		}
@@ -510,166 +690,253 @@ namespace
 		stream.write(buffer.data(), buffer.size());
 	}
 
-	
-}
+	/// <summary>
+	/// Create the header of a file to save an image to
+	/// </summary>
+	/// <param name="color_space">Color space: BW for PBM, Gray for PGM and RGB for PPM files</param>
+	/// <param name="width">Width</param>
+	/// <param name="height">Height</param>
+	/// <param name="double_prec">65536 colors instead of 256</param>
+	/// <param name="plain">Plain or binary</param>
+	/// <returns>Header</returns>
+	header create_header(const cg::color_space_t color_space, const unsigned int width, const unsigned int height, const bool double_prec, const bool plain)
+	{
+		header file_header;
+		file_header.width = width;
+		file_header.height = height;
+		file_header.max_value = (double_prec && !plain) ? 65535 : 255;
 
-std::shared_ptr<cg::image_base> cg::image_io::load_image(const std::string& path)
-{
-	std::ifstream image_file(path, std::iostream::in | std::iostream::binary);
+		switch (color_space)
+		{
+		case cg::color_space_t::BW:
+			file_header.file_type = plain ? header::PLAIN_PBM : header::PBM;
+			file_header.max_value = 1;
 
-	if (image_file.is_open() && image_file.good())
+			break;
+		case cg::color_space_t::Gray:
+			file_header.file_type = plain ? header::PLAIN_PGM : header::PGM;
+
+			break;
+		case cg::color_space_t::RGB:
+			file_header.file_type = plain ? header::PLAIN_PPM : header::PPM;
+
+			break;
+		default:
+			throw std::runtime_error("Only black-and-white, grayscale and RGB images can be saved");
+		}
+
+		return file_header;
+	}
+
+	/// <summary>
+	/// Load an image from a mapped file
+	/// </summary>
+	/// <param name="file">Mapped file</param>
+	/// <param name="file_header">Header</param>
+	/// <param name="position">Position of the first pixel</param>
+	/// <returns>Image</returns>
+	template <typename value_t>
+	std::shared_ptr<cg::image_base> load_mapped_image(const std::shared_ptr<const cg::mapped_file>& file, const header& file_header, const unsigned char* position)
 	{
-		auto header = load_header(image_file);
-		image_file.close();
+		const auto* end = file->data() + file->size();
 
-		switch (header.file_type)
+		switch (file_header.file_type)
 		{
 		case header::PLAIN_PBM:
+			return std::make_shared<cg::image<cg::color_space_t::BW, value_t>>(load_plain_pbm<value_t>(position, end, file_header));
 		case header::PBM:
-			return std::make_shared<cg::image<cg::color_space_t::BW>>(load_bw_image(path));
-
-			break;
+			return std::make_shared<cg::image<cg::color_space_t::BW, value_t>>(load_pbm<value_t>(map_pixels(file, file_header, position)));
 		case header::PLAIN_PGM:
+			return std::make_shared<cg::image<cg::color_space_t::Gray, value_t>>(load_plain_pgm<value_t>(position, end, file_header));
 		case header::PGM:
-			return std::make_shared<cg::image<cg::color_space_t::Gray>>(load_grayscale_image(path));
-
-			break;
+			return std::make_shared<cg::image<cg::color_space_t::Gray, value_t>>(load_pgm<value_t>(map_pixels(file, file_header, position)));
 		case header::PLAIN_PPM:
+			return std::make_shared<cg::image<cg::color_space_t::RGB, value_t>>(load_plain_ppm<value_t>(position, end, file_header));
 		case header::PPM:
-			return std::make_shared<cg::image<cg::color_space_t::RGB>>(load_rgb_image(path));
+			return std::make_shared<cg::image<cg::color_space_t::RGB, value_t>>(load_ppm<value_t>(map_pixels(file, file_header, position)));
+		default:
+			break;
 		}
 
 		throw std::runtime_error("Unknown image file format");
 	}
 
-	throw std::runtime_error("Unable to open file");
+	/// <summary>
+	/// Save an image to file if its color values have the given storage type
+	/// </summary>
+	/// <param name="path">Path to image file</param>
+	/// <param name="image">Image</param>
+	/// <param name="double_prec">65536 colors instead of 256</param>
+	/// <param name="plain">Plain or binary</param>
+	/// <returns>True if the image has been saved</returns>
+	template <typename value_t>
+	bool save_typed_image(const std::string& path, const cg::image_base* image, const bool double_prec, const bool plain)
+	{
+		const auto* bw_image = dynamic_cast<const cg::image<cg::color_space_t::BW, value_t>*>(image);
+		const auto* gray_image = dynamic_cast<const cg::image<cg::color_space_t::Gray, value_t>*>(image);
+		const auto* rgb_image = dynamic_cast<const cg::image<cg::color_space_t::RGB, value_t>*>(image);
+
+		if (bw_image != nullptr)
+		{
+			cg::image_io::save_bw_image(path, *bw_image, plain);
+		}
+		else if (gray_image != nullptr)
+		{
+			cg::image_io::save_grayscale_image(path, *gray_image, double_prec, plain);
+		}
+		else if (rgb_image != nullptr)
+		{
+			cg::image_io::save_rgb_image(path, *rgb_image, double_prec, plain);
+		}
+
+		return bw_image != nullptr || gray_image != nullptr || rgb_image != nullptr;
+	}
+	
 }
 
-void cg::image_io::save_image(const std::string& path, const std::shared_ptr<cg::image_base>& image, bool double_prec, const bool plain)
+std::shared_ptr<cg::image_base> cg::image_io::load_image(const std::string& path)
 {
-	const auto* bw_image = dynamic_cast<cg::image<cg::color_space_t::BW>*>(image.get());
-	const auto* gray_image = dynamic_cast<cg::image<cg::color_space_t::Gray>*>(image.get());
-	const auto* rgb_image = dynamic_cast<cg::image<cg::color_space_t::RGB>*>(image.get());
+	header header;
+	const unsigned char* position;
+	const auto file = open_image(path, header, position);
+
+	return load_mapped_image<float>(file, header, position);
+}
 
-	if (bw_image != nullptr)
+std::shared_ptr<cg::image_base> cg::image_io::load_native_image(const std::string& path)
+{
+	header header;
+	const unsigned char* position;
+	const auto file = open_image(path, header, position);
+
+	if (header.max_value < 256)
 	{
-		save_bw_image(path, *bw_image, plain);
+		return load_mapped_image<std::uint8_t>(file, header, position);
 	}
-	else if(gray_image != nullptr)
+
+	return load_mapped_image<std::uint16_t>(file, header, position);
+}
+
+void cg::image_io::save_image(const std::string& path, const std::shared_ptr<cg::image_base>& image, bool double_prec, const bool plain)
+{
+	save_typed_image<float>(path, image.get(), double_prec, plain)
+		|| save_typed_image<std::uint8_t>(path, image.get(), double_prec, plain)
+		|| save_typed_image<std::uint16_t>(path, image.get(), double_prec, plain)
+		|| save_typed_image<cg::half>(path, image.get(), double_prec, plain);
+}
+
+cg::image_io::mapped_image cg::image_io::map_image(const std::string& path)
+{
+	header header;
+	const unsigned char* position;
+	const auto file = open_image(path, header, position);
+
+	return map_pixels(file, header, position);
+}
+
+template <typename value_t>
+cg::image<cg::color_space_t::BW, value_t> cg::image_io::load_bw_image(const std::string& path)
+{
+	header header;
+	const unsigned char* position;
+	const auto file = open_image(path, header, position);
+
+	if (header.file_type == header::PBM)
 	{
-		save_grayscale_image(path, *gray_image, double_prec, plain);
+		return load_pbm<value_t>(map_pixels(file, header, position));
 	}
-	else if (rgb_image != nullptr)
+	else if (header.file_type == header::PLAIN_PBM)
 	{
-		save_rgb_image(path, *rgb_image, double_prec, plain);
+		return load_plain_pbm<value_t>(position, file->data() + file->size(), header);
 	}
+
+	throw std::runtime_error("Black-and-white images can only be loaded from PBM files");
 }
 
-cg::image<cg::color_space_t::BW> cg::image_io::load_bw_image(const std::string& path)
+template <typename value_t>
+cg::image<cg::color_space_t::Gray, value_t> cg::image_io::load_grayscale_image(const std::string& path)
 {
-	std::ifstream image_file(path, std::iostream::in | std::iostream::binary);
+	header header;
+	const unsigned char* position;
+	const auto file = open_image(path, header, position);
 
-	if (image_file.is_open() && image_file.good())
+	if (header.file_type == header::PGM)
 	{
-		auto header = load_header(image_file);
-
-		if (header.file_type == header::PBM)
-		{
-			return load_pbm(image_file, header);
-		}
-		else if (header.file_type == header::PLAIN_PBM)
-		{
-			return load_plain_pbm(image_file, header);
-		}
-
-		throw std::runtime_error("Black-and-white images can only be loaded from PBM files");
+		return load_pgm<value_t>(map_pixels(file, header, position));
+	}
+	else if (header.file_type == header::PLAIN_PGM)
+	{
+		return load_plain_pgm<value_t>(position, file->data() + file->size(), header);
 	}
 
-	throw std::runtime_error("Unable to open file");
+	throw std::runtime_error("Grayscale images can only be loaded from PGM files");
 }
 
-cg::image<cg::color_space_t::Gray> cg::image_io::load_grayscale_image(const std::string& path)
+template <typename value_t>
+cg::image<cg::color_space_t::RGB, value_t> cg::image_io::load_rgb_image(const std::string& path)
 {
-	std::ifstream image_file(path, std::iostream::in | std::iostream::binary);
+	header header;
+	const unsigned char* position;
+	const auto file = open_image(path, header, position);
 
-	if (image_file.is_open() && image_file.good())
+	if (header.file_type == header::PPM)
 	{
-		auto header = load_header(image_file);
-
-		if (header.file_type == header::PGM)
-		{
-			return load_pgm(image_file, header);
-		}
-		else if (header.file_type == header::PLAIN_PGM)
-		{
-			return load_plain_pgm(image_file, header);
-		}
-
-		throw std::runtime_error("Grayscale images can only be loaded from PGM files");
+		return load_ppm<value_t>(map_pixels(file, header, position));
+	}
+	else if (header.file_type == header::PLAIN_PPM)
+	{
+		return load_plain_ppm<value_t>(position, file->data() + file->size(), header);
 	}
 
-	throw std::runtime_error("Unable to open file");
+	throw std::runtime_error("RGB images can only be loaded from PPM files");
 }
 
-cg::image<cg::color_space_t::RGB> cg::image_io::load_rgb_image(const std::string& path)
+template <typename value_t>
+cg::image<cg::color_space_t::RGBA, value_t> cg::image_io::load_padded_rgba_image(const std::string& path)
 {
-	std::ifstream image_file(path, std::iostream::in | std::iostream::binary);
+	header header;
+	const unsigned char* position;
+	const auto file = open_image(path, header, position);
 
-	if (image_file.is_open() && image_file.good())
+	if (header.file_type == header::PPM)
 	{
-		auto header = load_header(image_file);
-
-		if (header.file_type == header::PPM)
-		{
-			return load_ppm(image_file, header);
-		}
-		else if (header.file_type == header::PLAIN_PPM)
-		{
-			return load_plain_ppm(image_file, header);
-		}
-
-		throw std::runtime_error("RGB images can only be loaded from PPM files");
+		return load_padded_ppm<value_t>(map_pixels(file, header, position));
+	}
+	else if (header.file_type == header::PLAIN_PPM)
+	{
+		throw std::runtime_error("RGB images can only be loaded from (non-plain) PPM files");
 	}
-		
-	throw std::runtime_error("Unable to open file");
+
+	throw std::runtime_error("RGB images can only be loaded from PPM files");
 }
 
-cg::image<cg::color_space_t::RGBA> cg::image_io::load_padded_rgba_image(const std::string& path)
+template <typename value_t>
+void cg::image_io::save_bw_image(const std::string& path, const cg::image<cg::color_space_t::BW, value_t>& image, const bool plain)
 {
-	std::ifstream image_file(path, std::iostream::in | std::iostream::binary);
+	std::ofstream image_file(path, std::iostream::out | std::iostream::binary);
 
 	if (image_file.is_open() && image_file.good())
 	{
-		auto header = load_header(image_file);
-
-		if (header.file_type == header::PPM)
-		{
-			return load_padded_ppm(image_file, header);
-		}
-		else if (header.file_type == header::PLAIN_PPM)
-		{
-			throw std::runtime_error("RGB images can only be loaded from (non-plain) PPM files");
-		}
-
-		throw std::runtime_error("RGB images can only be loaded from PPM files");
+		save_header(image_file, create_header(cg::color_space_t::BW, image.get_width(), image.get_height(), false, plain));
+		plain ? save_plain_pbm(image_file, image, 0, image.get_height()) : save_pbm(image_file, image, 0, image.get_height());
+	}
+	else
+	{
+		throw std::runtime_error("Unable to open file");
 	}
-
-	throw std::runtime_error("Unable to open file");
 }
 
-void cg::image_io::save_bw_image(const std::string& path, const cg::image<cg::color_space_t::BW>& image, const bool plain)
+template <typename value_t>
+void cg::image_io::save_grayscale_image(const std::string& path, const cg::image<cg::color_space_t::Gray, value_t>& image, bool double_prec, const bool plain)
 {
 	std::ofstream image_file(path, std::iostream::out | std::iostream::binary);
 
 	if (image_file.is_open() && image_file.good())
 	{
-		header header;
-		header.file_type = plain ? header::PLAIN_PBM : header::PBM;
-		header.width = image.get_width();
-		header.height = image.get_height();
+		const auto header = create_header(cg::color_space_t::Gray, image.get_width(), image.get_height(), double_prec, plain);
 
 		save_header(image_file, header);
-		plain ? save_plain_pbm(image_file, image) : save_pbm(image_file, image);
+		plain ? save_plain_pgm(image_file, image, 0, image.get_height()) : save_pgm(image_file, image, 0, image.get_height(), header.max_value);
 	}
 	else
 	{
@@ -677,20 +944,17 @@ void cg::image_io::save_bw_image(const std::string& path, const cg::image<cg::co
 	}
 }
 
-void cg::image_io::save_grayscale_image(const std::string& path, const cg::image<cg::color_space_t::Gray>& image, bool double_prec, const bool plain)
+template <typename value_t>
+void cg::image_io::save_rgb_image(const std::string& path, const cg::image<cg::color_space_t::RGB, value_t>& image, bool double_prec, const bool plain)
 {
 	std::ofstream image_file(path, std::iostream::out | std::iostream::binary);
 
 	if (image_file.is_open() && image_file.good())
 	{
-		header header;
-		header.file_type = plain ? header::PLAIN_PGM : header::PGM;
-		header.width = image.get_width();
-		header.height = image.get_height();
-		header.max_value = double_prec ? 65535 : 255;
+		const auto header = create_header(cg::color_space_t::RGB, image.get_width(), image.get_height(), double_prec, plain);
 
 		save_header(image_file, header);
-		plain ? save_plain_pgm(image_file, image) : save_pgm(image_file, image, header.max_value);
+		plain ? save_plain_ppm(image_file, image, 0, image.get_height()) : save_ppm(image_file, image, 0, image.get_height(), header.max_value);
 	}
 	else
 	{
@@ -698,23 +962,229 @@ void cg::image_io::save_grayscale_image(const std::string& path, const cg::image
 	}
 }
 
-void cg::image_io::save_rgb_image(const std::string& path, const cg::image<cg::color_space_t::RGB>& image, bool double_prec, const bool plain)
+cg::image_io::row_reader::row_reader(const std::string& path) : m_row(0)
 {
-	std::ofstream image_file(path, std::iostream::out | std::iostream::binary);
+	header header;
+	const auto file = open_image(path, header, this->m_position);
 
-	if (image_file.is_open() && image_file.good())
+	this->m_end = file->data() + file->size();
+	this->m_plain = header.file_type == header::PLAIN_PBM || header.file_type == header::PLAIN_PGM || header.file_type == header::PLAIN_PPM;
+
+	if (this->m_plain)
+	{
+		// Plain images are parsed value by value, so only the header is stored
+		this->m_image.file = file;
+		this->m_image.color_space = (header.file_type == header::PLAIN_PBM) ? cg::color_space_t::BW : (header.file_type == header::PLAIN_PGM) ? cg::color_space_t::Gray : cg::color_space_t::RGB;
+		this->m_image.width = header.width;
+		this->m_image.height = header.height;
+		this->m_image.max_value = header.max_value;
+		this->m_image.pixels = this->m_position;
+		this->m_image.row_size = 0;
+	}
+	else
 	{
-		header header;
-		header.file_type = plain ? header::PLAIN_PPM : header::PPM;
-		header.width = image.get_width();
-		header.height = image.get_height();
-		header.max_value = double_prec ? 65535 : 255;
+		this->m_image = map_pixels(file, header, this->m_position);
+	}
+}
 
-		save_header(image_file, header);
-		plain ? save_plain_ppm(image_file, image) : save_ppm(image_file, image, header.max_value);
+cg::color_space_t cg::image_io::row_reader::get_color_space() const
+{
+	return this->m_image.color_space;
+}
+
+unsigned int cg::image_io::row_reader::get_width() const
+{
+	return this->m_image.width;
+}
+
+unsigned int cg::image_io::row_reader::get_height() const
+{
+	return this->m_image.height;
+}
+
+unsigned int cg::image_io::row_reader::get_row() const
+{
+	return this->m_row;
+}
+
+unsigned int cg::image_io::row_reader::read_rows(cg::image<cg::color_space_t::BW>& band, const unsigned int first)
+{
+	if (this->m_image.color_space != cg::color_space_t::BW)
+	{
+		throw std::runtime_error("Black-and-white images can only be loaded from PBM files");
+	}
+
+	return read_band(band, first);
+}
+
+unsigned int cg::image_io::row_reader::read_rows(cg::image<cg::color_space_t::Gray>& band, const unsigned int first)
+{
+	if (this->m_image.color_space != cg::color_space_t::Gray)
+	{
+		throw std::runtime_error("Grayscale images can only be loaded from PGM files");
+	}
+
+	return read_band(band, first);
+}
+
+unsigned int cg::image_io::row_reader::read_rows(cg::image<cg::color_space_t::RGB>& band, const unsigned int first)
+{
+	if (this->m_image.color_space != cg::color_space_t::RGB)
+	{
+		throw std::runtime_error("RGB images can only be loaded from PPM files");
+	}
+
+	return read_band(band, first);
+}
+
+unsigned int cg::image_io::row_reader::read_rows(cg::image<cg::color_space_t::RGBA>& band, const unsigned int first)
+{
+	if (this->m_image.color_space != cg::color_space_t::RGB)
+	{
+		throw std::runtime_error("RGB images can only be loaded from PPM files");
+	}
+
+	return read_band(band, first);
+}
+
+template <cg::color_space_t color_space>
+unsigned int cg::image_io::row_reader::read_band(cg::image<color_space>& band, const unsigned int first)
+{
+	using tuple_type = typename cg::image<color_space>::tuple_type;
+
+	static_assert(sizeof(tuple_type) == sizeof(float) * std::tuple_size<tuple_type>::value, "Pixels must be stored without padding");
+
+	constexpr unsigned int channels = (color_space == cg::color_space_t::RGBA) ? 3 : std::tuple_size<tuple_type>::value;
+	constexpr unsigned int image_channels = std::tuple_size<tuple_type>::value;
+
+	if (band.get_width() != this->m_image.width || first > band.get_height())
+	{
+		throw std::runtime_error("Band does not match the image");
+	}
+
+	const auto rows = std::min(band.get_height() - first, this->m_image.height - this->m_row);
+	auto* target = (band.data() + static_cast<std::size_t>(first) * band.get_width())->data();
+
+	if (color_space == cg::color_space_t::BW)
+	{
+		this->m_plain ? read_plain_bits(this->m_position, this->m_end, static_cast<std::size_t>(this->m_image.width) * rows, target)
+			: convert_bits(this->m_image, this->m_row, rows, target);
 	}
 	else
+	{
+		this->m_plain ? read_plain_values<channels, image_channels>(this->m_position, this->m_end, static_cast<std::size_t>(this->m_image.width) * rows, this->m_image.max_value, target)
+			: convert_rows<channels, image_channels>(this->m_image, this->m_row, rows, target);
+	}
+
+	this->m_row += rows;
+
+	return rows;
+}
+
+cg::image_io::row_writer::row_writer(const std::string& path, const cg::color_space_t color_space, const unsigned int width, const unsigned int height, const bool double_prec, const bool plain)
+	: m_stream(path, std::iostream::out | std::iostream::binary), m_color_space(color_space), m_width(width), m_height(height), m_plain(plain), m_row(0)
+{
+	if (!this->m_stream.is_open() || !this->m_stream.good())
 	{
 		throw std::runtime_error("Unable to open file");
 	}
-}
\ No newline at end of file
+
+	const auto header = create_header(color_space, width, height, double_prec, plain);
+	this->m_max_value = header.max_value;
+
+	save_header(this->m_stream, header);
+}
+
+unsigned int cg::image_io::row_writer::get_row() const
+{
+	return this->m_row;
+}
+
+void cg::image_io::row_writer::write_rows(const cg::image<cg::color_space_t::BW>& band, const unsigned int first, const unsigned int count)
+{
+	check_rows(cg::color_space_t::BW, band, first, count);
+
+	this->m_plain ? save_plain_pbm(this->m_stream, band, first, count) : save_pbm(this->m_stream, band, first, count);
+	this->m_row += count;
+}
+
+void cg::image_io::row_writer::write_rows(const cg::image<cg::color_space_t::Gray>& band, const unsigned int first, const unsigned int count)
+{
+	check_rows(cg::color_space_t::Gray, band, first, count);
+
+	this->m_plain ? save_plain_pgm(this->m_stream, band, first, count) : save_pgm(this->m_stream, band, first, count, this->m_max_value);
+	this->m_row += count;
+}
+
+void cg::image_io::row_writer::write_rows(const cg::image<cg::color_space_t::RGB>& band, const unsigned int first, const unsigned int count)
+{
+	check_rows(cg::color_space_t::RGB, band, first, count);
+
+	this->m_plain ? save_plain_ppm(this->m_stream, band, first, count) : save_ppm(this->m_stream, band, first, count, this->m_max_value);
+	this->m_row += count;
+}
+
+void cg::image_io::row_writer::close()
+{
+	if (this->m_row != this->m_height)
+	{
+		throw std::runtime_error("Not all rows of the image have been written");
+	}
+
+	this->m_stream.close();
+
+	if (this->m_stream.fail())
+	{
+		throw std::runtime_error("Unable to write file");
+	}
+}
+
+void cg::image_io::row_writer::check_rows(const cg::color_space_t color_space, const cg::image_base& band, const unsigned int first, const unsigned int count) const
+{
+	if (color_space != this->m_color_space)
+	{
+		throw std::runtime_error("Color space does not match the file");
+	}
+
+	if (band.get_width() != this->m_width || first > band.get_height() || count > band.get_height() - first)
+	{
+		throw std::runtime_error("Band does not match the image");
+	}
+
+	if (count > this->m_height - this->m_row)
+	{
+		throw std::runtime_error("Too many rows for the image");
+	}
+}
+
+template cg::image<cg::color_space_t::BW, float> cg::image_io::load_bw_image<float>(const std::string&);
+template cg::image<cg::color_space_t::Gray, float> cg::image_io::load_grayscale_image<float>(const std::string&);
+template cg::image<cg::color_space_t::RGB, float> cg::image_io::load_rgb_image<float>(const std::string&);
+template cg::image<cg::color_space_t::RGBA, float> cg::image_io::load_padded_rgba_image<float>(const std::string&);
+template void cg::image_io::save_bw_image(const std::string&, const cg::image<cg::color_space_t::BW, float>&, bool);
+template void cg::image_io::save_grayscale_image(const std::string&, const cg::image<cg::color_space_t::Gray, float>&, bool, bool);
+template void cg::image_io::save_rgb_image(const std::string&, const cg::image<cg::color_space_t::RGB, float>&, bool, bool);
+
+template cg::image<cg::color_space_t::BW, cg::half> cg::image_io::load_bw_image<cg::half>(const std::string&);
+template cg::image<cg::color_space_t::Gray, cg::half> cg::image_io::load_grayscale_image<cg::half>(const std::string&);
+template cg::image<cg::color_space_t::RGB, cg::half> cg::image_io::load_rgb_image<cg::half>(const std::string&);
+template cg::image<cg::color_space_t::RGBA, cg::half> cg::image_io::load_padded_rgba_image<cg::half>(const std::string&);
+template void cg::image_io::save_bw_image(const std::string&, const cg::image<cg::color_space_t::BW, cg::half>&, bool);
+template void cg::image_io::save_grayscale_image(const std::string&, const cg::image<cg::color_space_t::Gray, cg::half>&, bool, bool);
+template void cg::image_io::save_rgb_image(const std::string&, const cg::image<cg::color_space_t::RGB, cg::half>&, bool, bool);
+
+template cg::image<cg::color_space_t::BW, std::uint8_t> cg::image_io::load_bw_image<std::uint8_t>(const std::string&);
+template cg::image<cg::color_space_t::Gray, std::uint8_t> cg::image_io::load_grayscale_image<std::uint8_t>(const std::string&);
+template cg::image<cg::color_space_t::RGB, std::uint8_t> cg::image_io::load_rgb_image<std::uint8_t>(const std::string&);
+template cg::image<cg::color_space_t::RGBA, std::uint8_t> cg::image_io::load_padded_rgba_image<std::uint8_t>(const std::string&);
+template void cg::image_io::save_bw_image(const std::string&, const cg::image<cg::color_space_t::BW, std::uint8_t>&, bool);
+template void cg::image_io::save_grayscale_image(const std::string&, const cg::image<cg::color_space_t::Gray, std::uint8_t>&, bool, bool);
+template void cg::image_io::save_rgb_image(const std::string&, const cg::image<cg::color_space_t::RGB, std::uint8_t>&, bool, bool);
+
+template cg::image<cg::color_space_t::BW, std::uint16_t> cg::image_io::load_bw_image<std::uint16_t>(const std::string&);
+template cg::image<cg::color_space_t::Gray, std::uint16_t> cg::image_io::load_grayscale_image<std::uint16_t>(const std::string&);
+template cg::image<cg::color_space_t::RGB, std::uint16_t> cg::image_io::load_rgb_image<std::uint16_t>(const std::string&);
+template cg::image<cg::color_space_t::RGBA, std::uint16_t> cg::image_io::load_padded_rgba_image<std::uint16_t>(const std::string&);
+template void cg::image_io::save_bw_image(const std::string&, const cg::image<cg::color_space_t::BW, std::uint16_t>&, bool);
+template void cg::image_io::save_grayscale_image(const std::string&, const cg::image<cg::color_space_t::Gray, std::uint16_t>&, bool, bool);
+template void cg::image_io::save_rgb_image(const std::string&, const cg::image<cg::color_space_t::RGB, std::uint16_t>&, bool, bool);
\ No newline at end of file
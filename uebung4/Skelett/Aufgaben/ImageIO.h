@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Image.h"
+#include "MappedFile.h"
 
+#include <cstddef>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -14,9 +16,42 @@ namespace cg
 	/// PBM: Netpbm bi-level image format (http://netpbm.sourceforge.net/doc/pbm.html)
 	/// PGM: Netpbm grayscale image format (http://netpbm.sourceforge.net/doc/pgm.html)
 	/// PPM: Netpbm color image format (http://netpbm.sourceforge.net/doc/ppm.html)
+	///
+	/// Images can use any storage type, see value_traits. Integer images keep the values of files with
+	/// the same depth as they are, e.g., 8-bit PPM files in std::uint8_t images, and rescale them otherwise.
 	/// </summary>
 	namespace image_io
 	{
+		/// <summary>
+		/// Binary image (PBM, PGM or PPM) mapped into memory, whose pixels are the bytes of the file
+		/// </summary>
+		struct mapped_image
+		{
+			/// Mapped file, which stays mapped as long as the image exists
+			std::shared_ptr<const mapped_file> file;
+
+			/// Color space: BW for PBM, Gray for PGM and RGB for PPM files
+			color_space_t color_space;
+
+			/// Width, height and maximum value of a channel (1 for PBM files)
+			unsigned int width;
+			unsigned int height;
+			unsigned int max_value;
+
+			/// First byte of the pixels and number of bytes per row: rows of PBM files hold eight pixels per byte,
+			/// the first one in the most significant bit, and are padded to whole bytes; PGM and PPM files store
+			/// a channel in one byte, or in two bytes with the most significant one first if max_value exceeds 255
+			const unsigned char* pixels;
+			std::size_t row_size;
+		};
+
+		/// <summary>
+		/// Map a binary image (P4, P5 or P6) into memory without copying or converting its pixels
+		/// </summary>
+		/// <param name="path">Path to image file</param>
+		/// <returns>Mapped image</returns>
+		mapped_image map_image(const std::string& path);
+
 		/// <summary>
 		/// Load an image from file
 		/// </summary>
@@ -24,6 +59,14 @@ namespace cg
 		/// <returns>Image</returns>
 		std::shared_ptr<image_base> load_image(const std::string& path);
 
+		/// <summary>
+		/// Load an image from file, keeping the depth of the file: std::uint8_t values for a maximum value
+		/// up to 255, including PBM files, and std::uint16_t values otherwise
+		/// </summary>
+		/// <param name="path">Path to image file</param>
+		/// <returns>Image</returns>
+		std::shared_ptr<image_base> load_native_image(const std::string& path);
+
 		/// <summary>
 		/// Save an image to file
 		/// </summary>
@@ -38,28 +81,32 @@ namespace cg
 		/// </summary>
 		/// <param name="path">Path to image file</param>
 		/// <returns>Black and white image</returns>
-		image<color_space_t::BW> load_bw_image(const std::string& path);
+		template <typename value_t = float>
+		image<color_space_t::BW, value_t> load_bw_image(const std::string& path);
 
 		/// <summary>
 		/// Load grayscale image from file
 		/// </summary>
 		/// <param name="path">Path to image file</param>
 		/// <returns>Grayscale image</returns>
-		image<color_space_t::Gray> load_grayscale_image(const std::string& path);
+		template <typename value_t = float>
+		image<color_space_t::Gray, value_t> load_grayscale_image(const std::string& path);
 
 		/// <summary>
 		/// Load RGB image from file
 		/// </summary>
 		/// <param name="path">Path to image file</param>
 		/// <returns>RGB image</returns>
-		image<color_space_t::RGB> load_rgb_image(const std::string& path);
+		template <typename value_t = float>
+		image<color_space_t::RGB, value_t> load_rgb_image(const std::string& path);
 
 		/// <summary>
 		/// Load RGB image from file and pad alpha channel with 1.0 to get a RGBA image.
 		/// </summary>
 		/// <param name="path">Path to image file</param>
 		/// <returns>RGB image</returns>
-		image<color_space_t::RGBA> load_padded_rgba_image(const std::string& path);
+		template <typename value_t = float>
+		image<color_space_t::RGBA, value_t> load_padded_rgba_image(const std::string& path);
 
 		/// <summary>
 		/// Save black and white image to file
@@ -68,7 +115,8 @@ namespace cg
 		/// <param name="image">Black and white image</param>
 		/// <param name="double_prec">65536 colors instead of 256</param>
 		/// <param name="plain">Plain or binary</param>
-		void save_bw_image(const std::string& path, const image<color_space_t::BW>& image, bool plain = false);
+		template <typename value_t>
+		void save_bw_image(const std::string& path, const image<color_space_t::BW, value_t>& image, bool plain = false);
 
 		/// <summary>
 		/// Save grayscale image to file
@@ -77,7 +125,8 @@ namespace cg
 		/// <param name="image">Grayscale image</param>
 		/// <param name="double_prec">65536 colors instead of 256</param>
 		/// <param name="plain">Plain or binary</param>
-		void save_grayscale_image(const std::string& path, const image<color_space_t::Gray>& image, bool double_prec = false, bool plain = false);
+		template <typename value_t>
+		void save_grayscale_image(const std::string& path, const image<color_space_t::Gray, value_t>& image, bool double_prec = false, bool plain = false);
 
 		/// <summary>
 		/// Save RGB image to file
@@ -86,6 +135,135 @@ namespace cg
 		/// <param name="image">RGB image</param>
 		/// <param name="double_prec">65536 colors instead of 256</param>
 		/// <param name="plain">Plain or binary</param>
-		void save_rgb_image(const std::string& path, const image<color_space_t::RGB>& image, bool double_prec = false, bool plain = false);
+		template <typename value_t>
+		void save_rgb_image(const std::string& path, const image<color_space_t::RGB, value_t>& image, bool double_prec = false, bool plain = false);
+
+		/// <summary>
+		/// Reader for loading an image row by row into bands, i.e., images holding some of its rows,
+		/// so that images larger than the memory can be processed
+		///
+		/// The file is mapped into memory, whose pages the operating system can drop again after they have been read.
+		/// </summary>
+		class row_reader
+		{
+		public:
+			/// <summary>
+			/// Constructor, reading the header
+			/// </summary>
+			/// <param name="path">Path to image file</param>
+			explicit row_reader(const std::string& path);
+
+			/// <summary>
+			/// Get color space of the file: BW for PBM, Gray for PGM and RGB for PPM files
+			/// </summary>
+			/// <returns>Color space</returns>
+			color_space_t get_color_space() const;
+
+			/// <summary>
+			/// Get width or height of the whole image
+			/// </summary>
+			/// <returns>Width / height</returns>
+			unsigned int get_width() const;
+			unsigned int get_height() const;
+
+			/// <summary>
+			/// Get the number of rows read so far, which is the index of the next row
+			/// </summary>
+			/// <returns>Number of rows</returns>
+			unsigned int get_row() const;
+
+			/// <summary>
+			/// Read the next rows into a band with the width of the image, filling it from the given row
+			/// until it is full or the image ends; a RGBA band is padded with an alpha value of 1.0
+			/// </summary>
+			/// <param name="band">Band, whose color space must match the file</param>
+			/// <param name="first">First row of the band to fill</param>
+			/// <returns>Number of rows read</returns>
+			unsigned int read_rows(image<color_space_t::BW>& band, unsigned int first = 0);
+			unsigned int read_rows(image<color_space_t::Gray>& band, unsigned int first = 0);
+			unsigned int read_rows(image<color_space_t::RGB>& band, unsigned int first = 0);
+			unsigned int read_rows(image<color_space_t::RGBA>& band, unsigned int first = 0);
+
+		private:
+			/// <summary>
+			/// Read the next rows into a band
+			/// </summary>
+			/// <param name="band">Band</param>
+			/// <param name="first">First row of the band to fill</param>
+			/// <returns>Number of rows read</returns>
+			template <color_space_t color_space>
+			unsigned int read_band(image<color_space>& band, unsigned int first);
+
+			/// Mapped image; the pixels of plain images are parsed from the current position instead
+			mapped_image m_image;
+			bool m_plain;
+			const unsigned char* m_position;
+			const unsigned char* m_end;
+
+			/// Index of the next row
+			unsigned int m_row;
+		};
+
+		/// <summary>
+		/// Writer for saving an image row by row from bands, i.e., images holding some of its rows
+		/// </summary>
+		class row_writer
+		{
+		public:
+			/// <summary>
+			/// Constructor, writing the header
+			/// </summary>
+			/// <param name="path">Path to image file</param>
+			/// <param name="color_space">Color space: BW for PBM, Gray for PGM and RGB for PPM files</param>
+			/// <param name="width">Width of the whole image</param>
+			/// <param name="height">Height of the whole image</param>
+			/// <param name="double_prec">65536 colors instead of 256</param>
+			/// <param name="plain">Plain or binary</param>
+			row_writer(const std::string& path, color_space_t color_space, unsigned int width, unsigned int height, bool double_prec = false, bool plain = false);
+
+			/// <summary>
+			/// Get the number of rows written so far
+			/// </summary>
+			/// <returns>Number of rows</returns>
+			unsigned int get_row() const;
+
+			/// <summary>
+			/// Append rows of a band with the width of the image
+			/// </summary>
+			/// <param name="band">Band, whose color space must match the file</param>
+			/// <param name="first">First row of the band to write</param>
+			/// <param name="count">Number of rows to write</param>
+			void write_rows(const image<color_space_t::BW>& band, unsigned int first, unsigned int count);
+			void write_rows(const image<color_space_t::Gray>& band, unsigned int first, unsigned int count);
+			void write_rows(const image<color_space_t::RGB>& band, unsigned int first, unsigned int count);
+
+			/// <summary>
+			/// Finish the file after all rows have been written
+			/// </summary>
+			void close();
+
+		private:
+			/// <summary>
+			/// Check whether rows of a band can be appended
+			/// </summary>
+			/// <param name="color_space">Color space of the band</param>
+			/// <param name="band">Band</param>
+			/// <param name="first">First row of the band to write</param>
+			/// <param name="count">Number of rows to write</param>
+			void check_rows(color_space_t color_space, const image_base& band, unsigned int first, unsigned int count) const;
+
+			/// Output file
+			std::ofstream m_stream;
+
+			/// Color space, extents, maximum value and format of the file
+			color_space_t m_color_space;
+			unsigned int m_width;
+			unsigned int m_height;
+			unsigned int m_max_value;
+			bool m_plain;
+
+			/// Number of rows written
+			unsigned int m_row;
+		};
 	}
 }
\ No newline at end of file
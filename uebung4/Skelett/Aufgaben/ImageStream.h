@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Image.h"
+#include "ImageFilter.h"
+#include "ImageIO.h"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <string>
+
+namespace cg
+{
+	/// <summary>
+	/// Namespace and functions for converting and filtering image files band by band, i.e., a few rows at
+	/// a time, so that the memory needed does not depend on the height of the images
+	/// </summary>
+	namespace image_stream
+	{
+		/// Default number of rows per band
+		constexpr unsigned int default_band_rows = 256;
+
+		/// <summary>
+		/// Process an image file band by band and save the results to another file
+		///
+		/// Each band is extended by up to halo rows above and below, if the image has any, so that operations
+		/// accessing neighboring rows produce the same results as for the whole image. Only a band and either
+		/// its result or the up to 2 * halo rows carried over to the next band are kept in memory, i.e., at
+		/// most 2 * (band_rows + 2 * halo) rows of the width of the image.
+		/// </summary>
+		/// <param name="input">Path to the original image file</param>
+		/// <param name="output">Path to the processed image file</param>
+		/// <param name="operation">Function returning the processed band for an original one, with the same extents</param>
+		/// <param name="halo">Number of rows above and below a row that are needed for processing it</param>
+		/// <param name="band_rows">Number of rows saved per band</param>
+		/// <param name="double_prec">65536 colors instead of 256</param>
+		/// <param name="plain">Plain or binary</param>
+		template <color_space_t from, color_space_t to, typename Operation>
+		void process(const std::string& input, const std::string& output, const Operation& operation, unsigned int halo,
+			unsigned int band_rows = default_band_rows, bool double_prec = false, bool plain = false);
+
+		/// <summary>
+		/// Convert an image file band by band, e.g., using the functions of the image converter
+		/// </summary>
+		/// <param name="input">Path to the original image file</param>
+		/// <param name="output">Path to the converted image file</param>
+		/// <param name="conversion">Function converting a band, e.g., image_converter::rgb_to_gray<float></param>
+		/// <param name="band_rows">Number of rows per band</param>
+		/// <param name="double_prec">65536 colors instead of 256</param>
+		/// <param name="plain">Plain or binary</param>
+		template <color_space_t from, color_space_t to, typename Conversion>
+		void convert(const std::string& input, const std::string& output, const Conversion& conversion,
+			unsigned int band_rows = default_band_rows, bool double_prec = false, bool plain = false);
+
+		/// <summary>
+		/// Filter an image file band by band; a band overlaps its neighbors by the vertical extent of the
+		/// kernel, and the border policy must not repeat the image, whose opposite border is not in memory
+		/// </summary>
+		/// <param name="input">Path to the original image file</param>
+		/// <param name="output">Path to the filtered image file</param>
+		/// <param name="filter_kernel">Filter kernel</param>
+		/// <param name="border_policy">Policy for handling out of bounds coordinates</param>
+		/// <param name="band_rows">Number of rows saved per band</param>
+		/// <param name="double_prec">65536 colors instead of 256</param>
+		/// <param name="plain">Plain or binary</param>
+		template <color_space_t color_space>
+		void filter_image(const std::string& input, const std::string& output, const filter::Kernel& filter_kernel,
+			filter::BorderPolicy border_policy = filter::CLAMP_TO_EDGE, unsigned int band_rows = default_band_rows, bool double_prec = false, bool plain = false);
+	}
+}
+
+template <cg::color_space_t from, cg::color_space_t to, typename Operation>
+inline void cg::image_stream::process(const std::string& input, const std::string& output, const Operation& operation, const unsigned int halo,
+	const unsigned int band_rows, const bool double_prec, const bool plain)
+{
+	if (band_rows == 0)
+	{
+		throw std::runtime_error("Bands must have at least one row");
+	}
+
+	image_io::row_reader reader(input);
+	image_io::row_writer writer(output, to, reader.get_width(), reader.get_height(), double_prec, plain);
+
+	const auto width = reader.get_width();
+	const auto height = reader.get_height();
+
+	// Last rows read for the previous band, which are the halo above the next band
+	std::unique_ptr<image<from>> carry;
+
+	for (unsigned int first = 0; first < height; first += std::min(band_rows, height - first))
+	{
+		const auto last = first + std::min(band_rows, height - first);
+		const auto top = first - std::min(halo, first);
+		const auto bottom = last + std::min(halo, height - last);
+
+		image<from> band(width, bottom - top);
+
+		// Rows of the halo above were read for the previous band already
+		const auto kept = (carry != nullptr) ? carry->get_height() : 0;
+
+		if (kept != 0)
+		{
+			std::copy(carry->data(), carry->data() + static_cast<std::size_t>(kept) * width, band.data());
+		}
+
+		carry.reset();
+
+		if (kept + reader.read_rows(band, kept) != band.get_height())
+		{
+			throw std::runtime_error("Unexpected end of file");
+		}
+
+		// The result is released before the carried rows are allocated, so that at most two bands are in memory
+		{
+			const image<to> processed = operation(band);
+
+			if (processed.get_width() != width || processed.get_height() != band.get_height())
+			{
+				throw std::runtime_error("Processing must not change the extents of a band");
+			}
+
+			writer.write_rows(processed, first - top, last - first);
+		}
+
+		// Carry over the rows from the top of the next band's halo on, so that the band can be released
+		const auto next_top = last - std::min(halo, last);
+
+		if (last < height && bottom > next_top)
+		{
+			const auto* source = band.data() + static_cast<std::size_t>(next_top - top) * width;
+
+			carry.reset(new image<from>(width, bottom - next_top));
+			std::copy(source, source + static_cast<std::size_t>(bottom - next_top) * width, carry->data());
+		}
+	}
+
+	writer.close();
+}
+
+template <cg::color_space_t from, cg::color_space_t to, typename Conversion>
+inline void cg::image_stream::convert(const std::string& input, const std::string& output, const Conversion& conversion,
+	const unsigned int band_rows, const bool double_prec, const bool plain)
+{
+	process<from, to>(input, output, conversion, 0, band_rows, double_prec, plain);
+}
+
+template <cg::color_space_t color_space>
+inline void cg::image_stream::filter_image(const std::string& input, const std::string& output, const filter::Kernel& filter_kernel,
+	const filter::BorderPolicy border_policy, const unsigned int band_rows, const bool double_prec, const bool plain)
+{
+	if (border_policy == filter::REPEAT)
+	{
+		throw std::runtime_error("Repeating the image is not supported when filtering band by band");
+	}
+
+	const auto halo = static_cast<unsigned int>(filter_kernel.getVerticalRange().second);
+
+	process<color_space, color_space>(input, output,
+		[&filter_kernel, border_policy](const image<color_space>& band) { return filter::filterImage(band, filter_kernel, border_policy); },
+		halo, band_rows, double_prec, plain);
+}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "Half.h"
+
+#include <cstdint>
+
 namespace cg
 {
 	/// Color space
@@ -8,6 +12,13 @@ namespace cg
 		BW, Gray, RGB, HSV, RGBA
 	};
 
+	/// Memory layout of the color values: interleaved stores the channels of a pixel next to each other,
+	/// planar stores each channel in a plane of its own
+	enum class layout_t
+	{
+		interleaved, planar
+	};
+
 	template <color_space_t color_space>
 	struct color_channels
 	{
@@ -31,4 +42,46 @@ namespace cg
 	{
 		static constexpr unsigned int value = 4;
 	};
+
+	/// <summary>
+	/// Conversion between the stored color values and floats in [0, 1], used for all computations
+	///
+	/// Floats and half floats store the values themselves, while the integer types store them
+	/// scaled to their full range, e.g., 255 for 1.0 with 8 bits.
+	/// </summary>
+	/// <tparam name="value_t">Storage type of the color values</tparam>
+	template <typename value_t>
+	struct value_traits;
+
+	template <>
+	struct value_traits<float>
+	{
+		static float to_float(const float value) { return value; }
+		static float from_float(const float value) { return value; }
+	};
+
+	template <>
+	struct value_traits<half>
+	{
+		static float to_float(const half value) { return static_cast<float>(value); }
+		static half from_float(const float value) { return half(value); }
+	};
+
+	template <>
+	struct value_traits<std::uint8_t>
+	{
+		static constexpr unsigned int max_value = 255;
+
+		static float to_float(const std::uint8_t value) { return static_cast<float>(value) / 255.0f; }
+		static std::uint8_t from_float(const float value) { return static_cast<std::uint8_t>((value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f) * 255.0f + 0.5f); }
+	};
+
+	template <>
+	struct value_traits<std::uint16_t>
+	{
+		static constexpr unsigned int max_value = 65535;
+
+		static float to_float(const std::uint16_t value) { return static_cast<float>(value) / 65535.0f; }
+		static std::uint16_t from_float(const float value) { return static_cast<std::uint16_t>((value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f) * 65535.0f + 0.5f); }
+	};
 }
\ No newline at end of file
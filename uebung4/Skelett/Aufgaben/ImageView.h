@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cg
+{
+	/// <summary>
+	/// View of a single channel of an image, which refers to the color values of the image instead of copying them
+	///
+	/// The values of a row are pixel_step values apart, and rows start row_stride values apart, so that the same
+	/// view describes a channel of an interleaved image (pixel_step is the number of channels) and a plane of a
+	/// planar image (pixel_step is 1). Kernels written for views work with both layouts; the view must not outlive
+	/// its image.
+	/// </summary>
+	/// <tparam name="value_t">Storage type of the color values, const for read-only views</tparam>
+	template <typename value_t>
+	class channel_view
+	{
+	public:
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="data">First value of the channel</param>
+		/// <param name="width">Width</param>
+		/// <param name="height">Height</param>
+		/// <param name="pixel_step">Distance between the values of neighboring pixels in a row</param>
+		/// <param name="row_stride">Distance between the first values of neighboring rows</param>
+		channel_view(value_t* data, unsigned int width, unsigned int height, std::size_t pixel_step, std::size_t row_stride)
+			: m_data(data), m_width(width), m_height(height), m_pixel_step(pixel_step), m_row_stride(row_stride) { }
+
+		/// <summary>
+		/// Get width or height
+		/// </summary>
+		/// <returns>Width / height</returns>
+		unsigned int get_width() const { return m_width; }
+		unsigned int get_height() const { return m_height; }
+
+		/// <summary>
+		/// Get the distance between the values of neighboring pixels, or between the rows
+		/// </summary>
+		/// <returns>Number of values</returns>
+		std::size_t get_pixel_step() const { return m_pixel_step; }
+		std::size_t get_row_stride() const { return m_row_stride; }
+
+		/// <summary>
+		/// Test whether the values of a row are contiguous, so that they can be loaded as vectors
+		/// </summary>
+		/// <returns>True for planes of planar images and for images with a single channel</returns>
+		bool is_contiguous() const { return m_pixel_step == 1; }
+
+		/// <summary>
+		/// Get the first value of a row
+		/// </summary>
+		/// <param name="j">Index in y direction</param>
+		/// <returns>First value</returns>
+		value_t* row(unsigned int j) const { return m_data + j * m_row_stride; }
+
+		/// <summary>
+		/// Access the value of a pixel without bounds checking
+		/// </summary>
+		/// <param name="i">Index in x direction</param>
+		/// <param name="j">Index in y direction</param>
+		/// <returns>Value</returns>
+		value_t& operator()(unsigned int i, unsigned int j) const { return m_data[j * m_row_stride + i * m_pixel_step]; }
+
+		/// <summary>
+		/// Convert to a read-only view
+		/// </summary>
+		operator channel_view<const value_t>() const { return channel_view<const value_t>(m_data, m_width, m_height, m_pixel_step, m_row_stride); }
+
+	private:
+		/// First value, extents and distances between values
+		value_t* m_data;
+		unsigned int m_width;
+		unsigned int m_height;
+		std::size_t m_pixel_step;
+		std::size_t m_row_stride;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "MappedFile.h"
+
+#include <exception>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+cg::mapped_file::mapped_file(const std::string& path) : m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+{
+	this->m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	LARGE_INTEGER size;
+
+	if (this->m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(this->m_file, &size))
+	{
+		release();
+		throw std::runtime_error("Unable to open file");
+	}
+
+	this->m_size = static_cast<std::size_t>(size.QuadPart);
+
+	// Empty files cannot be mapped
+	if (this->m_size != 0)
+	{
+		this->m_mapping = CreateFileMappingA(this->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		this->m_data = (this->m_mapping != nullptr) ? static_cast<const unsigned char*>(MapViewOfFile(this->m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+		if (this->m_data == nullptr)
+		{
+			release();
+			throw std::runtime_error("Unable to map file");
+		}
+	}
+}
+
+cg::mapped_file::~mapped_file()
+{
+	release();
+}
+
+void cg::mapped_file::release() noexcept
+{
+	if (this->m_data != nullptr)
+	{
+		UnmapViewOfFile(this->m_data);
+	}
+
+	if (this->m_mapping != nullptr)
+	{
+		CloseHandle(this->m_mapping);
+	}
+
+	if (this->m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(this->m_file);
+	}
+}
+
+#else
+
+cg::mapped_file::mapped_file(const std::string& path) : m_data(nullptr), m_size(0)
+{
+	const auto file = open(path.c_str(), O_RDONLY);
+
+	struct stat status;
+
+	if (file < 0 || fstat(file, &status) != 0)
+	{
+		if (file >= 0)
+		{
+			close(file);
+		}
+
+		throw std::runtime_error("Unable to open file");
+	}
+
+	this->m_size = static_cast<std::size_t>(status.st_size);
+
+	// Empty files cannot be mapped; the mapping stays valid after closing the file
+	if (this->m_size != 0)
+	{
+		const auto memory = mmap(nullptr, this->m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		if (memory == MAP_FAILED)
+		{
+			close(file);
+			throw std::runtime_error("Unable to map file");
+		}
+
+		// The pixels are read once from front to back
+		madvise(memory, this->m_size, MADV_SEQUENTIAL);
+
+		this->m_data = static_cast<const unsigned char*>(memory);
+	}
+
+	close(file);
+}
+
+cg::mapped_file::~mapped_file()
+{
+	release();
+}
+
+void cg::mapped_file::release() noexcept
+{
+	if (this->m_data != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(this->m_data), this->m_size);
+	}
+}
+
+#endif
+
+const unsigned char* cg::mapped_file::data() const noexcept
+{
+	return this->m_data;
+}
+
+std::size_t cg::mapped_file::size() const noexcept
+{
+	return this->m_size;
+}
\ No newline at end of file
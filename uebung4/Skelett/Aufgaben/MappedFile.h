@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace cg
+{
+	/// <summary>
+	/// Read-only view of a whole file mapped into memory (mmap, or a file mapping on Windows);
+	/// the operating system pages the contents in on access, so nothing is copied into buffers
+	/// </summary>
+	class mapped_file
+	{
+	public:
+		/// <summary>
+		/// Constructor, mapping the file
+		/// </summary>
+		/// <param name="path">Path to file</param>
+		explicit mapped_file(const std::string& path);
+
+		/// <summary>
+		/// Destructor, unmapping the file
+		/// </summary>
+		~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		/// <summary>
+		/// Get the mapped contents, valid as long as the object exists
+		/// </summary>
+		/// <returns>First byte of the file, nullptr for an empty file</returns>
+		const unsigned char* data() const noexcept;
+
+		/// <summary>
+		/// Get the file size
+		/// </summary>
+		/// <returns>Size in bytes</returns>
+		std::size_t size() const noexcept;
+
+	private:
+		/// <summary>
+		/// Unmap the file and close the handles which were opened
+		/// </summary>
+		void release() noexcept;
+
+		/// Mapped contents and their size
+		const unsigned char* m_data;
+		std::size_t m_size;
+
+#ifdef _WIN32
+		/// Handles of the file and of its mapping
+		void* m_file;
+		void* m_mapping;
+#endif
+	};
+}
\ No newline at end of file
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "Image.h"
+#include "ImageView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <new>
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Standard allocator returning memory aligned to the given number of bytes, e.g., for vector loads
+	/// </summary>
+	/// <tparam name="T">Element type</tparam>
+	/// <tparam name="alignment">Alignment in bytes, a power of two</tparam>
+	template <typename T, std::size_t alignment>
+	class aligned_allocator
+	{
+	public:
+		using value_type = T;
+
+		template <typename U>
+		struct rebind
+		{
+			using other = aligned_allocator<U, alignment>;
+		};
+
+		aligned_allocator() = default;
+
+		template <typename U>
+		aligned_allocator(const aligned_allocator<U, alignment>&) { }
+
+		T* allocate(std::size_t count);
+		void deallocate(T* memory, std::size_t count);
+	};
+
+	template <typename T, typename U, std::size_t alignment>
+	bool operator==(const aligned_allocator<T, alignment>&, const aligned_allocator<U, alignment>&) { return true; }
+
+	template <typename T, typename U, std::size_t alignment>
+	bool operator!=(const aligned_allocator<T, alignment>&, const aligned_allocator<U, alignment>&) { return false; }
+
+	/// <summary>
+	/// Image with planar layout, storing each channel in a plane of its own
+	///
+	/// Every plane starts at a multiple of 64 bytes, and its rows are padded to a multiple of 64 bytes as well,
+	/// so that each row starts aligned and can be processed with aligned vector loads and stores up to the
+	/// stride without a scalar remainder. The padding is initialized with zero and is not part of the image.
+	/// </summary>
+	/// <tparam name="color_space">Color space (RGB, HSV, ...)</tparam>
+	/// <tparam name="value_t">Storage type of the color values (float, half, std::uint8_t or std::uint16_t), see value_traits</tparam>
+	template <color_space_t color_space, typename value_t>
+	class image<color_space, value_t, layout_t::planar> : public image_base
+	{
+	public:
+		/// Integer or floating point type for representing the color values
+		using value_type = value_t;
+
+		/// Alignment of planes and rows in bytes
+		static constexpr std::size_t alignment = 64;
+
+		/// Data type for containing all planes of the image
+		using data_type = std::vector<value_type, aligned_allocator<value_type, alignment>>;
+
+		static_assert(alignment % sizeof(value_type) == 0, "Rows must be padded to whole values");
+
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="width">Image width</param>
+		/// <param name="height">Image height</param>
+		image(unsigned int width, unsigned int height);
+
+		/// <summary>
+		/// Get color space
+		/// </summary>
+		/// <returns>Color space used (RGB, HSV, ...)</returns>
+		color_space_t get_color_space() const;
+
+		/// <summary>
+		/// Initialize image with zero-values
+		/// </summary>
+		virtual void initialize();
+
+		/// <summary>
+		/// Initialize all channels of the image with given value
+		/// </summary>
+		/// <param name="initial_value">Initial value</param>
+		void initialize(value_type initial_value);
+
+		/// <summary>
+		/// Get the number of values from the start of a row to the start of the next one, including the padding
+		/// </summary>
+		/// <returns>Row stride</returns>
+		std::size_t get_stride() const;
+
+		/// <summary>
+		/// Get the first value of a plane, or of a row of a plane
+		/// </summary>
+		/// <param name="c">Channel index</param>
+		/// <param name="j">Index in y direction</param>
+		/// <returns>First value, aligned to 64 bytes</returns>
+		value_type* plane(unsigned int c);
+		const value_type* plane(unsigned int c) const;
+
+		value_type* row(unsigned int c, unsigned int j);
+		const value_type* row(unsigned int c, unsigned int j) const;
+
+		/// <summary>
+		/// Get a view of a single channel, which refers to the plane without copying it
+		/// </summary>
+		/// <param name="c">Channel index</param>
+		/// <returns>Channel view</returns>
+		channel_view<value_type> get_channel_view(unsigned int c);
+		channel_view<const value_type> get_channel_view(unsigned int c) const;
+
+		/// <summary>
+		/// Access the value of a channel of a pixel
+		/// </summary>
+		/// <param name="i">Index in x direction</param>
+		/// <param name="j">Index in y direction</param>
+		/// <param name="c">Channel index</param>
+		/// <returns>Value</returns>
+		const value_type& at(unsigned int i, unsigned int j, unsigned int c) const;
+		value_type& at(unsigned int i, unsigned int j, unsigned int c);
+
+		const value_type& operator()(unsigned int i, unsigned int j, unsigned int c) const;
+		value_type& operator()(unsigned int i, unsigned int j, unsigned int c);
+
+	private:
+		/// <summary>
+		/// Calculate the index of the value of a channel of a pixel
+		/// </summary>
+		/// <param name="i">Index in x direction</param>
+		/// <param name="j">Index in y direction</param>
+		/// <param name="c">Channel index</param>
+		/// <returns>Value index</returns>
+		std::size_t index(unsigned int i, unsigned int j, unsigned int c) const;
+
+		/// Row stride in values
+		std::size_t m_stride;
+
+		/// Planes, one after the other
+		data_type m_data;
+	};
+
+	/// Image with planar layout
+	template <color_space_t color_space = color_space_t::RGB, typename value_t = float>
+	using planar_image = image<color_space, value_t, layout_t::planar>;
+}
+
+template <typename T, std::size_t alignment>
+inline T* cg::aligned_allocator<T, alignment>::allocate(const std::size_t count)
+{
+	// Allocate enough memory to align the start, and store the allocated address in front of it
+	auto* memory = static_cast<unsigned char*>(::operator new(count * sizeof(T) + alignment + sizeof(void*)));
+
+	const auto address = reinterpret_cast<std::uintptr_t>(memory + sizeof(void*));
+	auto* aligned = memory + sizeof(void*) + (alignment - address % alignment) % alignment;
+
+	reinterpret_cast<void**>(aligned)[-1] = memory;
+
+	return reinterpret_cast<T*>(aligned);
+}
+
+template <typename T, std::size_t alignment>
+inline void cg::aligned_allocator<T, alignment>::deallocate(T* memory, std::size_t)
+{
+	if (memory != nullptr)
+	{
+		::operator delete(reinterpret_cast<void**>(memory)[-1]);
+	}
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline cg::image<color_space, value_t, cg::layout_t::planar>::image(const unsigned int width, const unsigned int height)
+	: cg::image_base(width, height), m_stride((static_cast<std::size_t>(width) * sizeof(value_t) + alignment - 1) / alignment * alignment / sizeof(value_t))
+{
+	this->m_data.resize(this->m_stride * height * color_channels<color_space>::value);
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline cg::color_space_t cg::image<color_space, value_t, cg::layout_t::planar>::get_color_space() const
+{
+	return color_space;
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline void cg::image<color_space, value_t, cg::layout_t::planar>::initialize()
+{
+	initialize(static_cast<value_type>(0));
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline void cg::image<color_space, value_t, cg::layout_t::planar>::initialize(const value_type initial_value)
+{
+	// Only the pixels are initialized, the padding stays zero
+	for (unsigned int c = 0; c < color_channels<color_space>::value; ++c)
+	{
+		for (unsigned int j = 0; j < this->height; ++j)
+		{
+			auto* values = row(c, j);
+
+			for (unsigned int i = 0; i < this->width; ++i)
+			{
+				values[i] = initial_value;
+			}
+		}
+	}
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline std::size_t cg::image<color_space, value_t, cg::layout_t::planar>::get_stride() const
+{
+	return this->m_stride;
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type* cg::image<color_space, value_t, cg::layout_t::planar>::plane(const unsigned int c)
+{
+	return this->m_data.data() + this->m_stride * this->height * c;
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline const typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type* cg::image<color_space, value_t, cg::layout_t::planar>::plane(const unsigned int c) const
+{
+	return this->m_data.data() + this->m_stride * this->height * c;
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type* cg::image<color_space, value_t, cg::layout_t::planar>::row(const unsigned int c, const unsigned int j)
+{
+	return plane(c) + this->m_stride * j;
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline const typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type* cg::image<color_space, value_t, cg::layout_t::planar>::row(const unsigned int c, const unsigned int j) const
+{
+	return plane(c) + this->m_stride * j;
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline cg::channel_view<value_t> cg::image<color_space, value_t, cg::layout_t::planar>::get_channel_view(const unsigned int c)
+{
+	if (c >= color_channels<color_space>::value)
+	{
+		throw std::runtime_error("Illegal channel");
+	}
+
+	return channel_view<value_t>(plane(c), this->width, this->height, 1, this->m_stride);
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline cg::channel_view<const value_t> cg::image<color_space, value_t, cg::layout_t::planar>::get_channel_view(const unsigned int c) const
+{
+	if (c >= color_channels<color_space>::value)
+	{
+		throw std::runtime_error("Illegal channel");
+	}
+
+	return channel_view<const value_t>(plane(c), this->width, this->height, 1, this->m_stride);
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline const typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type& cg::image<color_space, value_t, cg::layout_t::planar>::at(const unsigned int i, const unsigned int j, const unsigned int c) const
+{
+	return this->m_data[index(i, j, c)];
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type& cg::image<color_space, value_t, cg::layout_t::planar>::at(const unsigned int i, const unsigned int j, const unsigned int c)
+{
+	return this->m_data[index(i, j, c)];
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline const typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type& cg::image<color_space, value_t, cg::layout_t::planar>::operator()(const unsigned int i, const unsigned int j, const unsigned int c) const
+{
+	return at(i, j, c);
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline typename cg::image<color_space, value_t, cg::layout_t::planar>::value_type& cg::image<color_space, value_t, cg::layout_t::planar>::operator()(const unsigned int i, const unsigned int j, const unsigned int c)
+{
+	return at(i, j, c);
+}
+
+template <cg::color_space_t color_space, typename value_t>
+inline std::size_t cg::image<color_space, value_t, cg::layout_t::planar>::index(const unsigned int i, const unsigned int j, const unsigned int c) const
+{
+	if (i >= this->width || j >= this->height || c >= color_channels<color_space>::value)
+	{
+		throw std::runtime_error("Illegal pixel");
+	}
+
+	return this->m_stride * (this->height * static_cast<std::size_t>(c) + j) + i;
+}
\ No newline at end of file
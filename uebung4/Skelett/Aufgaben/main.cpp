@@ -1,9 +1,27 @@
+#include "ConverterBenchmark.h"
 #include "ImageViewer.h"
 
+#include <string>
+
 int main(const int argc, const char** argv)
 {
 	std::cout << "Uni Stuttgart - CG Exercise 4 - WS17/18" << std::endl;
 
+	// Measure the color space conversions instead of showing the viewer: --benchmark [image.ppm]
+	if (argc > 1 && std::string(argv[1]) == "--benchmark")
+	{
+		if (argc > 2)
+		{
+			cg::converter_benchmark::run(std::cout, argv[2]);
+		}
+		else
+		{
+			cg::converter_benchmark::run(std::cout);
+		}
+
+		return 0;
+	}
+
 	cg::ImageViewer image_viewer;
 	image_viewer.run();
 
@@ -0,0 +1,777 @@
+#include "Clipping.h"
+#include "Math.h"
+#include "PointCloud.h"
+#include "Rasterizer.h"
+#include "Scenes.h"
+#include "Simd.h"
+#include "VertexTransform.h"
+
+#include "Scene/Camera.h"
+#include "Scene/Lights/AmbientLight.h"
+#include "Scene/Lights/PointLight.h"
+#include "Scene/Objects/Container.h"
+#include "Scene/Objects/Cube.h"
+#include "Scene/Objects/Sphere.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	/// <summary>
+	/// Result of a single benchmark
+	/// </summary>
+	struct Result
+	{
+		std::string name;
+		std::string kind;
+
+		/// Parameters describing the benchmark, e.g., scene size or resolution, as JSON members
+		std::vector<std::pair<std::string, std::string>> parameters;
+
+		/// Number of measured iterations, and operations (e.g., function calls) per iteration
+		unsigned long long iterations;
+		unsigned long long operations;
+
+		/// Time per iteration in nanoseconds
+		double mean, median, min;
+
+		/// Additional rates, e.g., triangles or fragments per second, as JSON members
+		std::vector<std::pair<std::string, double>> rates;
+	};
+
+	/// <summary>
+	/// Options of the benchmark runner
+	/// </summary>
+	struct Options
+	{
+		std::string filter;
+		std::string output;
+		double minTime = 0.2;
+		unsigned int minIterations = 3;
+	};
+
+	/// <summary>
+	/// Prevent the compiler from optimizing away a benchmarked computation
+	/// </summary>
+	volatile float sink;
+
+	/// <summary>
+	/// Run a function repeatedly for at least the minimum time and number of iterations, after one warm-up run
+	/// </summary>
+	/// <param name="options">Options</param>
+	/// <param name="function">Function running one iteration</param>
+	/// <param name="result">Result to store the iteration count and timings in</param>
+	void measure(const Options& options, const std::function<void()>& function, Result& result)
+	{
+		function();
+
+		std::vector<double> times;
+		double total = 0.0;
+
+		while (times.size() < options.minIterations || total < options.minTime * 1e9)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+
+			function();
+
+			const auto time = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+			times.push_back(time);
+			total += time;
+		}
+
+		std::sort(times.begin(), times.end());
+
+		result.iterations = times.size();
+		result.mean = total / times.size();
+		result.median = times[times.size() / 2];
+		result.min = times.front();
+	}
+
+	/// <summary>
+	/// Collects the results of all benchmarks matching the filter
+	/// </summary>
+	class Runner
+	{
+	public:
+		Runner(const Options& options) : options(options) { }
+
+		/// <summary>
+		/// Run a benchmark if its name matches the filter
+		/// </summary>
+		/// <param name="name">Name</param>
+		/// <param name="kind">"micro", "macro" or "scaling"</param>
+		/// <param name="parameters">Parameters as JSON members</param>
+		/// <param name="operations">Operations per iteration</param>
+		/// <param name="function">Function running one iteration</param>
+		/// <returns>Pointer to the result for adding rates, or null if skipped</returns>
+		Result* run(const std::string& name, const std::string& kind, const std::vector<std::pair<std::string, std::string>>& parameters,
+			const unsigned long long operations, const std::function<void()>& function)
+		{
+			if (name.find(this->options.filter) == std::string::npos)
+			{
+				return nullptr;
+			}
+
+			std::cerr << name << "... " << std::flush;
+
+			Result result;
+			result.name = name;
+			result.kind = kind;
+			result.parameters = parameters;
+			result.operations = operations;
+
+			measure(this->options, function, result);
+
+			std::cerr << result.median / 1e6 << " ms" << std::endl;
+
+			this->results.push_back(result);
+
+			return &this->results.back();
+		}
+
+		/// <summary>
+		/// Write all results as JSON
+		/// </summary>
+		/// <param name="stream">Output stream</param>
+		void write(std::ostream& stream) const
+		{
+			char date[32];
+			const auto now = std::time(nullptr);
+			std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+			stream.precision(10);
+
+			stream << "{" << std::endl
+				<< "  \"context\": {" << std::endl
+				<< "    \"date\": \"" << date << "\"," << std::endl
+				<< "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << "," << std::endl
+				<< "    \"simd_width\": " << cg::simd::float_v::size << "," << std::endl
+				<< "    \"min_time_s\": " << this->options.minTime << std::endl
+				<< "  }," << std::endl
+				<< "  \"benchmarks\": [" << std::endl;
+
+			for (std::size_t i = 0; i < this->results.size(); ++i)
+			{
+				const auto& result = this->results[i];
+
+				stream << "    {" << std::endl
+					<< "      \"name\": \"" << result.name << "\"," << std::endl
+					<< "      \"kind\": \"" << result.kind << "\"," << std::endl;
+
+				for (const auto& parameter : result.parameters)
+				{
+					stream << "      \"" << parameter.first << "\": " << parameter.second << "," << std::endl;
+				}
+
+				stream << "      \"iterations\": " << result.iterations << "," << std::endl
+					<< "      \"operations_per_iteration\": " << result.operations << "," << std::endl
+					<< "      \"mean_ns\": " << result.mean << "," << std::endl
+					<< "      \"median_ns\": " << result.median << "," << std::endl
+					<< "      \"min_ns\": " << result.min << "," << std::endl
+					<< "      \"ns_per_operation\": " << result.median / result.operations;
+
+				for (const auto& rate : result.rates)
+				{
+					stream << "," << std::endl << "      \"" << rate.first << "\": " << rate.second;
+				}
+
+				stream << std::endl << "    }" << ((i + 1 < this->results.size()) ? "," : "") << std::endl;
+			}
+
+			stream << "  ]" << std::endl << "}" << std::endl;
+		}
+
+	private:
+		Options options;
+		std::vector<Result> results;
+	};
+
+	/// <summary>
+	/// Format a value as JSON string
+	/// </summary>
+	std::string quote(const std::string& value)
+	{
+		return "\"" + value + "\"";
+	}
+
+	/// <summary>
+	/// Add point lights on a circle in front of the camera, and an ambient light
+	/// </summary>
+	/// <param name="scene">Scene</param>
+	/// <param name="lights">Number of point lights</param>
+	void addLights(cg::Scene& scene, const unsigned int lights)
+	{
+		for (unsigned int i = 0; i < lights; ++i)
+		{
+			const auto angle = 2.0f * cg::pi() * static_cast<float>(i) / static_cast<float>(lights);
+
+			auto pointLight = std::make_shared<cg::PointLight>(cg::Color(1.0f, 1.0f, 1.0f, 1.0f), 10.0f / lights);
+			pointLight->Translate(cg::vec3(4.0f * std::cos(angle), 2.0f * std::sin(angle), 1.0f));
+			scene.addLight(pointLight);
+		}
+
+		scene.addLight(std::make_shared<cg::AmbientLight>(cg::Color(1.0f, 1.0f, 1.0f, 1.0f), 0.2f));
+	}
+
+	/// <summary>
+	/// Position of the i-th of n objects arranged in a grid filling the view
+	/// </summary>
+	/// <param name="i">Object index</param>
+	/// <param name="n">Number of objects</param>
+	/// <param name="size">Returns the grid cell size</param>
+	/// <returns>Position</returns>
+	cg::vec3 gridPosition(const unsigned int i, const unsigned int n, float& size)
+	{
+		const auto columns = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(n) * 16.0f / 9.0f)));
+		const auto rows = (n + columns - 1) / columns;
+
+		size = 8.0f / columns;
+
+		return cg::vec3(-4.0f + size * (0.5f + i % columns), 2.5f - 5.0f / rows * (0.5f + i / columns), 6.0f);
+	}
+
+	/// <summary>
+	/// Create a scene of spheres arranged in a grid
+	/// </summary>
+	/// <param name="spheres">Number of spheres</param>
+	/// <param name="resolution">Number of rings; each ring consists of twice as many segments</param>
+	/// <param name="lights">Number of point lights</param>
+	/// <returns>Scene</returns>
+	cg::Scene createSphereGrid(const unsigned int spheres, const unsigned int resolution, const unsigned int lights)
+	{
+		cg::Scene scene("Spheres");
+
+		for (unsigned int i = 0; i < spheres; ++i)
+		{
+			float size;
+			const auto position = gridPosition(i, spheres, size);
+
+			auto sphere = std::make_shared<cg::Sphere>(0.45f * size, resolution, 2 * resolution, cg::Color(1.0f, 0.5f + 0.5f * (i % 2), 0.5f, 1.0f));
+			sphere->Translate(position);
+			scene.addObject(sphere);
+		}
+
+		addLights(scene, lights);
+
+		return scene;
+	}
+
+	/// <summary>
+	/// Create a scene of containers arranged in a grid, each consisting of a cube and two spheres
+	/// </summary>
+	/// <param name="containers">Number of containers</param>
+	/// <param name="lights">Number of point lights</param>
+	/// <returns>Scene</returns>
+	cg::Scene createContainerGrid(const unsigned int containers, const unsigned int lights)
+	{
+		cg::Scene scene("Containers");
+
+		for (unsigned int i = 0; i < containers; ++i)
+		{
+			float size;
+			const auto position = gridPosition(i, containers, size);
+
+			auto cube = std::make_shared<cg::Cube>(0.25f, cg::Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+			auto sphere1 = std::make_shared<cg::Sphere>(0.125f, 10, 20, cg::Color(1.0f, 1.0f, 0.0f, 1.0f));
+			sphere1->Translate(cg::vec3(-0.25f, 0.0f, 0.0f));
+
+			auto sphere2 = std::make_shared<cg::Sphere>(0.125f, 25, 50, cg::Color(0.0f, 1.0f, 1.0f, 1.0f));
+			sphere2->Translate(cg::vec3(0.25f, 0.0f, 0.0f));
+
+			auto container = std::make_shared<cg::Container>();
+			container->addObject(cube);
+			container->addObject(sphere1);
+			container->addObject(sphere2);
+
+			container->Translate(position);
+			container->Scale(cg::vec3(size, size, size));
+			container->Rotate(15.0f * i, 30.0f * i, 0.0f);
+
+			scene.addObject(container);
+		}
+
+		addLights(scene, lights);
+
+		return scene;
+	}
+
+	/// <summary>
+	/// Name of a rasterization mode
+	/// </summary>
+	std::string modeName(const cg::Rasterizer::rasterization_mode mode)
+	{
+		switch (mode)
+		{
+		case cg::Rasterizer::POINTS:
+			return "points";
+		case cg::Rasterizer::WIREFRAME:
+			return "wireframe";
+		case cg::Rasterizer::FILLED:
+			return "filled";
+		case cg::Rasterizer::BINNED:
+			return "binned";
+		default:
+			return "deferred";
+		}
+	}
+
+	/// <summary>
+	/// Benchmark rendering a scene, adding the drawn triangles and written fragments per second
+	/// </summary>
+	/// <param name="runner">Benchmark runner</param>
+	/// <param name="name">Benchmark name, without mode and resolution</param>
+	/// <param name="kind">"micro", "macro" or "scaling"</param>
+	/// <param name="parameters">Scene parameters</param>
+	/// <param name="scene">Scene</param>
+	/// <param name="mode">Rasterization mode</param>
+	/// <param name="width">Image width</param>
+	/// <param name="height">Image height</param>
+	/// <param name="levelOfDetail">Tessellate spheres depending on their size on screen instead of their resolution?</param>
+	/// <param name="threads">Number of threads, 0 for one per hardware thread; other values are appended to the name</param>
+	/// <returns>Pointer to the result, or null if skipped</returns>
+	Result* benchmarkScene(Runner& runner, const std::string& name, const std::string& kind, std::vector<std::pair<std::string, std::string>> parameters,
+		const cg::Scene& scene, const cg::Rasterizer::rasterization_mode mode, const unsigned int width, const unsigned int height,
+		const bool levelOfDetail = false, const unsigned int threads = 0)
+	{
+		auto fullName = name + "/" + modeName(mode) + "/" + std::to_string(width) + "x" + std::to_string(height);
+
+		if (threads != 0)
+		{
+			fullName += "/threads/" + std::to_string(threads);
+		}
+
+		parameters.push_back(std::make_pair("mode", quote(modeName(mode))));
+		parameters.push_back(std::make_pair("width", std::to_string(width)));
+		parameters.push_back(std::make_pair("height", std::to_string(height)));
+		parameters.push_back(std::make_pair("level_of_detail", levelOfDetail ? "true" : "false"));
+		parameters.push_back(std::make_pair("threads", std::to_string(threads)));
+
+		cg::Rasterizer rasterizer(cg::defaultCamera(), std::vector<cg::Scene>{ scene }, mode, width, height);
+		rasterizer.accessLevelOfDetail() = levelOfDetail;
+		rasterizer.accessThreadCount() = threads;
+
+		auto* result = runner.run(fullName, kind, parameters, 1, [&rasterizer]() { rasterizer.draw(false); });
+
+		if (result != nullptr)
+		{
+			const auto& statistics = rasterizer.getStatistics();
+
+			result->rates.push_back(std::make_pair("triangles_per_frame", static_cast<double>(statistics.drawnTriangles)));
+			result->rates.push_back(std::make_pair("fragments_per_frame", static_cast<double>(statistics.fragments)));
+			result->rates.push_back(std::make_pair("triangles_per_second", statistics.drawnTriangles / (result->median * 1e-9)));
+			result->rates.push_back(std::make_pair("fragments_per_second", statistics.fragments / (result->median * 1e-9)));
+
+			// The last frame repeats the ones before, so it should not have allocated any memory
+			result->rates.push_back(std::make_pair("heap_allocations_per_frame", static_cast<double>(statistics.heapAllocations)));
+		}
+
+		return result;
+	}
+
+	/// <summary>
+	/// Micro benchmarks of single functions and of single frames of the default scenes
+	/// </summary>
+	/// <param name="runner">Benchmark runner</param>
+	void runMicroBenchmarks(Runner& runner)
+	{
+		// Mesh calculation of spheres with different resolutions
+		for (const auto resolution : { 10u, 25u, 100u })
+		{
+			const cg::Sphere sphere(1.0f, resolution, 2 * resolution);
+			const std::vector<std::pair<std::string, std::string>> parameters = {
+				std::make_pair("teta_resolution", std::to_string(resolution)), std::make_pair("phi_resolution", std::to_string(2 * resolution)) };
+			const auto suffix = "/" + std::to_string(resolution) + "x" + std::to_string(2 * resolution);
+
+			runner.run("micro/sphere/calculateMesh" + suffix, "micro", parameters, 1,
+				[&sphere]() { sink = sphere.calculateMesh().back().points[0].position.x; });
+			runner.run("micro/sphere/calculateIndexedMesh" + suffix, "micro", parameters, 1,
+				[&sphere]() { sink = sphere.calculateIndexedMesh().vertices.back().position.x; });
+		}
+
+		// Mesh calculation of containers with different numbers of children
+		for (const auto children : { 1u, 8u, 64u })
+		{
+			cg::Container container;
+
+			for (unsigned int i = 0; i < children; ++i)
+			{
+				auto sphere = std::make_shared<cg::Sphere>(0.1f);
+				sphere->Translate(cg::vec3(0.2f * i, 0.0f, 0.0f));
+				container.addObject(sphere);
+			}
+
+			const std::vector<std::pair<std::string, std::string>> parameters = { std::make_pair("children", std::to_string(children)) };
+			const auto suffix = "/" + std::to_string(children);
+
+			runner.run("micro/container/calculateMesh" + suffix, "micro", parameters, 1,
+				[&container]() { sink = container.calculateMesh().back().points[0].position.x; });
+			runner.run("micro/container/calculateIndexedMesh" + suffix, "micro", parameters, 1,
+				[&container]() { sink = container.calculateIndexedMesh().vertices.back().position.x; });
+		}
+
+		// Triangle functions for random points within the bounding box of a triangle
+		{
+			cg::Triangle2D triangle;
+			triangle.points[0].position = cg::Point2D(10.0f, 10.0f);
+			triangle.points[1].position = cg::Point2D(200.0f, 40.0f);
+			triangle.points[2].position = cg::Point2D(60.0f, 180.0f);
+			triangle.points[0].color = cg::red();
+			triangle.points[1].color = cg::green();
+			triangle.points[2].color = cg::blue();
+
+			constexpr unsigned int numPoints = 4096;
+
+			std::mt19937 generator(42);
+			std::uniform_real_distribution<float> distribution_x(10.0f, 200.0f), distribution_y(10.0f, 180.0f);
+			std::vector<cg::Point2D> points(numPoints);
+
+			for (auto& point : points)
+			{
+				point = cg::Point2D(distribution_x(generator), distribution_y(generator));
+			}
+
+			runner.run("micro/pointInTriangle", "micro", {}, numPoints, [&]()
+			{
+				unsigned int inside = 0;
+
+				for (const auto& point : points)
+				{
+					inside += cg::pointInTriangle(triangle, point) ? 1 : 0;
+				}
+
+				sink = static_cast<float>(inside);
+			});
+
+			runner.run("micro/calculateBarycentricCoords", "micro", {}, numPoints, [&]()
+			{
+				auto sum = 0.0f;
+
+				for (const auto& point : points)
+				{
+					sum += cg::calculateBarycentricCoords(triangle, point).x;
+				}
+
+				sink = sum;
+			});
+		}
+
+		// Transforming random vertices to world, clip and screen space and classifying them against the clip planes,
+		// once per vertex with two matrix products as before, and in SIMD batches with the combined matrix
+		{
+			constexpr unsigned int numVertices = 1 << 20;
+
+			std::mt19937 generator(42);
+			std::uniform_real_distribution<float> coordinate(-4.0f, 4.0f);
+
+			std::array<std::vector<float>, 3> positions;
+
+			for (auto& component : positions)
+			{
+				component.resize(numVertices);
+
+				for (auto& value : component)
+				{
+					value = coordinate(generator);
+				}
+			}
+
+			const auto camera = cg::defaultCamera();
+			const auto model = glm::rotate(cg::mat4(1.0f), 30.0f, cg::vec3(0.0f, 1.0f, 0.0f));
+			const auto viewProjection = camera.getViewProjection();
+
+			const std::vector<std::pair<std::string, std::string>> parameters = { std::make_pair("vertices", std::to_string(numVertices)) };
+
+			auto* scalar = runner.run("micro/vertices/transform/scalar", "micro", parameters, numVertices, [&]()
+			{
+				auto sum = 0.0f;
+				unsigned int outcodes = 0;
+
+				for (unsigned int i = 0; i < numVertices; ++i)
+				{
+					const auto world = model * cg::vec4(positions[0][i], positions[1][i], positions[2][i], 1.0f);
+					const auto clip = viewProjection * world;
+
+					sum += world.x + (clip.x / clip.w * 0.5f + 0.5f) * 1600.0f + (clip.y / clip.w * -0.5f + 0.5f) * 900.0f + clip.z / clip.w;
+					outcodes |= cg::computeOutcode(clip, cg::Rasterizer::guardBand);
+				}
+
+				sink = sum + static_cast<float>(outcodes);
+			});
+
+			cg::VertexTransform transform;
+			cg::setupVertexTransform(model, viewProjection, 1600.0f, 900.0f, cg::Rasterizer::guardBand, transform);
+
+			auto* batched = runner.run("micro/vertices/transform/simd", "micro", parameters, numVertices, [&]()
+			{
+				auto sum = cg::simd::float_v(0.0f);
+				unsigned int outcodes = 0;
+
+				for (unsigned int i = 0; i < numVertices; i += cg::simd::float_v::size)
+				{
+					cg::VertexBatch batch;
+					cg::transformVertices(transform,
+						{ cg::simd::float_v::load(&positions[0][i]), cg::simd::float_v::load(&positions[1][i]), cg::simd::float_v::load(&positions[2][i]) },
+						batch);
+
+					sum = sum + batch.world[0] + batch.screen[0] + batch.screen[1] + batch.screen[2];
+					outcodes |= batch.outcodes[0] | batch.validXY;
+				}
+
+				alignas(32) std::array<float, cg::simd::float_v::size> lanes;
+				sum.store(lanes.data());
+
+				sink = lanes[0] + static_cast<float>(outcodes);
+			});
+
+			for (auto* result : { scalar, batched })
+			{
+				if (result != nullptr)
+				{
+					result->rates.push_back(std::make_pair("vertices_per_second", numVertices / (result->median * 1e-9)));
+				}
+			}
+		}
+
+		// Splatting random point clouds in front of the camera, including the resolve of the image
+		cg::JobSystem jobs;
+
+		for (const auto numPoints : { 1000000u, 10000000u })
+		{
+			std::mt19937 generator(42);
+			std::uniform_real_distribution<float> lateral(-2.0f, 2.0f), depth(3.0f, 6.0f), channel(0.0f, 1.0f);
+
+			cg::PointCloud cloud;
+
+			for (unsigned int i = 0; i < numPoints; ++i)
+			{
+				cloud.addPoint(cg::Point3D(lateral(generator), lateral(generator), depth(generator)),
+					cg::Color(channel(generator), channel(generator), channel(generator), 1.0f));
+			}
+
+			auto camera = cg::defaultCamera();
+			camera.setAspect(1280.0f / 720.0f);
+
+			cg::point_buffer buffer(1280, 720);
+			cg::image<cg::color_space_t::RGBA> image(1280, 720);
+
+			auto* result = runner.run("micro/points/splat/" + std::to_string(numPoints), "micro",
+				{ std::make_pair("points", std::to_string(numPoints)) }, numPoints, [&]()
+				{
+					cg::splatPointCloud(cloud, camera.getViewProjection(), buffer, jobs);
+					buffer.resolve(image, { 0.0f, 0.0f, 0.0f, 0.0f });
+				});
+
+			if (result != nullptr)
+			{
+				result->rates.push_back(std::make_pair("points_per_second", numPoints / (result->median * 1e-9)));
+			}
+		}
+
+		// Single frames of the default scenes
+		const auto scenes = cg::createScenes();
+
+		for (int index = 0; index < 4; ++index)
+		{
+			for (const auto mode : { cg::Rasterizer::POINTS, cg::Rasterizer::WIREFRAME, cg::Rasterizer::FILLED, cg::Rasterizer::BINNED, cg::Rasterizer::DEFERRED })
+			{
+				benchmarkScene(runner, "micro/rasterizer/scene" + std::to_string(index), "micro",
+					{ std::make_pair("scene", quote(scenes[index].getName())) }, scenes[index], mode, 1600, 900);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Macro benchmarks rendering parametric scenes
+	/// </summary>
+	/// <param name="runner">Benchmark runner</param>
+	void runMacroBenchmarks(Runner& runner)
+	{
+		const auto modes = { cg::Rasterizer::FILLED, cg::Rasterizer::BINNED, cg::Rasterizer::DEFERRED };
+
+		// Number of spheres and their resolution
+		for (const auto spheres : { 16u, 128u })
+		{
+			for (const auto resolution : { 10u, 50u })
+			{
+				const auto scene = createSphereGrid(spheres, resolution, 2);
+
+				for (const auto mode : modes)
+				{
+					benchmarkScene(runner, "macro/spheres/" + std::to_string(spheres) + "/" + std::to_string(resolution) + "/2", "macro",
+						{ std::make_pair("spheres", std::to_string(spheres)), std::make_pair("resolution", std::to_string(resolution)), std::make_pair("lights", "2") },
+						scene, mode, 1280, 720);
+				}
+			}
+		}
+
+		// Number of spheres with their tessellation selected by their size on screen
+		for (const auto spheres : { 16u, 128u })
+		{
+			const auto scene = createSphereGrid(spheres, 50, 2);
+
+			for (const auto mode : modes)
+			{
+				benchmarkScene(runner, "macro/spheres/" + std::to_string(spheres) + "/lod/2", "macro",
+					{ std::make_pair("spheres", std::to_string(spheres)), std::make_pair("resolution", quote("lod")), std::make_pair("lights", "2") },
+					scene, mode, 1280, 720, true);
+			}
+		}
+
+		// Number of containers
+		for (const auto containers : { 16u, 64u })
+		{
+			const auto scene = createContainerGrid(containers, 2);
+
+			for (const auto mode : modes)
+			{
+				benchmarkScene(runner, "macro/containers/" + std::to_string(containers) + "/2", "macro",
+					{ std::make_pair("containers", std::to_string(containers)), std::make_pair("lights", "2") }, scene, mode, 1280, 720);
+			}
+		}
+
+		// Number of point lights
+		for (const auto lights : { 1u, 8u, 32u })
+		{
+			const auto scene = createSphereGrid(16, 25, lights);
+
+			for (const auto mode : modes)
+			{
+				benchmarkScene(runner, "macro/lights/16/25/" + std::to_string(lights), "macro",
+					{ std::make_pair("spheres", "16"), std::make_pair("resolution", "25"), std::make_pair("lights", std::to_string(lights)) },
+					scene, mode, 1280, 720);
+			}
+		}
+
+		// Image resolution
+		{
+			const auto scene = createContainerGrid(16, 2);
+
+			for (const auto& size : { std::make_pair(640u, 360u), std::make_pair(1920u, 1080u), std::make_pair(3840u, 2160u) })
+			{
+				for (const auto mode : modes)
+				{
+					benchmarkScene(runner, "macro/resolution/16/2", "macro",
+						{ std::make_pair("containers", "16"), std::make_pair("lights", "2") }, scene, mode, size.first, size.second);
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Scaling benchmarks rendering the same scenes with one thread up to one thread per hardware thread,
+	/// reporting speedup and parallel efficiency relative to a single thread
+	/// </summary>
+	/// <param name="runner">Benchmark runner</param>
+	void runScalingBenchmarks(Runner& runner)
+	{
+		const auto maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+		std::vector<unsigned int> threadCounts;
+
+		for (unsigned int threads = 1; threads < maxThreads; threads *= 2)
+		{
+			threadCounts.push_back(threads);
+		}
+
+		threadCounts.push_back(maxThreads);
+
+		// Many small objects, few large ones, and a single triangle, which leaves all but one thread idle
+		const std::vector<std::pair<std::string, cg::Scene>> scenes = {
+			std::make_pair("scaling/spheres/128/10/2", createSphereGrid(128, 10, 2)),
+			std::make_pair("scaling/containers/16/2", createContainerGrid(16, 2)),
+			std::make_pair("scaling/triangle", cg::createTriangle()) };
+
+		for (const auto& scene : scenes)
+		{
+			for (const auto mode : { cg::Rasterizer::FILLED, cg::Rasterizer::BINNED, cg::Rasterizer::DEFERRED })
+			{
+				auto single = 0.0;
+
+				for (const auto threads : threadCounts)
+				{
+					auto* result = benchmarkScene(runner, scene.first, "scaling", {}, scene.second, mode, 1280, 720, false, threads);
+
+					if (result == nullptr)
+					{
+						continue;
+					}
+
+					single = (threads == 1) ? result->median : single;
+
+					if (single != 0.0)
+					{
+						const auto speedup = single / result->median;
+
+						result->rates.push_back(std::make_pair("speedup", speedup));
+						result->rates.push_back(std::make_pair("efficiency", speedup / threads));
+
+						std::cerr << "  " << threads << " threads: speedup " << speedup << ", efficiency " << speedup / threads << std::endl;
+					}
+				}
+			}
+		}
+	}
+}
+
+int main(const int argc, const char** argv)
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string argument(argv[i]);
+
+		if (argument == "--filter" && i + 1 < argc)
+		{
+			options.filter = argv[++i];
+		}
+		else if (argument == "--output" && i + 1 < argc)
+		{
+			options.output = argv[++i];
+		}
+		else if (argument == "--min-time" && i + 1 < argc)
+		{
+			options.minTime = std::stod(argv[++i]);
+		}
+		else
+		{
+			std::cerr << "Usage: Benchmarks [--filter <substring>] [--output <file.json>] [--min-time <seconds>]" << std::endl;
+
+			return 1;
+		}
+	}
+
+	Runner runner(options);
+
+	runMicroBenchmarks(runner);
+	runMacroBenchmarks(runner);
+	runScalingBenchmarks(runner);
+
+	if (options.output.empty())
+	{
+		runner.write(std::cout);
+	}
+	else
+	{
+		std::ofstream stream(options.output);
+		runner.write(stream);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "Clipping.h"
+
+namespace
+{
+	/// <summary>
+	/// Signed distance to a clip plane, non-negative inside
+	/// </summary>
+	float planeDistance(const cg::vec4& position, const unsigned int plane, const float guardBand)
+	{
+		switch (plane)
+		{
+		case cg::CLIP_NEAR:
+			return position.z + position.w;
+		case cg::CLIP_FAR:
+			return position.w - position.z;
+		case cg::CLIP_LEFT:
+			return position.x + guardBand * position.w;
+		case cg::CLIP_RIGHT:
+			return guardBand * position.w - position.x;
+		case cg::CLIP_BOTTOM:
+			return position.y + guardBand * position.w;
+		default:
+			return guardBand * position.w - position.y;
+		}
+	}
+
+	/// <summary>
+	/// Interpolate position and attributes between two vertices
+	/// </summary>
+	cg::ClipVertex interpolate(const cg::ClipVertex& start, const cg::ClipVertex& end, const float t)
+	{
+		cg::ClipVertex vertex;
+
+		vertex.position = start.position + t * (end.position - start.position);
+		vertex.attributes.position = start.attributes.position + t * (end.attributes.position - start.attributes.position);
+		vertex.attributes.normal = start.attributes.normal + t * (end.attributes.normal - start.attributes.normal);
+		vertex.attributes.color = start.attributes.color + t * (end.attributes.color - start.attributes.color);
+
+		return vertex;
+	}
+}
+
+unsigned int cg::computeOutcode(const vec4& position, const float guardBand)
+{
+	unsigned int outcode = 0;
+
+	for (unsigned int plane = CLIP_NEAR; plane <= CLIP_TOP; plane <<= 1)
+	{
+		if (planeDistance(position, plane, guardBand) < 0.0f)
+		{
+			outcode |= plane;
+		}
+	}
+
+	return outcode;
+}
+
+void cg::clipTriangle(const std::array<ClipVertex, 3>& triangle, const unsigned int planes, const float guardBand, ClipPolygon& polygon)
+{
+	polygon.vertices[0] = triangle[0];
+	polygon.vertices[1] = triangle[1];
+	polygon.vertices[2] = triangle[2];
+	polygon.size = 3;
+
+	ClipPolygon input;
+
+	for (unsigned int plane = CLIP_NEAR; plane <= CLIP_TOP && polygon.size != 0; plane <<= 1)
+	{
+		if ((planes & plane) == 0)
+		{
+			continue;
+		}
+
+		input = polygon;
+		polygon.size = 0;
+
+		// Keep inside vertices, and add the intersection of each edge crossing the plane
+		for (unsigned int i = 0; i < input.size; ++i)
+		{
+			const auto& current = input.vertices[i];
+			const auto& next = input.vertices[(i + 1) % input.size];
+
+			const auto current_distance = planeDistance(current.position, plane, guardBand);
+			const auto next_distance = planeDistance(next.position, plane, guardBand);
+
+			if (current_distance >= 0.0f)
+			{
+				polygon.vertices[polygon.size++] = current;
+			}
+
+			if ((current_distance >= 0.0f) != (next_distance >= 0.0f))
+			{
+				polygon.vertices[polygon.size++] = interpolate(current, next, current_distance / (current_distance - next_distance));
+			}
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Math.h"
+
+#include <array>
+
+namespace cg
+{
+	/// <summary>
+	/// Vertex in homogeneous clip space together with its attributes
+	/// </summary>
+	struct ClipVertex
+	{
+		vec4 position;
+		Triangle::Point attributes;
+	};
+
+	/// <summary>
+	/// Polygon resulting from clipping a triangle; each plane can add at most one vertex
+	/// </summary>
+	struct ClipPolygon
+	{
+		static constexpr unsigned int maxVertices = 9;
+
+		std::array<ClipVertex, maxVertices> vertices;
+		unsigned int size;
+	};
+
+	/// Clip planes: near and far plane, and the guard band around the viewport in x and y
+	enum clip_plane_t : unsigned int
+	{
+		CLIP_NEAR = 1, CLIP_FAR = 2, CLIP_LEFT = 4, CLIP_RIGHT = 8, CLIP_BOTTOM = 16, CLIP_TOP = 32
+	};
+
+	/// <summary>
+	/// Compute the planes a clip space position lies outside of
+	/// </summary>
+	/// <param name="position">Position in clip space</param>
+	/// <param name="guardBand">Extent of the guard band in multiples of the viewport's half size</param>
+	/// <returns>Bitmask of clip planes</returns>
+	unsigned int computeOutcode(const vec4& position, float guardBand);
+
+	/// <summary>
+	/// Clip a triangle against the given planes (Sutherland-Hodgman), interpolating all attributes linearly
+	/// </summary>
+	/// <param name="triangle">Corners of the triangle</param>
+	/// <param name="planes">Bitmask of the clip planes to clip against</param>
+	/// <param name="guardBand">Extent of the guard band in multiples of the viewport's half size</param>
+	/// <param name="polygon">Resulting convex polygon, empty if the triangle is completely clipped</param>
+	void clipTriangle(const std::array<ClipVertex, 3>& triangle, unsigned int planes, float guardBand, ClipPolygon& polygon);
+}
@@ -0,0 +1,154 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	/// Heap allocations of the whole program, counted by the replaced global operator new
+	std::atomic<unsigned long long> heapAllocations(0);
+
+	/// <summary>
+	/// Allocate memory from the heap and count the allocation
+	/// </summary>
+	/// <param name="size">Size in bytes</param>
+	/// <returns>Allocated memory, nullptr if out of memory</returns>
+	void* allocateCounted(const std::size_t size) noexcept
+	{
+		heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		return std::malloc(size != 0 ? size : 1);
+	}
+}
+
+void* operator new(const std::size_t size)
+{
+	const auto memory = allocateCounted(size);
+
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](const std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocateCounted(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocateCounted(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+cg::FrameArena::FrameArena(const std::size_t blockSize) : offset(0), previousBytes(0), blockAllocations(0)
+{
+	addBlock(blockSize);
+}
+
+void* cg::FrameArena::allocate(const std::size_t size, const std::size_t alignment)
+{
+	auto& block = this->blocks.back();
+
+	const auto address = reinterpret_cast<std::uintptr_t>(block.memory.get()) + this->offset;
+	const auto padding = (alignment - address % alignment) % alignment;
+
+	if (this->offset + padding + size <= block.size)
+	{
+		this->offset += padding + size;
+
+		return block.memory.get() + this->offset - size;
+	}
+
+	// The new block is at least twice as large as the current one, so that a growing frame only needs few of them
+	addBlock(std::max(size + alignment, 2 * block.size));
+
+	return allocate(size, alignment);
+}
+
+void cg::FrameArena::reset()
+{
+	if (this->blocks.size() > 1)
+	{
+		std::size_t size = 0;
+
+		for (const auto& block : this->blocks)
+		{
+			size += block.size;
+		}
+
+		this->blocks.clear();
+		addBlock(size);
+	}
+
+	this->offset = 0;
+	this->previousBytes = 0;
+}
+
+std::size_t cg::FrameArena::getUsedBytes() const
+{
+	return this->previousBytes + this->offset;
+}
+
+unsigned long long cg::FrameArena::getBlockAllocations() const
+{
+	return this->blockAllocations;
+}
+
+void cg::FrameArena::addBlock(const std::size_t size)
+{
+	if (!this->blocks.empty())
+	{
+		this->previousBytes += this->offset;
+	}
+
+	this->blocks.push_back(Block{ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size });
+	this->offset = 0;
+
+	++this->blockAllocations;
+}
+
+unsigned long long cg::getHeapAllocations()
+{
+	return heapAllocations.load(std::memory_order_relaxed);
+}
\ No newline at end of file
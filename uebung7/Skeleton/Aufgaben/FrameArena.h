@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Monotonic memory arena for the temporaries of a frame
+	///
+	/// Allocations only advance a pointer within the current block and are never freed on their own;
+	/// instead, the whole arena is reset once per frame. If a frame needed more than one block, the
+	/// blocks are replaced by a single one large enough for all of them on reset, so that frames
+	/// of the same size do not allocate from the heap at all. The arena is not thread-safe and never
+	/// calls destructors: arrays must consist of objects which need none, and containers using a
+	/// FrameAllocator destroy their elements themselves, but must not outlive the next reset.
+	/// </summary>
+	class FrameArena
+	{
+	public:
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="blockSize">Size of the first block in bytes; later blocks grow with the requested sizes</param>
+		explicit FrameArena(std::size_t blockSize = 1 << 20);
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		/// <summary>
+		/// Allocate uninitialized memory, which stays valid until the next reset
+		/// </summary>
+		/// <param name="size">Size in bytes</param>
+		/// <param name="alignment">Alignment in bytes, a power of two</param>
+		/// <returns>Allocated memory</returns>
+		void* allocate(std::size_t size, std::size_t alignment);
+
+		/// <summary>
+		/// Allocate memory for an array, which stays valid until the next reset; the caller constructs
+		/// the elements, e.g., with placement new, before using them
+		/// </summary>
+		/// <param name="count">Number of elements</param>
+		/// <returns>First element</returns>
+		template <typename T>
+		T* allocateArray(std::size_t count);
+
+		/// <summary>
+		/// Release all allocations at once, merging the blocks if there are several
+		/// </summary>
+		void reset();
+
+		/// <summary>
+		/// Get the number of bytes allocated since the last reset, including the padding for alignment
+		/// </summary>
+		/// <returns>Allocated bytes</returns>
+		std::size_t getUsedBytes() const;
+
+		/// <summary>
+		/// Get the number of blocks the arena allocated from the heap since it was created
+		/// </summary>
+		/// <returns>Number of blocks</returns>
+		unsigned long long getBlockAllocations() const;
+
+	private:
+		/// Memory block and its size
+		struct Block
+		{
+			std::unique_ptr<unsigned char[]> memory;
+			std::size_t size;
+		};
+
+		/// <summary>
+		/// Append a new block, which becomes the current one
+		/// </summary>
+		/// <param name="size">Minimum size in bytes</param>
+		void addBlock(std::size_t size);
+
+		/// Blocks allocated since the last reset, the last one being the current one
+		std::vector<Block> blocks;
+
+		/// Bytes used of the current block, and of the previous blocks
+		std::size_t offset;
+		std::size_t previousBytes;
+
+		/// Number of blocks allocated since construction
+		unsigned long long blockAllocations;
+	};
+
+	/// <summary>
+	/// Standard allocator placing containers in a frame arena; deallocation does nothing,
+	/// so the containers must not outlive the next reset of the arena
+	/// </summary>
+	template <typename T>
+	class FrameAllocator
+	{
+	public:
+		using value_type = T;
+
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="arena">Arena to allocate from</param>
+		FrameAllocator(FrameArena& arena) : arena(&arena) { }
+
+		template <typename U>
+		FrameAllocator(const FrameAllocator<U>& other) : arena(other.getArena()) { }
+
+		T* allocate(std::size_t count) { return static_cast<T*>(this->arena->allocate(count * sizeof(T), alignof(T))); }
+		void deallocate(T*, std::size_t) { }
+
+		/// <summary>
+		/// Get the arena the allocator allocates from
+		/// </summary>
+		/// <returns>Arena</returns>
+		FrameArena* getArena() const { return this->arena; }
+
+	private:
+		FrameArena* arena;
+	};
+
+	template <typename T, typename U>
+	bool operator==(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs) { return lhs.getArena() == rhs.getArena(); }
+
+	template <typename T, typename U>
+	bool operator!=(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs) { return lhs.getArena() != rhs.getArena(); }
+
+	/// Vector whose elements are placed in a frame arena
+	template <typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+	/// <summary>
+	/// Get the number of heap allocations made by the whole program so far, counted by the replaced
+	/// global operator new; the difference before and after a frame tells whether it allocated
+	/// </summary>
+	/// <returns>Number of heap allocations</returns>
+	unsigned long long getHeapAllocations();
+}
+
+template <typename T>
+T* cg::FrameArena::allocateArray(const std::size_t count)
+{
+	static_assert(std::is_trivially_destructible<T>::value, "The frame arena does not call destructors");
+
+	return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+}
\ No newline at end of file
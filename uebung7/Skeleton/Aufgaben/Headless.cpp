@@ -0,0 +1,348 @@
+#include "Scenes.h"
+#include "Rasterizer.h"
+
+#include "Image/Image.h"
+#include "Image/ImageIO.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/// Rotation per frame in degrees when checking the allocations without a rotation, so that the frames differ
+	const float allocationCheckRotation = 3.0f;
+
+	/// <summary>
+	/// Options of the headless renderer
+	/// </summary>
+	struct Options
+	{
+		int scene = 3;
+		cg::Rasterizer::rasterization_mode mode = cg::Rasterizer::FILLED;
+		unsigned int frames = 100;
+		float rotation = 0.0f;
+		unsigned int width = 1600;
+		unsigned int height = 900;
+		std::set<unsigned int> savedFrames;
+		std::string output = "frame";
+		bool hierarchicalZ = true;
+		bool frontToBack = false;
+		bool levelOfDetail = true;
+		std::string statisticsLog;
+		unsigned int threads = 0;
+		bool checkAllocations = false;
+	};
+
+	/// <summary>
+	/// Print command line usage
+	/// </summary>
+	void printUsage()
+	{
+		std::cout << "Usage: Headless [options]" << std::endl
+			<< "  --scene <index>              Scene to render (default: 3, the complex scene)" << std::endl
+			<< "  --mode <mode>                points, wireframe, filled, binned or deferred (default: filled)" << std::endl
+			<< "  --frames <count>             Number of frames to render (default: 100)" << std::endl
+			<< "  --rotate <degrees>           Rotation per frame about the z-axis (default: 0)" << std::endl
+			<< "  --size <width>x<height>      Image size (default: 1600x900)" << std::endl
+			<< "  --save <frame>[,<frame>...]  Frames to save as PPM, counted from 0" << std::endl
+			<< "  --output <prefix>            File name prefix of saved frames (default: frame)" << std::endl
+			<< "  --no-hiz                     Disable the hierarchical z-buffer" << std::endl
+			<< "  --front-to-back              Draw objects front to back" << std::endl
+			<< "  --no-lod                     Disable the spheres' levels of detail" << std::endl
+			<< "  --statistics <file>          Append the statistics of each frame to a file as JSON lines" << std::endl
+			<< "  --threads <count>            Number of threads (default: 0, one per hardware thread)" << std::endl
+			<< "  --check-allocations          Fail if any frame after the first allocates from the heap;" << std::endl
+			<< "                               without --rotate, the scene rotates by " << allocationCheckRotation << " degrees per frame" << std::endl;
+	}
+
+	/// <summary>
+	/// Parse a single option value
+	/// </summary>
+	/// <param name="text">Value as given on the command line</param>
+	/// <returns>Parsed value</returns>
+	template <typename T>
+	T parseValue(const std::string& text)
+	{
+		std::istringstream stream(text);
+		T value;
+
+		if (!(stream >> value) || !stream.eof())
+		{
+			throw std::runtime_error("Invalid value " + text);
+		}
+
+		return value;
+	}
+
+	/// <summary>
+	/// Parse the command line arguments
+	/// </summary>
+	/// <param name="argc">Number of arguments</param>
+	/// <param name="argv">Arguments</param>
+	/// <returns>Options</returns>
+	Options parseOptions(const int argc, const char** argv)
+	{
+		Options options;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string argument(argv[i]);
+
+			const auto value = [&]() -> std::string
+			{
+				if (i + 1 >= argc)
+				{
+					throw std::runtime_error("Missing value for " + argument);
+				}
+
+				return argv[++i];
+			};
+
+			if (argument == "--scene")
+			{
+				options.scene = parseValue<int>(value());
+			}
+			else if (argument == "--mode")
+			{
+				const auto mode = value();
+
+				if (mode == "points") options.mode = cg::Rasterizer::POINTS;
+				else if (mode == "wireframe") options.mode = cg::Rasterizer::WIREFRAME;
+				else if (mode == "filled") options.mode = cg::Rasterizer::FILLED;
+				else if (mode == "binned") options.mode = cg::Rasterizer::BINNED;
+				else if (mode == "deferred") options.mode = cg::Rasterizer::DEFERRED;
+				else throw std::runtime_error("Unknown rasterization mode " + mode);
+			}
+			else if (argument == "--frames")
+			{
+				options.frames = parseValue<unsigned int>(value());
+			}
+			else if (argument == "--rotate")
+			{
+				options.rotation = parseValue<float>(value());
+			}
+			else if (argument == "--size")
+			{
+				const auto size = value();
+				const auto separator = size.find('x');
+
+				if (separator == std::string::npos)
+				{
+					throw std::runtime_error("Invalid image size " + size);
+				}
+
+				options.width = parseValue<unsigned int>(size.substr(0, separator));
+				options.height = parseValue<unsigned int>(size.substr(separator + 1));
+
+				if (options.width == 0 || options.height == 0)
+				{
+					throw std::runtime_error("Invalid image size " + size);
+				}
+			}
+			else if (argument == "--save")
+			{
+				std::istringstream frames(value());
+				std::string frame;
+
+				while (std::getline(frames, frame, ','))
+				{
+					options.savedFrames.insert(parseValue<unsigned int>(frame));
+				}
+			}
+			else if (argument == "--output")
+			{
+				options.output = value();
+			}
+			else if (argument == "--no-hiz")
+			{
+				options.hierarchicalZ = false;
+			}
+			else if (argument == "--front-to-back")
+			{
+				options.frontToBack = true;
+			}
+			else if (argument == "--no-lod")
+			{
+				options.levelOfDetail = false;
+			}
+			else if (argument == "--statistics")
+			{
+				options.statisticsLog = value();
+			}
+			else if (argument == "--threads")
+			{
+				options.threads = parseValue<unsigned int>(value());
+			}
+			else if (argument == "--check-allocations")
+			{
+				options.checkAllocations = true;
+			}
+			else
+			{
+				throw std::runtime_error("Unknown option " + argument);
+			}
+		}
+
+		// A still scene repeats the first frame, which would not show the allocations of changing triangles and bins
+		if (options.checkAllocations && options.rotation == 0.0f)
+		{
+			options.rotation = allocationCheckRotation;
+		}
+
+		return options;
+	}
+
+	/// <summary>
+	/// Save the rendered RGBA image as PPM, clamping the colors to [0, 1]
+	/// </summary>
+	/// <param name="path">Path to image file</param>
+	/// <param name="image">Rendered image</param>
+	void saveFrame(const std::string& path, const cg::image<cg::color_space_t::RGBA>& image)
+	{
+		cg::image<cg::color_space_t::RGB> rgb(image.get_width(), image.get_height());
+
+		for (unsigned int j = 0; j < image.get_height(); ++j)
+		{
+			for (unsigned int i = 0; i < image.get_width(); ++i)
+			{
+				for (unsigned int c = 0; c < 3; ++c)
+				{
+					rgb(i, j)[c] = std::min(std::max(image(i, j)[c], 0.0f), 1.0f);
+				}
+			}
+		}
+
+		cg::image_io::save_rgb_image(path, rgb);
+	}
+}
+
+int main(const int argc, const char** argv)
+{
+	Options options;
+
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printUsage();
+
+		return 1;
+	}
+
+	const auto scenes = cg::createScenes();
+
+	if (options.scene < 0 || options.scene >= static_cast<int>(scenes.size()))
+	{
+		std::cerr << "Scene index must be between 0 and " << scenes.size() - 1 << std::endl;
+
+		return 1;
+	}
+
+	cg::Rasterizer rasterizer(cg::defaultCamera(), scenes, options.mode, options.width, options.height);
+	rasterizer.accessActiveScene() = options.scene;
+	rasterizer.accessHierarchicalZ() = options.hierarchicalZ;
+	rasterizer.accessFrontToBack() = options.frontToBack;
+	rasterizer.accessLevelOfDetail() = options.levelOfDetail;
+	rasterizer.accessStatisticsLog() = options.statisticsLog;
+	rasterizer.accessThreadCount() = options.threads;
+
+	std::cout << "Rendering " << options.frames << " frames of scene '" << scenes[options.scene].getName() << "' at "
+		<< options.width << "x" << options.height << std::endl;
+
+	// Render all frames, timing each of them including the resolve of the image
+	std::cout << std::fixed << std::setprecision(3);
+
+	double totalTime = 0.0, minTime = 0.0, maxTime = 0.0;
+	unsigned long long totalTriangles = 0, totalFragments = 0, firstAllocations = 0, maxAllocations = 0;
+	unsigned int allocatingFrames = 0;
+	cg::RenderStatistics totalStages;
+
+	for (unsigned int frame = 0; frame < options.frames; ++frame)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		rasterizer.drawRotated(options.rotation * static_cast<float>(frame));
+
+		const auto time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		const auto& statistics = rasterizer.getStatistics();
+
+		totalTime += time;
+		minTime = (frame == 0) ? time : std::min(minTime, time);
+		maxTime = (frame == 0) ? time : std::max(maxTime, time);
+		totalTriangles += statistics.drawnTriangles;
+		totalFragments += statistics.fragments;
+		totalStages.meshTime += statistics.meshTime;
+		totalStages.vertexTime += statistics.vertexTime;
+		totalStages.rasterizationTime += statistics.rasterizationTime;
+		totalStages.shadingTime += statistics.shadingTime;
+		totalStages.resolveTime += statistics.resolveTime;
+
+		// The first frame calculates the meshes and grows the buffers, later frames of the same scene should not allocate,
+		// even if they rotate
+		if (frame == 0)
+		{
+			firstAllocations = statistics.heapAllocations;
+		}
+		else
+		{
+			maxAllocations = std::max(maxAllocations, statistics.heapAllocations);
+			allocatingFrames += statistics.heapAllocations != 0 ? 1 : 0;
+		}
+
+		std::cout << "Frame " << frame << ": " << time << " ms, " << statistics.drawnTriangles << " triangles, "
+			<< statistics.fragments << " fragments, overdraw " << cg::getOverdraw(statistics);
+
+		for (unsigned int level = 0; level < cg::Sphere::numLevelsOfDetail; ++level)
+		{
+			if (statistics.levelOfDetailSpheres[level] != 0)
+			{
+				std::cout << ", " << statistics.levelOfDetailSpheres[level] << " spheres at level " << level
+					<< " (" << statistics.levelOfDetailTriangles[level] << " triangles)";
+			}
+		}
+
+		std::cout << std::endl;
+
+		if (options.savedFrames.count(frame) != 0)
+		{
+			char suffix[16];
+			std::snprintf(suffix, sizeof(suffix), "_%04u.ppm", frame);
+
+			saveFrame(options.output + suffix, rasterizer.accessImage());
+		}
+	}
+
+	if (options.frames != 0)
+	{
+		const auto seconds = totalTime / 1000.0;
+
+		std::cout << std::endl << "Frames:       " << options.frames << std::endl
+			<< "ms/frame:     " << totalTime / options.frames << " (min " << minTime << ", max " << maxTime << ")" << std::endl
+			<< "Triangles/s:  " << static_cast<unsigned long long>(totalTriangles / seconds) << std::endl
+			<< "Fragments/s:  " << static_cast<unsigned long long>(totalFragments / seconds) << std::endl
+			<< "ms/stage:     meshes " << totalStages.meshTime / options.frames << ", vertices " << totalStages.vertexTime / options.frames
+			<< ", rasterization " << totalStages.rasterizationTime / options.frames << ", shading " << totalStages.shadingTime / options.frames
+			<< ", resolve " << totalStages.resolveTime / options.frames << std::endl
+			<< "Allocations:  " << firstAllocations << " in the first frame, at most " << maxAllocations << " per later frame" << std::endl;
+	}
+
+	if (options.checkAllocations && allocatingFrames != 0)
+	{
+		std::cerr << "Error: " << allocatingFrames << " frames after the first allocated from the heap" << std::endl;
+
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
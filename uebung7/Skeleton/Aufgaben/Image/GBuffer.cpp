@@ -0,0 +1,19 @@
+#include "GBuffer.h"
+
+#include <algorithm>
+
+cg::g_buffer::g_buffer(const unsigned int width, const unsigned int height) : cg::image_base(width, height)
+{
+	resizeImage();
+	initialize();
+}
+
+void cg::g_buffer::initialize()
+{
+	std::fill(this->m_samples.begin(), this->m_samples.end(), sample_type{ no_triangle, 0.0f, { 0.0f, 0.0f } });
+}
+
+void cg::g_buffer::resizeImage()
+{
+	this->m_samples.resize(this->width * this->height);
+}
\ No newline at end of file
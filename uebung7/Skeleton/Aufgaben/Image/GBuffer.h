@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ImageBase.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Geometry buffer for deferred shading, storing per pixel which triangle is visible and where
+	///
+	/// Each sample holds the index of the triangle, the pixel's depth and its barycentric weights with
+	/// respect to the triangle's second and third corner; the weight of the first corner follows from them.
+	/// The pixels are stored row by row. The accessors do not check their arguments; the caller is
+	/// responsible for passing coordinates within the image.
+	/// </summary>
+	class g_buffer : public image_base
+	{
+	public:
+		/// Triangle index of pixels not covered by any triangle
+		static constexpr std::uint32_t no_triangle = ~std::uint32_t(0);
+
+		/// Visible surface of a pixel
+		struct sample_type
+		{
+			std::uint32_t triangle;
+			float depth;
+			std::array<float, 2> barycentrics;
+		};
+
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="width">Image width</param>
+		/// <param name="height">Image height</param>
+		g_buffer(unsigned int width, unsigned int height);
+
+		/// <summary>
+		/// Mark all pixels as not covered
+		/// </summary>
+		virtual void initialize();
+
+		/// <summary>
+		/// Access the sample of a pixel without bounds check
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <returns>Sample</returns>
+		const sample_type& operator()(unsigned int x, unsigned int y) const;
+		sample_type& operator()(unsigned int x, unsigned int y);
+
+	protected:
+		virtual void resizeImage();
+
+	private:
+		/// Samples, row by row
+		std::vector<sample_type> m_samples;
+	};
+}
+
+inline const cg::g_buffer::sample_type& cg::g_buffer::operator()(const unsigned int x, const unsigned int y) const
+{
+	return this->m_samples[y * this->width + x];
+}
+
+inline cg::g_buffer::sample_type& cg::g_buffer::operator()(const unsigned int x, const unsigned int y)
+{
+	return this->m_samples[y * this->width + x];
+}
\ No newline at end of file
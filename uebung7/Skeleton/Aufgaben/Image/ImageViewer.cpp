@@ -1,5 +1,7 @@
 #include "ImageViewer.h"
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -41,10 +43,41 @@ namespace cg
 
 			return source.str();
 		}
+
+		/** Number of image rows converted per job */
+		const int conversionJobRows = 16;
+
+		/** Convert the rendered image to 8-bit RGBA, clamping the colors to [0, 1], on the rasterizer's threads */
+		void convertToRGBA8(const image<color_space_t::RGBA>& image, std::vector<std::uint8_t>& buffer, JobSystem& jobs)
+		{
+			const auto width = static_cast<int>(image.get_width());
+			const auto* pixels = image.data();
+
+			buffer.resize(4 * image.get_width() * image.get_height());
+
+			auto* bytes = buffer.data();
+
+			JobSystem::Group group;
+
+			jobs.submitRange(group, 0, static_cast<int>(image.get_height()), conversionJobRows, [pixels, bytes, width](const int first, const int last)
+			{
+				for (int i = first * width; i < last * width; ++i)
+				{
+					for (int c = 0; c < 4; ++c)
+					{
+						bytes[4 * i + c] = static_cast<std::uint8_t>(std::min(std::max(pixels[i][c], 0.0f), 1.0f) * 255.0f + 0.5f);
+					}
+				}
+			});
+
+			jobs.wait(group);
+		}
 	}
 
 	ImageViewer::ImageViewer(Rasterizer& rasterizer)
-		: m_image(rasterizer.accessImage()), rasterizer(rasterizer), m_needs_update(true), m_auto_update(false)
+		: m_image(rasterizer.accessImage()), m_pixel_buffer(0), m_rotate(false), m_needs_update(true), m_auto_update(false),
+		m_frame_requested(false), m_frame_rotate(false), m_resize_requested(false), m_requested_width(0), m_requested_height(0), m_exit(false),
+		m_front_width(0), m_front_height(0), m_frame_available(false), rasterizer(rasterizer)
 	{ }
 
 	void ImageViewer::run()
@@ -122,12 +155,14 @@ namespace cg
 			std::cout << this->m_display_prgm->getLog();
 		}
 
+		// Render in the background, so that the UI stays responsive while the rasterizer is running
+		glGenBuffers(1, &this->m_pixel_buffer);
+
+		this->m_render_thread = std::thread(&ImageViewer::renderLoop, this);
+
 		while (!glfwWindowShouldClose(this->m_active_window))
 		{
-			TextureLayout img_layout(GL_RGBA32F, this->m_image.get_width(), this->m_image.get_height(), 1, GL_RGBA, GL_FLOAT, 1);
-			img_layout.int_parameters.push_back({ GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR });
-			img_layout.int_parameters.push_back({ GL_TEXTURE_MAG_FILTER, GL_LINEAR });
-			this->m_texture = std::make_unique<Texture2D>(img_layout, const_cast<std::array<float, 4>*>(this->m_image.data()));
+			uploadFrame();
 
 			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -135,16 +170,22 @@ namespace cg
 			glfwGetFramebufferSize(this->m_active_window, &width, &height);
 			glViewport(0, 0, width, height);
 
-			this->m_display_prgm->use();
+			if (this->m_texture != nullptr)
+			{
+				this->m_display_prgm->use();
 
-			glActiveTexture(GL_TEXTURE0);
-			this->m_texture->bindTexture();
-			glUniform1i(this->m_display_prgm->getUniformLocation("display_tx2D"), 0);
+				glActiveTexture(GL_TEXTURE0);
+				this->m_texture->bindTexture();
+				glUniform1i(this->m_display_prgm->getUniformLocation("display_tx2D"), 0);
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+				glDrawArrays(GL_TRIANGLES, 0, 6);
+			}
 
 			ImGui_ImplGlfwGL3_NewFrame();
-			drawUI();
+			{
+				std::lock_guard<std::mutex> lock(this->m_mutex);
+				drawUI();
+			}
 			ImGui::Render();
 
 			auto gl_err = glGetError();
@@ -155,10 +196,112 @@ namespace cg
 			glfwPollEvents();
 		}
 
+		// Stop the render thread, which finishes its current frame first
+		{
+			std::lock_guard<std::mutex> lock(this->m_mutex);
+			this->m_exit = true;
+		}
+
+		this->m_condition.notify_one();
+		this->m_render_thread.join();
+
 		// Clean up GPU resources while context is still alive
+		glDeleteBuffers(1, &this->m_pixel_buffer);
+		this->m_texture.reset();
 		this->m_display_prgm.reset();
 	}
 
+	void ImageViewer::uploadFrame()
+	{
+		unsigned int width, height;
+
+		{
+			std::lock_guard<std::mutex> lock(this->m_mutex);
+
+			if (!this->m_frame_available)
+			{
+				return;
+			}
+
+			width = this->m_front_width;
+			height = this->m_front_height;
+
+			// Copy the frame into a fresh pixel buffer; orphaning the old one avoids waiting for its previous upload
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, this->m_pixel_buffer);
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, this->m_front_buffer.size(), nullptr, GL_STREAM_DRAW);
+
+			auto* memory = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, this->m_front_buffer.size(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+			if (memory != nullptr)
+			{
+				std::memcpy(memory, this->m_front_buffer.data(), this->m_front_buffer.size());
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			}
+
+			this->m_frame_available = false;
+		}
+
+		// Keep the texture as long as the image size stays the same
+		if (this->m_texture == nullptr || this->m_texture->getWidth() != width || this->m_texture->getHeight() != height)
+		{
+			TextureLayout img_layout(GL_RGBA8, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, 1);
+			img_layout.int_parameters.push_back({ GL_TEXTURE_MIN_FILTER, GL_LINEAR });
+			img_layout.int_parameters.push_back({ GL_TEXTURE_MAG_FILTER, GL_LINEAR });
+			this->m_texture = std::make_unique<Texture2D>(img_layout, nullptr);
+		}
+
+		// Transfer from the pixel buffer, which does not block on the copy
+		this->m_texture->bindTexture();
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	void ImageViewer::renderLoop()
+	{
+		std::unique_lock<std::mutex> lock(this->m_mutex);
+
+		while (true)
+		{
+			this->m_condition.wait(lock, [this]() { return this->m_frame_requested || this->m_exit; });
+
+			if (this->m_exit)
+			{
+				return;
+			}
+
+			this->m_frame_requested = false;
+
+			// The image must not be resized while the rasterizer is drawing into it
+			if (this->m_resize_requested)
+			{
+				this->rasterizer.accessCamera().setAspect(static_cast<float>(this->m_requested_width) / static_cast<float>(this->m_requested_height));
+				this->rasterizer.accessImage().resize(this->m_requested_width, this->m_requested_height);
+
+				this->m_resize_requested = false;
+			}
+
+			// Capture the scene while the UI is locked out, and render without holding the lock
+			this->rasterizer.prepareFrame(this->m_frame_rotate);
+
+			lock.unlock();
+
+			this->rasterizer.renderFrame();
+
+			const auto& image = this->rasterizer.accessImage();
+			convertToRGBA8(image, this->m_back_buffer, this->rasterizer.accessJobSystem());
+
+			lock.lock();
+
+			std::swap(this->m_back_buffer, this->m_front_buffer);
+			this->m_front_width = image.get_width();
+			this->m_front_height = image.get_height();
+			this->m_frame_available = true;
+
+			this->m_statistics = this->rasterizer.getStatistics();
+		}
+	}
+
 	void ImageViewer::drawUI()
 	{
 		ImGuiWindowFlags window_flags = 0;
@@ -204,9 +347,9 @@ namespace cg
 		// Camera settings
 		ImGui::Text("Camera");
 
-		ImGui::DragFloat("Field of view", &this->rasterizer.accessCamera().accessFov(), 5.0f, 30.0f, 90.0f);
-		ImGui::DragFloat("Near plane", &this->rasterizer.accessCamera().accessNear(), 0.01f, 0.001f, 10.0f);
-		ImGui::DragFloat("Far plane", &this->rasterizer.accessCamera().accessFar(), 10.0f, 10.0f, 100000.0f);
+		this->m_needs_update |= ImGui::DragFloat("Field of view", &this->rasterizer.accessCamera().accessFov(), 5.0f, 30.0f, 90.0f);
+		this->m_needs_update |= ImGui::DragFloat("Near plane", &this->rasterizer.accessCamera().accessNear(), 0.01f, 0.001f, 10.0f);
+		this->m_needs_update |= ImGui::DragFloat("Far plane", &this->rasterizer.accessCamera().accessFar(), 10.0f, 10.0f, 100000.0f);
 
 		if (ImGui::Button("Reset", ImVec2(300, 20)))
 		{
@@ -221,10 +364,79 @@ namespace cg
 		// Rasterizer settings
 		ImGui::Text("Rasterization");
 
-		const char* items[] = { "POINTS", "WIREFRAME", "FILLED" };
-		static int item = this->rasterizer.accessMode();
-		ImGui::Combo("Mode", &item, items, IM_ARRAYSIZE(items));
-		this->rasterizer.accessMode() = static_cast<Rasterizer::rasterization_mode>(item);
+		const char* items[] = { "POINTS", "WIREFRAME", "FILLED", "BINNED", "DEFERRED" };
+		int item = this->rasterizer.accessMode();
+
+		if (ImGui::Combo("Mode", &item, items, IM_ARRAYSIZE(items)))
+		{
+			this->rasterizer.accessMode() = static_cast<Rasterizer::rasterization_mode>(item);
+			this->m_needs_update = true;
+		}
+
+		this->m_needs_update |= ImGui::Checkbox("Hierarchical z-buffer", &this->rasterizer.accessHierarchicalZ());
+		this->m_needs_update |= ImGui::Checkbox("Front to back", &this->rasterizer.accessFrontToBack());
+		this->m_needs_update |= ImGui::Checkbox("Sphere level of detail", &this->rasterizer.accessLevelOfDetail());
+
+		// Number of threads rendering the frame, 0 for one per hardware thread
+		auto threads = static_cast<int>(this->rasterizer.accessThreadCount());
+
+		if (ImGui::SliderInt("Threads", &threads, 0, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u))))
+		{
+			this->rasterizer.accessThreadCount() = static_cast<unsigned int>(threads);
+			this->m_needs_update = true;
+		}
+
+		auto logStatistics = !this->rasterizer.accessStatisticsLog().empty();
+
+		if (ImGui::Checkbox("Log statistics to statistics.jsonl", &logStatistics))
+		{
+			this->rasterizer.accessStatisticsLog() = logStatistics ? "statistics.jsonl" : "";
+		}
+
+		// Statistics of the last finished frame, as the rasterizer may be busy with the next one
+		const auto& statistics = this->m_statistics;
+
+		ImGui::Text("Frame: %.2f ms", statistics.frameTime);
+		ImGui::Text("Meshes: %.2f ms, vertices: %.2f ms", statistics.meshTime, statistics.vertexTime);
+		ImGui::Text("Rasterization: %.2f ms, resolve: %.2f ms", statistics.rasterizationTime, statistics.resolveTime);
+
+		if (this->rasterizer.accessMode() == Rasterizer::DEFERRED)
+		{
+			ImGui::Text("Shading: %.2f ms", statistics.shadingTime);
+		}
+
+		ImGui::Text("Heap allocations: %llu, frame arena: %llu KiB", statistics.heapAllocations, statistics.frameArenaBytes / 1024);
+
+		ImGui::Text("Culled objects: %llu", statistics.culledObjects);
+		ImGui::Text("Submitted triangles: %llu", statistics.submittedTriangles);
+		ImGui::Text("Culled triangles: %llu outside, %llu back faces", statistics.frustumCulledTriangles, statistics.culledBackFaces);
+		ImGui::Text("Rasterized triangles: %llu (%llu clipped)", statistics.drawnTriangles, statistics.clippedTriangles);
+		ImGui::Text("Fragments: %llu / %llu tested", statistics.fragments, statistics.testedFragments);
+		ImGui::Text("Overdraw: %.2f", getOverdraw(statistics));
+
+		if (this->rasterizer.accessMode() == Rasterizer::DEFERRED)
+		{
+			ImGui::Text("Shaded pixels: %llu / %llu fragments", statistics.shadedPixels, statistics.fragments);
+		}
+
+		if (this->rasterizer.accessHierarchicalZ())
+		{
+			ImGui::Text("Rejected triangles: %llu / %llu", statistics.hiZRejectedTriangles, statistics.hiZTestedTriangles);
+			ImGui::Text("Rejected blocks: %llu / %llu", statistics.hiZRejectedBlocks, statistics.hiZTestedBlocks);
+			ImGui::Text("Accepted blocks: %llu / %llu", statistics.hiZAcceptedBlocks, statistics.hiZTestedBlocks);
+		}
+
+		if (this->rasterizer.accessLevelOfDetail())
+		{
+			for (unsigned int level = 0; level < Sphere::numLevelsOfDetail; ++level)
+			{
+				if (statistics.levelOfDetailSpheres[level] != 0)
+				{
+					ImGui::Text("Level %u: %llu spheres, %llu triangles", level,
+						statistics.levelOfDetailSpheres[level], statistics.levelOfDetailTriangles[level]);
+				}
+			}
+		}
 
 		ImGui::Separator();
 
@@ -244,15 +456,18 @@ namespace cg
 		}
 
 		float axis[3] = { this->rasterizer.accessRotationAxis()[0], this->rasterizer.accessRotationAxis()[1], this->rasterizer.accessRotationAxis()[2] };
-		ImGui::DragFloat3("Rotation axis", axis, 0.01f, 0.0f, 1.0f);
-		this->rasterizer.accessRotationAxis() = vec3(axis[0], axis[1], axis[2]);
+
+		if (ImGui::DragFloat3("Rotation axis", axis, 0.01f, 0.0f, 1.0f))
+		{
+			this->rasterizer.accessRotationAxis() = vec3(axis[0], axis[1], axis[2]);
+		}
 
 		ImGui::DragFloat("Rotation speed", &this->rasterizer.accessRotationSpeed(), 1.0f, 1.0f, 100.0f);
 
 		ImGui::Separator();
 
 		// Light options
-		auto lights = this->rasterizer.accessScene().getLights();
+		const auto& lights = this->rasterizer.accessScene().getLights();
 
 		if (lights.size() != 0)
 		{
@@ -264,20 +479,24 @@ namespace cg
 				const std::string color_name = "Light color " + std::to_string(i);
 				const std::string intensity_name = "Light intensity " + std::to_string(i);
 
-				ImGui::Checkbox(object_name.c_str(), &lights[i]->accessVisibility());
+				this->m_needs_update |= ImGui::Checkbox(object_name.c_str(), &lights[i]->accessVisibility());
 
 				float color[3] = { lights[i]->accessColor()[0], lights[i]->accessColor()[1], lights[i]->accessColor()[2] };
-				ImGui::ColorEdit3(color_name.c_str(), color);
-				lights[i]->accessColor() = Color(color[0], color[1], color[2], 1.0f);
 
-				ImGui::DragFloat(intensity_name.c_str(), &lights[i]->accessIntensity(), 0.1f, 0.0f, 100.0f);
+				if (ImGui::ColorEdit3(color_name.c_str(), color))
+				{
+					lights[i]->accessColor() = Color(color[0], color[1], color[2], 1.0f);
+					this->m_needs_update = true;
+				}
+
+				this->m_needs_update |= ImGui::DragFloat(intensity_name.c_str(), &lights[i]->accessIntensity(), 0.1f, 0.0f, 100.0f);
 			}
 
 			ImGui::Separator();
 		}
 
 		// Object options
-		auto objects = this->rasterizer.accessScene().getObjects();
+		const auto& objects = this->rasterizer.accessScene().getObjects();
 
 		if (objects.size() != 0)
 		{
@@ -288,26 +507,37 @@ namespace cg
 				const std::string object_name = "Show " + objects[i]->getShapeName() + " #" + std::to_string(i);
 				const std::string color_name = "Object color " + std::to_string(i);
 
-				ImGui::Checkbox(object_name.c_str(), &objects[i]->accessVisibility());
+				const std::string culling_name = "Back-face culling " + std::to_string(i);
+
+				this->m_needs_update |= ImGui::Checkbox(object_name.c_str(), &objects[i]->accessVisibility());
+				this->m_needs_update |= ImGui::Checkbox(culling_name.c_str(), &objects[i]->accessBackFaceCulling());
 
 				if (dynamic_cast<cg::Container*>(objects[i].get()) == nullptr)
 				{
-					float color[3] = { objects[i]->accessColor()[0], objects[i]->accessColor()[1], objects[i]->accessColor()[2] };
-					ImGui::ColorEdit3(color_name.c_str(), color);
-					objects[i]->accessColor() = Color(color[0], color[1], color[2], 1.0f);
+					float color[3] = { objects[i]->getColor()[0], objects[i]->getColor()[1], objects[i]->getColor()[2] };
+
+					if (ImGui::ColorEdit3(color_name.c_str(), color))
+					{
+						objects[i]->setColor(Color(color[0], color[1], color[2], 1.0f));
+						this->m_needs_update = true;
+					}
 				}
 			}
 
 			ImGui::Separator();
 		}
 
-		// Draw button
+		// Draw button; without changes, no new frame is rendered unless requested
 		ImGui::Checkbox("Auto update", &this->m_auto_update);
 
 		if (ImGui::Button("Update", ImVec2(300, 20)) || this->m_rotate || this->m_needs_update || this->m_auto_update)
 		{
-			this->rasterizer.draw(this->m_rotate);
-			this->m_needs_update = this->m_rotate;
+			// The render thread picks up the request after its current frame, so at most one frame is pending
+			this->m_frame_requested = true;
+			this->m_frame_rotate = this->m_rotate;
+			this->m_condition.notify_one();
+
+			this->m_needs_update = false;
 		}
 
 		ImGui::End();
@@ -315,8 +545,18 @@ namespace cg
 
 	void ImageViewer::windowSizeCallback(GLFWwindow* window, int width, int height)
 	{
-		this->rasterizer.accessCamera().setAspect(static_cast<float>(width) / static_cast<float>(height));
-		this->rasterizer.accessImage().resize(width, height);
+		// A minimized window has no area to draw into
+		if (width <= 0 || height <= 0)
+		{
+			return;
+		}
+
+		// The render thread resizes the image before its next frame
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+
+		this->m_resize_requested = true;
+		this->m_requested_width = width;
+		this->m_requested_height = height;
 
 		this->m_needs_update = true;
 	}
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "../Scene/Camera.h"
 #include "Image.h"
 #include "../Rasterizer.h"
+#include "../RenderStatistics.h"
 
 #include "../glowl/Texture2D.hpp"
 #include "../glowl/GLSLProgram.hpp"
@@ -34,17 +40,48 @@ namespace cg
 		/** GLSL shader program for displaying the image */
 		std::unique_ptr<GLSLProgram> m_display_prgm;
 
-		/** OpenGL texture objects for storing and working with the image data on the GPU */
+		/** OpenGL texture object for storing the image data on the GPU, kept as long as the image size does not change */
 		std::unique_ptr<Texture2D> m_texture;
 
+		/** Pixel buffer object for streaming new frames into the texture */
+		GLuint m_pixel_buffer;
+
 		/** GUI options */
 		bool m_rotate;
 		bool m_needs_update;
 		bool m_auto_update;
 
-		/** Draw UI */
+		/** Draw UI; must be called with m_mutex locked */
 		void drawUI();
 
+		/** Upload the last finished frame into the texture, if there is a new one */
+		void uploadFrame();
+
+		/** Render frames on request; runs on the render thread */
+		void renderLoop();
+
+		/** Background thread running the rasterizer */
+		std::thread m_render_thread;
+
+		/** Guards the rasterizer's settings and scenes while a frame is prepared, and all members below */
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+
+		/** Requests to the render thread: render a frame (with rotation?), resize the image, or exit */
+		bool m_frame_requested;
+		bool m_frame_rotate;
+		bool m_resize_requested;
+		unsigned int m_requested_width, m_requested_height;
+		bool m_exit;
+
+		/** Double-buffered 8-bit RGBA frames: the one the render thread converts into, and the last finished one with its size */
+		std::vector<std::uint8_t> m_back_buffer, m_front_buffer;
+		unsigned int m_front_width, m_front_height;
+		bool m_frame_available;
+
+		/** Statistics of the last finished frame */
+		RenderStatistics m_statistics;
+
 		/** Rasterizer for calling the draw method and additional GUI options */
 		Rasterizer& rasterizer;
 
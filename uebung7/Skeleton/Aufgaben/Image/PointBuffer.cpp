@@ -0,0 +1,88 @@
+#include "PointBuffer.h"
+
+#include <algorithm>
+#include <exception>
+
+cg::point_buffer::point_buffer(const unsigned int width, const unsigned int height) : cg::image_base(width, height)
+{
+	resizeImage();
+	initialize();
+}
+
+void cg::point_buffer::initialize()
+{
+	const auto size = static_cast<std::size_t>(this->width) * this->height;
+
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		this->m_data[i].store(empty, std::memory_order_relaxed);
+	}
+}
+
+std::uint32_t cg::point_buffer::pack_color(const color_type& color)
+{
+	std::uint32_t packed = 0;
+
+	for (unsigned int c = 0; c < 4; ++c)
+	{
+		const auto value = static_cast<std::uint32_t>(std::min(std::max(color[c], 0.0f), 1.0f) * 255.0f + 0.5f);
+		packed |= value << (8 * c);
+	}
+
+	return packed;
+}
+
+unsigned long long cg::point_buffer::resolve(image<color_space_t::RGBA>& target, const color_type& color)
+{
+	return resolve(target, color, 0, this->height);
+}
+
+unsigned long long cg::point_buffer::resolve(image<color_space_t::RGBA>& target, const color_type& color,
+	const unsigned int y_begin, const unsigned int y_end)
+{
+	if (target.get_width() != this->width || target.get_height() != this->height)
+	{
+		throw std::runtime_error("Image size does not match the point buffer");
+	}
+
+	if (y_end < y_begin || y_end > this->height)
+	{
+		throw std::runtime_error("Band exceeds the point buffer");
+	}
+
+	const auto begin = static_cast<std::size_t>(y_begin) * this->width;
+	const auto end = static_cast<std::size_t>(y_end) * this->width;
+	auto* data = target.data();
+
+	unsigned long long covered = 0;
+
+	// Unpack and clear each word in the same pass
+	for (auto i = begin; i < end; ++i)
+	{
+		const auto word = this->m_data[i].load(std::memory_order_relaxed);
+
+		if (word == empty)
+		{
+			data[i] = color;
+
+			continue;
+		}
+
+		const auto packed = ~static_cast<std::uint32_t>(word);
+		++covered;
+
+		for (unsigned int c = 0; c < 4; ++c)
+		{
+			data[i][c] = static_cast<float>((packed >> (8 * c)) & 0xff) / 255.0f;
+		}
+
+		this->m_data[i].store(empty, std::memory_order_relaxed);
+	}
+
+	return covered;
+}
+
+void cg::point_buffer::resizeImage()
+{
+	this->m_data.reset(new std::atomic<std::uint64_t>[this->width * this->height]);
+}
\ No newline at end of file
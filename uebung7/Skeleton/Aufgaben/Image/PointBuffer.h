@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Image.h"
+#include "ImageBase.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace cg
+{
+	/// <summary>
+	/// Combined depth and color buffer for splatting points from many threads without locking
+	///
+	/// Each pixel is a single 64-bit word holding the depth in its upper and the RGBA8 color in its
+	/// lower half. The depth is stored as the bits of a float in [0, 1], which compare like the floats
+	/// themselves, so an atomic minimum of the words performs the depth test and the color write at once.
+	/// The color is stored inverted, so that of points with equal depth, the one with the largest
+	/// packed color is kept, i.e., a deterministic color independent of the order of the points.
+	/// The accessors do not check their arguments; the caller is responsible for passing
+	/// coordinates within the image.
+	/// </summary>
+	class point_buffer : public image_base
+	{
+	public:
+		/// Tuple type for storing the color channels of a pixel
+		using color_type = std::array<float, 4>;
+
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="width">Image width</param>
+		/// <param name="height">Image height</param>
+		point_buffer(unsigned int width, unsigned int height);
+
+		/// <summary>
+		/// Clear all pixels, so that they are resolved to the clear color
+		/// </summary>
+		virtual void initialize();
+
+		/// <summary>
+		/// Pack a color into RGBA8, clamping the channels to [0, 1]
+		/// </summary>
+		/// <param name="color">Color</param>
+		/// <returns>Packed color, red in the lowest byte</returns>
+		static std::uint32_t pack_color(const color_type& color);
+
+		/// <summary>
+		/// Store a point if it is nearer than the one already stored at its pixel; thread-safe
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <param name="depth">Depth in [0, 1]</param>
+		/// <param name="color">Packed color</param>
+		/// <returns>True if the point was stored</returns>
+		bool splat(unsigned int x, unsigned int y, float depth, std::uint32_t color);
+
+		/// <summary>
+		/// Copy the colors into a linear, row-major RGBA image of the same size, using the clear color
+		/// for pixels without points, and clear the buffer for the next frame
+		/// </summary>
+		/// <param name="target">Target image</param>
+		/// <param name="color">Clear color</param>
+		/// <returns>Number of pixels with points</returns>
+		unsigned long long resolve(image<color_space_t::RGBA>& target, const color_type& color);
+
+		/// <summary>
+		/// Copy and clear a band of rows like resolve(target, color), e.g., on one of several threads
+		/// </summary>
+		/// <param name="target">Target image</param>
+		/// <param name="color">Clear color</param>
+		/// <param name="y_begin">First row</param>
+		/// <param name="y_end">Row after the last one</param>
+		/// <returns>Number of pixels of the band with points</returns>
+		unsigned long long resolve(image<color_space_t::RGBA>& target, const color_type& color, unsigned int y_begin, unsigned int y_end);
+
+	protected:
+		virtual void resizeImage();
+
+	private:
+		/// Word of a pixel without points, which is farther than any point
+		static constexpr std::uint64_t empty = ~std::uint64_t(0);
+
+		/// Depth and color words, row by row
+		std::unique_ptr<std::atomic<std::uint64_t>[]> m_data;
+	};
+}
+
+inline bool cg::point_buffer::splat(const unsigned int x, const unsigned int y, const float depth, const std::uint32_t color)
+{
+	std::uint32_t depth_bits;
+	std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+
+	const auto word = (static_cast<std::uint64_t>(depth_bits) << 32) | static_cast<std::uint64_t>(~color);
+
+	// Atomic minimum: only try to replace the stored word as long as the new one is smaller
+	auto& pixel = this->m_data[y * this->width + x];
+	auto stored = pixel.load(std::memory_order_relaxed);
+
+	while (word < stored)
+	{
+		if (pixel.compare_exchange_weak(stored, word, std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
\ No newline at end of file
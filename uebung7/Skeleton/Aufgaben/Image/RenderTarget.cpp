@@ -0,0 +1,205 @@
+#include "RenderTarget.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+
+// Definitions of the constants, which std::min and friends bind to references
+constexpr unsigned int cg::render_target::tile_size;
+constexpr unsigned int cg::render_target::region_size;
+
+cg::render_target::render_target(const unsigned int width, const unsigned int height)
+	: cg::image_base(width, height), tiles_x(0), tiles_y(0), regions_x(0), regions_y(0)
+{
+	resizeImage();
+	initialize();
+}
+
+void cg::render_target::initialize()
+{
+	clear({ 0.0f, 0.0f, 0.0f, 0.0f }, std::numeric_limits<float>::max());
+}
+
+void cg::render_target::clear(const color_type& color, const float depth)
+{
+	std::fill(this->m_color.begin(), this->m_color.end(), color);
+	std::fill(this->m_depth.begin(), this->m_depth.end(), depth);
+
+	std::fill(this->m_tile_min.begin(), this->m_tile_min.end(), depth);
+	std::fill(this->m_tile_max.begin(), this->m_tile_max.end(), depth);
+	std::fill(this->m_region_max.begin(), this->m_region_max.end(), depth);
+}
+
+void cg::render_target::update_max_depth(const unsigned int x, const unsigned int y)
+{
+	const auto tile = tile_index(x, y);
+	const auto first = this->m_depth.begin() + tile * (tile_size * tile_size);
+
+	// Ignore the padding of tiles at the right and bottom border, which is never drawn to
+	const auto columns = std::min(tile_size, this->width - (x / tile_size) * tile_size);
+	const auto rows = std::min(tile_size, this->height - (y / tile_size) * tile_size);
+
+	const auto old_max = this->m_tile_max[tile];
+	auto new_max = *std::max_element(first, first + columns);
+
+	for (unsigned int row = 1; row < rows; ++row)
+	{
+		new_max = std::max(new_max, *std::max_element(first + row * tile_size, first + row * tile_size + columns));
+	}
+
+	this->m_tile_max[tile] = new_max;
+
+	// The region's maximum can only change if this tile defined it
+	auto& region_max = this->m_region_max[region_index(x, y)];
+
+	if (new_max < old_max && old_max >= region_max)
+	{
+		const auto tile_x_begin = (x / region_size) * tile_size;
+		const auto tile_y_begin = (y / region_size) * tile_size;
+		const auto tile_x_end = std::min(tile_x_begin + tile_size, this->tiles_x);
+		const auto tile_y_end = std::min(tile_y_begin + tile_size, this->tiles_y);
+
+		auto max = new_max;
+
+		for (auto tile_y = tile_y_begin; tile_y < tile_y_end; ++tile_y)
+		{
+			const auto row = this->m_tile_max.begin() + tile_y * this->tiles_x;
+			max = std::max(max, *std::max_element(row + tile_x_begin, row + tile_x_end));
+		}
+
+		region_max = max;
+	}
+}
+
+bool cg::render_target::is_occluded(const unsigned int x_min, const unsigned int y_min, const unsigned int x_max, const unsigned int y_max, const float depth) const
+{
+	// Use the region's depth if the rectangle covers it completely, otherwise test the covered tiles
+	for (auto region_y = y_min / region_size; region_y <= y_max / region_size; ++region_y)
+	{
+		for (auto region_x = x_min / region_size; region_x <= x_max / region_size; ++region_x)
+		{
+			const auto x_begin = std::max(region_x * region_size, x_min);
+			const auto y_begin = std::max(region_y * region_size, y_min);
+			const auto x_end = std::min(region_x * region_size + region_size - 1, x_max);
+			const auto y_end = std::min(region_y * region_size + region_size - 1, y_max);
+
+			if (depth <= this->m_region_max[region_y * this->regions_x + region_x])
+			{
+				if (x_end - x_begin + 1 == region_size && y_end - y_begin + 1 == region_size)
+				{
+					return false;
+				}
+
+				for (auto tile_y = y_begin / tile_size; tile_y <= y_end / tile_size; ++tile_y)
+				{
+					for (auto tile_x = x_begin / tile_size; tile_x <= x_end / tile_size; ++tile_x)
+					{
+						if (depth <= this->m_tile_max[tile_y * this->tiles_x + tile_x])
+						{
+							return false;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void cg::render_target::resolve(image<color_space_t::RGBA>& target) const
+{
+	check_size(target);
+
+	const auto width = this->width;
+	auto* data = target.data();
+
+	// Copy row by row, taking contiguous runs of up to tile_size pixels out of each tile
+	for (unsigned int y = 0; y < this->height; ++y)
+	{
+		for (unsigned int x = 0; x < width; x += tile_size)
+		{
+			const auto run = std::min(tile_size, width - x);
+			const auto* source = &this->m_color[index(x, y)];
+
+			std::copy(source, source + run, data + y * width + x);
+		}
+	}
+}
+
+unsigned long long cg::render_target::resolve(image<color_space_t::RGBA>& target, const color_type& color, const float depth)
+{
+	return resolve(target, color, depth, 0, this->height);
+}
+
+unsigned long long cg::render_target::resolve(image<color_space_t::RGBA>& target, const color_type& color, const float depth,
+	const unsigned int y_begin, const unsigned int y_end)
+{
+	check_size(target);
+
+	if (y_begin % region_size != 0 || y_end < y_begin || y_end > this->height || (y_end % region_size != 0 && y_end != this->height))
+	{
+		throw std::runtime_error("Band of the render target must consist of whole regions");
+	}
+
+	const auto width = this->width;
+	auto* data = target.data();
+
+	unsigned long long covered = 0;
+
+	// Copy tile by tile and clear each tile while it is still in the cache,
+	// which saves a separate pass over the whole buffer
+	for (auto tile_y_begin = y_begin; tile_y_begin < y_end; tile_y_begin += tile_size)
+	{
+		const auto tile_y_end = std::min(tile_y_begin + tile_size, y_end);
+
+		for (unsigned int x = 0; x < width; x += tile_size)
+		{
+			const auto run = std::min(tile_size, width - x);
+			const auto tile = index(x, tile_y_begin);
+
+			for (auto y = tile_y_begin; y < tile_y_end; ++y)
+			{
+				const auto* source = &this->m_color[tile + (y - tile_y_begin) * tile_size];
+				std::copy(source, source + run, data + y * width + x);
+			}
+
+			covered += std::count_if(this->m_depth.begin() + tile, this->m_depth.begin() + tile + tile_size * tile_size,
+				[depth](const float value) { return value != depth; });
+
+			std::fill_n(this->m_color.begin() + tile, tile_size * tile_size, color);
+			std::fill_n(this->m_depth.begin() + tile, tile_size * tile_size, depth);
+
+			this->m_tile_min[tile_index(x, tile_y_begin)] = depth;
+			this->m_tile_max[tile_index(x, tile_y_begin)] = depth;
+		}
+	}
+
+	std::fill(this->m_region_max.begin() + (y_begin / region_size) * this->regions_x,
+		this->m_region_max.begin() + ((y_end + region_size - 1) / region_size) * this->regions_x, depth);
+
+	return covered;
+}
+
+void cg::render_target::check_size(const image<color_space_t::RGBA>& target) const
+{
+	if (target.get_width() != this->width || target.get_height() != this->height)
+	{
+		throw std::runtime_error("Image size does not match the render target");
+	}
+}
+
+void cg::render_target::resizeImage()
+{
+	this->tiles_x = (this->width + tile_size - 1) / tile_size;
+	this->tiles_y = (this->height + tile_size - 1) / tile_size;
+	this->regions_x = (this->width + region_size - 1) / region_size;
+	this->regions_y = (this->height + region_size - 1) / region_size;
+
+	this->m_color.resize(this->tiles_x * this->tiles_y * tile_size * tile_size);
+	this->m_depth.resize(this->tiles_x * this->tiles_y * tile_size * tile_size);
+
+	this->m_tile_min.resize(this->tiles_x * this->tiles_y);
+	this->m_tile_max.resize(this->tiles_x * this->tiles_y);
+	this->m_region_max.resize(this->regions_x * this->regions_y);
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "Image.h"
+#include "ImageBase.h"
+
+#include <array>
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Color and depth buffer for the rasterizer
+	///
+	/// The pixels are stored in square tiles, tile after tile and row-major within a tile,
+	/// so that a screen block of the rasterizer lies in a few consecutive cache lines.
+	/// The accessors do not check their arguments; the caller is responsible for passing
+	/// coordinates within the image.
+	///
+	/// Alongside the depth buffer, a depth pyramid keeps the nearest and farthest depth per tile,
+	/// and the farthest depth per region of tile_size x tile_size tiles. The minimum is exact, as it
+	/// is updated on every depth write. The maxima are only recalculated by update_max_depth() and
+	/// are therefore conservative, i.e., never smaller than the farthest stored depth.
+	/// </summary>
+	class render_target : public image_base
+	{
+	public:
+		/// Edge length of a storage tile
+		static constexpr unsigned int tile_size = 8;
+
+		/// Edge length of a region of the coarse depth pyramid level
+		static constexpr unsigned int region_size = tile_size * tile_size;
+
+		/// Tuple type for storing the color channels of a pixel
+		using color_type = std::array<float, 4>;
+
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="width">Image width</param>
+		/// <param name="height">Image height</param>
+		render_target(unsigned int width, unsigned int height);
+
+		/// <summary>
+		/// Clear color to zero and depth to the maximum float value
+		/// </summary>
+		virtual void initialize();
+
+		/// <summary>
+		/// Clear color and depth buffer with the given values
+		/// </summary>
+		/// <param name="color">Clear color</param>
+		/// <param name="depth">Clear depth</param>
+		void clear(const color_type& color, float depth);
+
+		/// <summary>
+		/// Access color and depth of a pixel without bounds check
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <returns>Color / depth</returns>
+		const color_type& color(unsigned int x, unsigned int y) const;
+		color_type& color(unsigned int x, unsigned int y);
+
+		float depth(unsigned int x, unsigned int y) const;
+
+		/// <summary>
+		/// Set the depth of a pixel, which must not be farther than the stored one
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <param name="depth">Depth</param>
+		void set_depth(unsigned int x, unsigned int y, float depth);
+
+		/// <summary>
+		/// Get the nearest and farthest depth of the tile containing the given pixel
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <returns>Minimum / maximum depth</returns>
+		float tile_min_depth(unsigned int x, unsigned int y) const;
+		float tile_max_depth(unsigned int x, unsigned int y) const;
+
+		/// <summary>
+		/// Recalculate the farthest depth of the tile containing the given pixel, and of its region
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		void update_max_depth(unsigned int x, unsigned int y);
+
+		/// <summary>
+		/// Test whether a depth lies behind all depths stored within a rectangle
+		/// </summary>
+		/// <param name="x_min">First column</param>
+		/// <param name="y_min">First row</param>
+		/// <param name="x_max">Last column</param>
+		/// <param name="y_max">Last row</param>
+		/// <param name="depth">Nearest depth of the tested primitive</param>
+		/// <returns>True if the primitive is hidden</returns>
+		bool is_occluded(unsigned int x_min, unsigned int y_min, unsigned int x_max, unsigned int y_max, float depth) const;
+
+		/// <summary>
+		/// Copy the colors into a linear, row-major RGBA image of the same size
+		/// </summary>
+		/// <param name="target">Target image</param>
+		void resolve(image<color_space_t::RGBA>& target) const;
+
+		/// <summary>
+		/// Copy the colors into a linear, row-major RGBA image of the same size,
+		/// and clear each tile right after copying it, while it is still cached
+		/// </summary>
+		/// <param name="target">Target image</param>
+		/// <param name="color">Clear color</param>
+		/// <param name="depth">Clear depth</param>
+		/// <returns>Number of pixels whose depth differed from the clear depth, i.e., which were drawn since the last clear</returns>
+		unsigned long long resolve(image<color_space_t::RGBA>& target, const color_type& color, float depth);
+
+		/// <summary>
+		/// Copy and clear a band of rows like resolve(target, color, depth), e.g., on one of several threads;
+		/// bands resolved at the same time must not overlap and must start at multiples of region_size,
+		/// so that each band clears whole regions of the depth pyramid
+		/// </summary>
+		/// <param name="target">Target image</param>
+		/// <param name="color">Clear color</param>
+		/// <param name="depth">Clear depth</param>
+		/// <param name="y_begin">First row, a multiple of region_size</param>
+		/// <param name="y_end">Row after the last one, a multiple of region_size or the image height</param>
+		/// <returns>Number of pixels of the band whose depth differed from the clear depth</returns>
+		unsigned long long resolve(image<color_space_t::RGBA>& target, const color_type& color, float depth, unsigned int y_begin, unsigned int y_end);
+
+	protected:
+		virtual void resizeImage();
+
+	private:
+		/// <summary>
+		/// Calculate the storage index of a pixel
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <returns>Pixel index</returns>
+		unsigned int index(unsigned int x, unsigned int y) const;
+
+		/// <summary>
+		/// Throw if the image size does not match the render target
+		/// </summary>
+		/// <param name="target">Target image</param>
+		void check_size(const image<color_space_t::RGBA>& target) const;
+
+		/// <summary>
+		/// Calculate the index of the tile or region containing a pixel
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <returns>Tile / region index</returns>
+		unsigned int tile_index(unsigned int x, unsigned int y) const;
+		unsigned int region_index(unsigned int x, unsigned int y) const;
+
+		/// Number of tiles and regions per row and column
+		unsigned int tiles_x, tiles_y;
+		unsigned int regions_x, regions_y;
+
+		/// Color and depth data, including the padding of the right and bottom tiles
+		std::vector<color_type> m_color;
+		std::vector<float> m_depth;
+
+		/// Depth pyramid: nearest and farthest depth per tile, and farthest depth per region
+		std::vector<float> m_tile_min, m_tile_max;
+		std::vector<float> m_region_max;
+	};
+}
+
+inline unsigned int cg::render_target::tile_index(const unsigned int x, const unsigned int y) const
+{
+	return (y / tile_size) * this->tiles_x + (x / tile_size);
+}
+
+inline unsigned int cg::render_target::region_index(const unsigned int x, const unsigned int y) const
+{
+	return (y / region_size) * this->regions_x + (x / region_size);
+}
+
+inline unsigned int cg::render_target::index(const unsigned int x, const unsigned int y) const
+{
+	return tile_index(x, y) * (tile_size * tile_size) + (y % tile_size) * tile_size + (x % tile_size);
+}
+
+inline const cg::render_target::color_type& cg::render_target::color(const unsigned int x, const unsigned int y) const
+{
+	return this->m_color[index(x, y)];
+}
+
+inline cg::render_target::color_type& cg::render_target::color(const unsigned int x, const unsigned int y)
+{
+	return this->m_color[index(x, y)];
+}
+
+inline float cg::render_target::depth(const unsigned int x, const unsigned int y) const
+{
+	return this->m_depth[index(x, y)];
+}
+
+inline void cg::render_target::set_depth(const unsigned int x, const unsigned int y, const float depth)
+{
+	this->m_depth[index(x, y)] = depth;
+
+	auto& tile_min = this->m_tile_min[tile_index(x, y)];
+
+	tile_min = (depth < tile_min) ? depth : tile_min;
+}
+
+inline float cg::render_target::tile_min_depth(const unsigned int x, const unsigned int y) const
+{
+	return this->m_tile_min[tile_index(x, y)];
+}
+
+inline float cg::render_target::tile_max_depth(const unsigned int x, const unsigned int y) const
+{
+	return this->m_tile_max[tile_index(x, y)];
+}
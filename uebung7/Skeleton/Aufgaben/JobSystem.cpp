@@ -0,0 +1,233 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+	/// Job system whose worker is the calling thread, and the index of the worker's queue
+	thread_local const cg::JobSystem* currentSystem = nullptr;
+	thread_local unsigned int currentQueue = 0;
+}
+
+// Definition of the constant, which std::max binds to a reference
+constexpr std::size_t cg::JobSystem::initialQueueSize;
+
+cg::JobSystem::JobSystem(const unsigned int threadCount) : queued(0), sleeping(0), stopping(false)
+{
+	start(threadCount);
+}
+
+cg::JobSystem::~JobSystem()
+{
+	stop();
+}
+
+unsigned int cg::JobSystem::getThreadCount() const
+{
+	return static_cast<unsigned int>(this->queues.size());
+}
+
+void cg::JobSystem::setThreadCount(const unsigned int threadCount)
+{
+	stop();
+	start(threadCount);
+}
+
+void cg::JobSystem::reserve(const std::size_t jobCount)
+{
+	auto& queue = *this->queues[getQueueIndex()];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	if (queue.jobs.size() < jobCount)
+	{
+		grow(queue, jobCount);
+	}
+}
+
+void cg::JobSystem::push(const Job& job)
+{
+	job.group->pending.fetch_add(1);
+
+	{
+		auto& queue = *this->queues[getQueueIndex()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		// A full ring buffer is replaced by one of twice the size
+		if (queue.count == queue.jobs.size())
+		{
+			grow(queue, std::max(2 * queue.jobs.size(), initialQueueSize));
+		}
+
+		queue.jobs[(queue.front + queue.count) % queue.jobs.size()] = job;
+		++queue.count;
+	}
+
+	this->queued.fetch_add(1);
+
+	// A worker going to sleep registers before checking for queued jobs, so it either sees the job or is woken up
+	if (this->sleeping.load() != 0)
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex);
+		this->wakeUp.notify_one();
+	}
+}
+
+void cg::JobSystem::grow(Queue& queue, const std::size_t size)
+{
+	std::vector<Job> jobs(size);
+
+	for (std::size_t i = 0; i < queue.count; ++i)
+	{
+		jobs[i] = queue.jobs[(queue.front + i) % queue.jobs.size()];
+	}
+
+	queue.jobs.swap(jobs);
+	queue.front = 0;
+}
+
+void cg::JobSystem::wait(Group& group)
+{
+	const auto index = getQueueIndex();
+
+	Job job;
+
+	while (group.pending.load() != 0)
+	{
+		if (take(index, job))
+		{
+			execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void cg::JobSystem::start(const unsigned int threadCount)
+{
+	const auto count = threadCount != 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		this->queues.push_back(std::unique_ptr<Queue>(new Queue()));
+		this->queues.back()->jobs.resize(initialQueueSize);
+	}
+
+	for (unsigned int i = 1; i < count; ++i)
+	{
+		this->workers.push_back(std::thread(&JobSystem::work, this, i));
+	}
+}
+
+void cg::JobSystem::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex);
+		this->stopping = true;
+	}
+
+	this->wakeUp.notify_all();
+
+	for (auto& worker : this->workers)
+	{
+		worker.join();
+	}
+
+	// Without workers, the jobs of the first queue are left over
+	Job job;
+
+	while (take(0, job))
+	{
+		execute(job);
+	}
+
+	this->workers.clear();
+	this->queues.clear();
+	this->stopping = false;
+}
+
+void cg::JobSystem::work(const unsigned int index)
+{
+	currentSystem = this;
+	currentQueue = index;
+
+	Job job;
+
+	while (true)
+	{
+		if (take(index, job))
+		{
+			execute(job);
+
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->sleepMutex);
+
+		this->sleeping.fetch_add(1);
+		this->wakeUp.wait(lock, [this]() { return this->stopping || this->queued.load() != 0; });
+		this->sleeping.fetch_sub(1);
+
+		if (this->stopping && this->queued.load() == 0)
+		{
+			return;
+		}
+	}
+}
+
+bool cg::JobSystem::take(const unsigned int index, Job& job)
+{
+	if (this->queued.load() == 0)
+	{
+		return false;
+	}
+
+	// The own queue's last job is the most likely one to find its data in the cache
+	{
+		auto& queue = *this->queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (queue.count != 0)
+		{
+			--queue.count;
+			job = queue.jobs[(queue.front + queue.count) % queue.jobs.size()];
+			this->queued.fetch_sub(1);
+
+			return true;
+		}
+	}
+
+	// Steal the oldest job of another queue, which usually stands for the largest remaining amount of work
+	const auto count = static_cast<unsigned int>(this->queues.size());
+
+	for (unsigned int offset = 1; offset < count; ++offset)
+	{
+		auto& queue = *this->queues[(index + offset) % count];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (queue.count != 0)
+		{
+			job = queue.jobs[queue.front];
+			queue.front = (queue.front + 1) % queue.jobs.size();
+			--queue.count;
+			this->queued.fetch_sub(1);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void cg::JobSystem::execute(Job& job)
+{
+	job.invoke(job);
+
+	job.group->pending.fetch_sub(1);
+}
+
+unsigned int cg::JobSystem::getQueueIndex() const
+{
+	return currentSystem == this ? currentQueue : 0;
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Pool of worker threads executing jobs with work stealing
+	///
+	/// Each thread owns a queue: it takes its jobs from the back of its own queue, i.e., the ones it
+	/// submitted last, and steals from the front of the other threads' queues when it runs out of work.
+	/// Jobs may submit further jobs, e.g., to continue with the next stage once the last job of the
+	/// current one is done. The thread waiting for a group of jobs executes jobs as well, so a pool
+	/// with n threads starts n - 1 workers.
+	///
+	/// Jobs are stored by value in ring buffers, which only grow, so submitting jobs does not allocate
+	/// memory once the queues are large enough. Therefore, the functions of jobs are limited in size and
+	/// must be trivially copyable, e.g., lambdas capturing only pointers, references and numbers.
+	/// </summary>
+	class JobSystem
+	{
+	public:
+		/// <summary>
+		/// Set of jobs which can be waited for
+		/// </summary>
+		class Group
+		{
+		public:
+			Group() : pending(0) { }
+
+		private:
+			friend class JobSystem;
+
+			/// Number of jobs submitted to the group, which have not finished yet
+			std::atomic<unsigned int> pending;
+		};
+
+		/// Maximum size in bytes of the function of a job, including its captures
+		static constexpr std::size_t maxFunctionSize = 64;
+
+		/// Number of jobs each queue has room for from the start, so that the first frames of the workers do not grow them
+		static constexpr std::size_t initialQueueSize = 256;
+
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="threadCount">Number of threads including the waiting one, 0 for one per hardware thread</param>
+		explicit JobSystem(unsigned int threadCount = 0);
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		/// <summary>
+		/// Destructor, finishing the queued jobs before stopping the workers
+		/// </summary>
+		~JobSystem();
+
+		/// <summary>
+		/// Get the number of threads executing jobs, including the waiting one
+		/// </summary>
+		/// <returns>Number of threads</returns>
+		unsigned int getThreadCount() const;
+
+		/// <summary>
+		/// Change the number of threads; must not be called while jobs are running
+		/// </summary>
+		/// <param name="threadCount">Number of threads including the waiting one, 0 for one per hardware thread</param>
+		void setThreadCount(unsigned int threadCount);
+
+		/// <summary>
+		/// Make room in the calling thread's queue, so that queuing up to a number of jobs at once does not allocate; thread-safe
+		/// </summary>
+		/// <param name="jobCount">Number of jobs</param>
+		void reserve(std::size_t jobCount);
+
+		/// <summary>
+		/// Queue a job; thread-safe, also from within jobs
+		/// </summary>
+		/// <param name="group">Group the job belongs to</param>
+		/// <param name="function">Function executed by the job</param>
+		template <typename Function>
+		void submit(Group& group, const Function& function);
+
+		/// <summary>
+		/// Queue jobs for a range of indices, each covering up to grainSize consecutive indices
+		/// </summary>
+		/// <param name="group">Group the jobs belong to</param>
+		/// <param name="begin">First index</param>
+		/// <param name="end">Index after the last one</param>
+		/// <param name="grainSize">Maximum number of indices per job</param>
+		/// <param name="function">Function called with the first index and the index after the last one of each job</param>
+		template <typename Function>
+		void submitRange(Group& group, int begin, int end, int grainSize, const Function& function);
+
+		/// <summary>
+		/// Execute jobs until all jobs of a group, including the ones they submitted, have finished
+		/// </summary>
+		/// <param name="group">Group</param>
+		void wait(Group& group);
+
+	private:
+		/// Queued job: a copy of its function, the function calling it with the job's range of indices, and the group it belongs to
+		struct Job
+		{
+			alignas(16) unsigned char function[maxFunctionSize];
+			void (*invoke)(const Job& job);
+			int first;
+			int last;
+			Group* group;
+		};
+
+		/// Queue of a thread, a ring buffer of jobs which grows when it is full
+		struct Queue
+		{
+			std::mutex mutex;
+			std::vector<Job> jobs;
+			std::size_t front = 0;
+			std::size_t count = 0;
+		};
+
+		/// <summary>
+		/// Queue a job in the calling thread's queue and wake up a worker
+		/// </summary>
+		/// <param name="job">Job</param>
+		void push(const Job& job);
+
+		/// <summary>
+		/// Replace the ring buffer of a locked queue by a larger one, starting with its front job
+		/// </summary>
+		/// <param name="queue">Queue</param>
+		/// <param name="size">New number of jobs the queue has room for</param>
+		static void grow(Queue& queue, std::size_t size);
+
+		/// <summary>
+		/// Start the workers
+		/// </summary>
+		/// <param name="threadCount">Number of threads including the waiting one, 0 for one per hardware thread</param>
+		void start(unsigned int threadCount);
+
+		/// <summary>
+		/// Finish the queued jobs and stop the workers
+		/// </summary>
+		void stop();
+
+		/// <summary>
+		/// Main loop of a worker
+		/// </summary>
+		/// <param name="index">Index of the worker's queue</param>
+		void work(unsigned int index);
+
+		/// <summary>
+		/// Take a job from the back of the own queue, or steal one from the front of another queue
+		/// </summary>
+		/// <param name="index">Index of the own queue</param>
+		/// <param name="job">Taken job</param>
+		/// <returns>False if all queues are empty</returns>
+		bool take(unsigned int index, Job& job);
+
+		/// <summary>
+		/// Execute a job and mark it as finished
+		/// </summary>
+		/// <param name="job">Job</param>
+		void execute(Job& job);
+
+		/// <summary>
+		/// Get the queue index of the calling thread; threads which are no workers share the first queue
+		/// </summary>
+		/// <returns>Queue index</returns>
+		unsigned int getQueueIndex() const;
+
+		/// One queue per thread, the first one for the waiting threads
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> workers;
+
+		/// Number of queued jobs and of sleeping workers, which are only woken up if there are any
+		std::atomic<unsigned int> queued;
+		std::atomic<unsigned int> sleeping;
+		std::mutex sleepMutex;
+		std::condition_variable wakeUp;
+		bool stopping;
+	};
+}
+
+template <typename Function>
+void cg::JobSystem::submit(Group& group, const Function& function)
+{
+	submitRange(group, 0, 1, 1, [function](int, int) { function(); });
+}
+
+template <typename Function>
+void cg::JobSystem::submitRange(Group& group, const int begin, const int end, const int grainSize, const Function& function)
+{
+	static_assert(sizeof(Function) <= maxFunctionSize && alignof(Function) <= 16, "The function of a job must fit into the job");
+	static_assert(std::is_trivially_copyable<Function>::value, "Jobs are copied without calling the constructors of their functions");
+
+	Job job;
+	new (job.function) Function(function);
+	job.invoke = [](const Job& queued) { (*reinterpret_cast<const Function*>(queued.function))(queued.first, queued.last); };
+	job.group = &group;
+
+	for (auto first = begin; first < end; first += grainSize)
+	{
+		job.first = first;
+		job.last = std::min(first + grainSize, end);
+
+		push(job);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "LightSetup.h"
+
+void cg::setupLights(const std::vector<std::shared_ptr<LightObject>>& lights, LightSetup& setup)
+{
+	setup.ambient = black();
+
+	setup.position_x.clear();
+	setup.position_y.clear();
+	setup.position_z.clear();
+	setup.color_r.clear();
+	setup.color_g.clear();
+	setup.color_b.clear();
+	setup.color_a.clear();
+
+	for (const auto& light : lights)
+	{
+		if (!light->isVisible())
+		{
+			continue;
+		}
+
+		// The ray of a point light points from the light to the object, so its position follows from the ray to the origin
+		const auto colorInfo = light->getColor(zeroVec3());
+		const auto color = colorInfo.color * colorInfo.intensity;
+
+		if (colorInfo.ambient)
+		{
+			setup.ambient += color;
+		}
+		else
+		{
+			setup.position_x.push_back(-colorInfo.ray.x);
+			setup.position_y.push_back(-colorInfo.ray.y);
+			setup.position_z.push_back(-colorInfo.ray.z);
+			setup.color_r.push_back(color.r);
+			setup.color_g.push_back(color.g);
+			setup.color_b.push_back(color.b);
+			setup.color_a.push_back(color.a);
+		}
+	}
+}
+
+void cg::lightVertices(const LightSetup& setup, const std::array<simd::float_v, 3>& position, const std::array<simd::float_v, 3>& normal,
+	std::array<simd::float_v, 4>& light)
+{
+	using simd::float_v;
+
+	light = { float_v(setup.ambient.r), float_v(setup.ambient.g), float_v(setup.ambient.b), float_v(setup.ambient.a) };
+
+	// The length of the normal does not depend on the light
+	const auto normal_length = simd::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+	const float_v epsilon(0.001f);
+
+	for (std::size_t i = 0; i < setup.position_x.size(); ++i)
+	{
+		// Ray from the light to the vertices
+		const auto ray_x = position[0] - float_v(setup.position_x[i]);
+		const auto ray_y = position[1] - float_v(setup.position_y[i]);
+		const auto ray_z = position[2] - float_v(setup.position_z[i]);
+
+		const auto distance = simd::sqrt(ray_x * ray_x + ray_y * ray_y + ray_z * ray_z);
+
+		// Cosine of the angle between normal and the direction to the light, attenuated by the squared distance
+		const auto dot = float_v(0.0f) - (ray_x * normal[0] + ray_y * normal[1] + ray_z * normal[2]);
+		const auto factor = dot * normal_length / (distance * (epsilon + distance) * distance);
+
+		light[0] = light[0] + float_v(setup.color_r[i]) * factor;
+		light[1] = light[1] + float_v(setup.color_g[i]) * factor;
+		light[2] = light[2] + float_v(setup.color_b[i]) * factor;
+		light[3] = light[3] + float_v(setup.color_a[i]) * factor;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Math.h"
+#include "Simd.h"
+#include "Scene/Lights/LightObject.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Visible lights of a frame, flattened into one array per component, so that the vertices can be lit
+	/// without virtual calls and for several vertices at once
+	/// </summary>
+	struct LightSetup
+	{
+		/// Sum of the colors times intensity of all ambient lights
+		Color ambient;
+
+		/// World space positions of the point lights
+		std::vector<float> position_x, position_y, position_z;
+
+		/// Colors times intensity of the point lights
+		std::vector<float> color_r, color_g, color_b, color_a;
+	};
+
+	/// <summary>
+	/// Collect the visible lights of a scene
+	/// </summary>
+	/// <param name="lights">Light sources</param>
+	/// <param name="setup">Resulting light setup</param>
+	void setupLights(const std::vector<std::shared_ptr<LightObject>>& lights, LightSetup& setup);
+
+	/// <summary>
+	/// Sum up the light arriving at a batch of vertices (ambient, and Lambert's law with quadratic falloff for point lights)
+	/// </summary>
+	/// <param name="setup">Light setup</param>
+	/// <param name="position">World space positions (x, y, z)</param>
+	/// <param name="normal">Normals (x, y, z)</param>
+	/// <param name="light">Resulting light per color channel, to be multiplied with the vertex colors</param>
+	void lightVertices(const LightSetup& setup, const std::array<simd::float_v, 3>& position, const std::array<simd::float_v, 3>& normal,
+		std::array<simd::float_v, 4>& light);
+}
\ No newline at end of file
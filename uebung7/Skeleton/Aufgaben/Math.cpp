@@ -1,5 +1,6 @@
 #include "Math.h"
 
+#include <algorithm>
 #include <cmath>
 
 float cg::pi()
@@ -170,6 +171,98 @@ cg::Triangle2D::Triangle2D(const cg::Triangle& other)
 	};
 }
 
+cg::TriangleMesh cg::expandMesh(const IndexedMesh& mesh)
+{
+	TriangleMesh expanded(mesh.indices.size() / 3);
+
+	for (std::size_t i = 0; i < expanded.size(); ++i)
+	{
+		expanded[i].points = {
+			mesh.vertices[mesh.indices[3 * i + 0]],
+			mesh.vertices[mesh.indices[3 * i + 1]],
+			mesh.vertices[mesh.indices[3 * i + 2]] };
+	}
+
+	return expanded;
+}
+
+cg::BoundingSphere cg::calculateBoundingSphere(const IndexedMesh& mesh)
+{
+	if (mesh.vertices.empty())
+	{
+		return BoundingSphere{ zeroVec3(), 0.0f };
+	}
+
+	// Center of the axis-aligned bounding box, and the farthest vertex from it
+	auto lower = mesh.vertices.front().position;
+	auto upper = lower;
+
+	for (const auto& vertex : mesh.vertices)
+	{
+		lower = glm::min(lower, vertex.position);
+		upper = glm::max(upper, vertex.position);
+	}
+
+	const Point3D center = 0.5f * (lower + upper);
+	float radius = 0.0f;
+
+	for (const auto& vertex : mesh.vertices)
+	{
+		radius = std::max(radius, glm::length(vertex.position - center));
+	}
+
+	return BoundingSphere{ center, radius };
+}
+
+cg::BoundingSphere cg::transformBoundingSphere(const BoundingSphere& sphere, const mat4& transformation)
+{
+	// Scale the radius by the largest scaling of the axes
+	const auto scale = std::max({ glm::length(vec3(transformation[0])), glm::length(vec3(transformation[1])), glm::length(vec3(transformation[2])) });
+
+	return BoundingSphere{ Point3D(transformation * vec4(sphere.center, 1.0f)), sphere.radius * scale };
+}
+
+cg::BoundingSphere cg::mergeBoundingSpheres(const std::vector<BoundingSphere>& spheres)
+{
+	if (spheres.empty())
+	{
+		return BoundingSphere{ zeroVec3(), 0.0f };
+	}
+
+	// Center of the axis-aligned bounding box of all spheres, and the radius reaching the farthest sphere
+	auto lower = spheres.front().center - vec3(spheres.front().radius);
+	auto upper = spheres.front().center + vec3(spheres.front().radius);
+
+	for (const auto& sphere : spheres)
+	{
+		lower = glm::min(lower, sphere.center - vec3(sphere.radius));
+		upper = glm::max(upper, sphere.center + vec3(sphere.radius));
+	}
+
+	const Point3D center = 0.5f * (lower + upper);
+	float radius = 0.0f;
+
+	for (const auto& sphere : spheres)
+	{
+		radius = std::max(radius, glm::length(sphere.center - center) + sphere.radius);
+	}
+
+	return BoundingSphere{ center, radius };
+}
+
+bool cg::isOutside(const BoundingSphere& sphere, const std::array<vec4, 6>& planes)
+{
+	for (const auto& plane : planes)
+	{
+		if (glm::dot(vec3(plane), sphere.center) + plane.w < -sphere.radius)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 namespace
 {
 	bool sameSide(const cg::Point2D& first, const cg::Point2D& second, const cg::Point2D& line_start, const cg::Point2D& line_end)
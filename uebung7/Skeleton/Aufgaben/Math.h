@@ -95,6 +95,32 @@ namespace cg
 
 	using TriangleMesh = std::vector<Triangle>;
 
+	/// Mesh of shared vertices; each three consecutive indices form a triangle
+	struct IndexedMesh
+	{
+		using vertex_type = Triangle::Point;
+		using index_type = unsigned int;
+
+		std::vector<vertex_type> vertices;
+		std::vector<index_type> indices;
+	};
+
+	/// Sphere enclosing an object
+	struct BoundingSphere
+	{
+		Point3D center;
+		float radius;
+	};
+
+	// Functions for meshes
+	TriangleMesh expandMesh(const IndexedMesh& mesh);
+	BoundingSphere calculateBoundingSphere(const IndexedMesh& mesh);
+	BoundingSphere transformBoundingSphere(const BoundingSphere& sphere, const mat4& transformation);
+	BoundingSphere mergeBoundingSpheres(const std::vector<BoundingSphere>& spheres);
+
+	// Test whether a sphere lies completely outside of one of the (normalized, inwards pointing) planes
+	bool isOutside(const BoundingSphere& sphere, const std::array<vec4, 6>& planes);
+
 	// Functions for triangles
 	bool pointInTriangle(const Triangle2D& triangle, const Point2D& position);
 	vec3 calculateBarycentricCoords(const Triangle2D& triangle, const Point2D& position);
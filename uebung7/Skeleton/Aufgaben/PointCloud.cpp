@@ -0,0 +1,115 @@
+#include "PointCloud.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+
+namespace
+{
+	/// Number of batches of points per job
+	const int splatJobBatches = 1024;
+}
+
+void cg::PointCloud::addPoint(const Point3D& position, const Color& pointColor)
+{
+	this->position_x.push_back(position.x);
+	this->position_y.push_back(position.y);
+	this->position_z.push_back(position.z);
+	this->color.push_back(point_buffer::pack_color({ pointColor.r, pointColor.g, pointColor.b, pointColor.a }));
+}
+
+std::size_t cg::PointCloud::size() const
+{
+	return this->color.size();
+}
+
+unsigned long long cg::splatPointCloud(const PointCloud& cloud, const mat4& transformation, point_buffer& buffer, JobSystem& jobs)
+{
+	using simd::float_v;
+
+	const int numPoints = static_cast<int>(cloud.size());
+	const int numBatches = (numPoints + static_cast<int>(float_v::size) - 1) / static_cast<int>(float_v::size);
+
+	const auto width = static_cast<float>(buffer.get_width());
+	const auto height = static_cast<float>(buffer.get_height());
+
+	// Rows of the transformation, so that each clip space component is a dot product with the position
+	std::array<std::array<float_v, 4>, 4> rows;
+
+	for (unsigned int row = 0; row < 4; ++row)
+	{
+		for (unsigned int column = 0; column < 4; ++column)
+		{
+			rows[row][column] = float_v(transformation[column][row]);
+		}
+	}
+
+	std::atomic<unsigned long long> visible(0);
+
+	JobSystem::Group group;
+
+	jobs.submitRange(group, 0, numBatches, splatJobBatches, [&cloud, &rows, &buffer, &visible, numPoints, width, height](const int begin, const int end)
+	{
+		unsigned long long jobVisible = 0;
+
+		for (int batch = begin; batch < end; ++batch)
+		{
+			const auto first = batch * static_cast<int>(float_v::size);
+			const auto lanes = std::min(static_cast<int>(float_v::size), numPoints - first);
+
+			// Transform a full batch to clip space, padding the last one
+			alignas(32) std::array<std::array<float, float_v::size>, 3> position = {};
+
+			for (int lane = 0; lane < lanes; ++lane)
+			{
+				position[0][lane] = cloud.position_x[first + lane];
+				position[1][lane] = cloud.position_y[first + lane];
+				position[2][lane] = cloud.position_z[first + lane];
+			}
+
+			const auto x = float_v::load(position[0].data());
+			const auto y = float_v::load(position[1].data());
+			const auto z = float_v::load(position[2].data());
+
+			alignas(32) std::array<std::array<float, float_v::size>, 4> clip;
+
+			for (unsigned int row = 0; row < 4; ++row)
+			{
+				(rows[row][0] * x + rows[row][1] * y + rows[row][2] * z + rows[row][3]).store(clip[row].data());
+			}
+
+			// Splat the points within the view frustum
+			for (int lane = 0; lane < lanes; ++lane)
+			{
+				const auto clip_x = clip[0][lane];
+				const auto clip_y = clip[1][lane];
+				const auto clip_z = clip[2][lane];
+				const auto clip_w = clip[3][lane];
+
+				if (!(clip_x > -clip_w && clip_x < clip_w && clip_y > -clip_w && clip_y < clip_w && clip_z > -clip_w && clip_z < clip_w))
+				{
+					continue;
+				}
+
+				const auto screen_x = static_cast<unsigned int>((clip_x / clip_w * 0.5f + 0.5f) * width + 0.5f);
+				const auto screen_y = static_cast<unsigned int>((clip_y / clip_w * -0.5f + 0.5f) * height + 0.5f);
+
+				// Rounding may reach one pixel beyond the right or bottom border
+				if (screen_x < buffer.get_width() && screen_y < buffer.get_height())
+				{
+					buffer.splat(screen_x, screen_y, clip_z / clip_w * 0.5f + 0.5f, cloud.color[first + lane]);
+
+					++jobVisible;
+				}
+			}
+		}
+
+		visible.fetch_add(jobVisible);
+	});
+
+	jobs.wait(group);
+
+	return visible.load();
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "JobSystem.h"
+#include "Math.h"
+#include "Image/PointBuffer.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Set of colored points, stored in one array per component, so that they can be transformed
+	/// for several points at once
+	/// </summary>
+	struct PointCloud
+	{
+		/// Object space positions
+		std::vector<float> position_x, position_y, position_z;
+
+		/// Colors packed into RGBA8 (see point_buffer::pack_color)
+		std::vector<std::uint32_t> color;
+
+		/// <summary>
+		/// Add a point
+		/// </summary>
+		/// <param name="position">Object space position</param>
+		/// <param name="pointColor">Color, clamped to [0, 1]</param>
+		void addPoint(const Point3D& position, const Color& pointColor);
+
+		/// <summary>
+		/// Get the number of points
+		/// </summary>
+		/// <returns>Number of points</returns>
+		std::size_t size() const;
+	};
+
+	/// <summary>
+	/// Transform the points of a cloud to screen space and splat the ones within the view frustum
+	/// in parallel, each covering a single pixel
+	/// </summary>
+	/// <param name="cloud">Point cloud</param>
+	/// <param name="transformation">Transformation from object to clip space</param>
+	/// <param name="buffer">Point buffer with the size of the image</param>
+	/// <param name="jobs">Job system splatting the points</param>
+	/// <returns>Number of points within the view frustum</returns>
+	unsigned long long splatPointCloud(const PointCloud& cloud, const mat4& transformation, point_buffer& buffer, JobSystem& jobs);
+}
\ No newline at end of file
@@ -1,17 +1,60 @@
 #include "Rasterizer.h"
+#include "Clipping.h"
+#include "Scene/Objects/Sphere.h"
+#include "Simd.h"
+#include "TriangleSetup.h"
+#include "VertexTransform.h"
 
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/matrix_inverse.hpp"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
 #include <exception>
 #include <limits>
+#include <new>
 #include <vector>
 
+namespace
+{
+	/// <summary>
+	/// Test whether a screen space triangle faces away from the camera, i.e., its corners, which are
+	/// counter-clockwise when looked at from the front, appear clockwise on screen (with y pointing downwards)
+	/// </summary>
+	/// <param name="triangle">Triangle in screen space</param>
+	/// <returns>True if back-facing; triangles with corners outside the depth range are never back-facing,
+	/// as their projection may be mirrored</returns>
+	bool isBackFacing(const cg::Triangle& triangle)
+	{
+		if (!triangle.points[0].validZ || !triangle.points[1].validZ || !triangle.points[2].validZ)
+		{
+			return false;
+		}
+
+		const auto& p0 = triangle.points[0].position;
+		const auto& p1 = triangle.points[1].position;
+		const auto& p2 = triangle.points[2].position;
+
+		return (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x) > 0.0f;
+	}
+
+	/// <summary>
+	/// Get the time elapsed since the given point in time
+	/// </summary>
+	/// <param name="start">Point in time</param>
+	/// <returns>Elapsed time in milliseconds</returns>
+	double elapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+}
+
 cg::Rasterizer::Rasterizer(const Camera camera, const std::vector<Scene>& scenes, const rasterization_mode mode, const unsigned int width, const unsigned int height)
-	: camera(camera), scenes(scenes), mode(mode), image(width, height), zBuffer(width, height),
+	: camera(camera), scenes(scenes), activeScene(0), mode(mode), image(width, height), target(width, height), points(width, height), geometry(0, 0),
+	frameCamera(camera), frameMode(mode), frameHierarchicalZ(true), binOffsets(nullptr), binnedIndices(nullptr), threadCount(0), frameThreadCount(0),
+	hierarchicalZ(true), frontToBack(false), levelOfDetail(true), frameCount(0),
 	lastRotation(std::chrono::milliseconds::zero()), rotationSpeed(10.0f), rotationAxis(0.0f, 0.0f, 1.0f)
 {
 	if (this->scenes.size() == 0)
@@ -24,11 +67,20 @@ cg::Rasterizer::Rasterizer(const Camera camera, const std::vector<Scene>& scenes
 
 void cg::Rasterizer::draw(const bool rotate)
 {
-	// Reset image and z-buffer
-	this->image.initialize(0.0f);
-	this->zBuffer.resize(this->image.get_width(), this->image.get_height());
-	this->zBuffer.initialize(std::numeric_limits<float>::max());
+	prepareFrame(rotate);
+	renderFrame();
+}
+
+void cg::Rasterizer::drawRotated(const float angle)
+{
+	this->lastRotation = std::chrono::milliseconds::zero();
+
+	prepareFrame(glm::gtc::matrix_transform::rotate(unitMat4(), angle, this->rotationAxis));
+	renderFrame();
+}
 
+void cg::Rasterizer::prepareFrame(const bool rotate)
+{
 	// Rotate scene in front of the camera
 	auto alpha = 0.0f;
 	vec3 rotationAxis = oneVec3();
@@ -53,31 +105,230 @@ void cg::Rasterizer::draw(const bool rotate)
 		this->lastRotation = std::chrono::milliseconds::zero();
 	}
 
-	const auto transformation = glm::gtc::matrix_transform::rotate(unitMat4(), alpha, rotationAxis);
+	prepareFrame(glm::gtc::matrix_transform::rotate(unitMat4(), alpha, rotationAxis));
+}
+
+void cg::Rasterizer::prepareFrame(const mat4& transformation)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	const auto allocations = getHeapAllocations();
 
-	// Information message
-	switch (this->mode)
+	// The thread pool is idle between frames, so its size may change here
+	if (this->threadCount != this->frameThreadCount)
 	{
-	case POINTS:
-		std::cout << "Drawing points..." << std::endl;
+		this->jobs.setThreadCount(this->threadCount);
+		this->frameThreadCount = this->threadCount;
+	}
 
-		break;
-	case WIREFRAME:
-		std::cout << "Drawing wireframe..." << std::endl;
+	// Color and z-buffer are cleared while resolving the previous frame, only a new size requires a full clear
+	if (this->target.get_width() != this->image.get_width() || this->target.get_height() != this->image.get_height())
+	{
+		this->target.resize(this->image.get_width(), this->image.get_height());
+		this->target.initialize();
+		this->points.resize(this->image.get_width(), this->image.get_height());
+		this->points.initialize();
+	}
 
-		break;
-	case FILLED:
-		std::cout << "Drawing triangles..." << std::endl;
+	if (this->mode == DEFERRED && (this->geometry.get_width() != this->image.get_width() || this->geometry.get_height() != this->image.get_height()))
+	{
+		this->geometry.resize(this->image.get_width(), this->image.get_height());
+		this->geometry.initialize();
+	}
+
+	// The temporaries of the previous frame are no longer used
+	this->frameArena.reset();
+
+	this->binnedTriangles.clear();
+	this->binOffsets = nullptr;
+	this->binnedIndices = nullptr;
+	this->statistics = RenderStatistics();
+	this->statistics.frame = this->frameCount++;
+
+	// Capture camera and options, so that they may change while the frame is rendered
+	this->frameCamera = this->camera;
+	this->frameMode = this->mode;
+	this->frameHierarchicalZ = this->hierarchicalZ;
+	this->frameStatisticsLog = this->statisticsLog;
+
+	// Flatten the lights, which do not move with the objects, for lighting the vertices of all objects
+	setupLights(this->scenes[this->activeScene].getLights(), this->lightSetup);
+
+	// Collect visible objects within the view frustum, skipping the others before their mesh is calculated;
+	// each object is a job of its own, as calculating a mesh may take long
+	const auto frustumPlanes = this->frameCamera.getFrustumPlanes();
+	const auto& sceneObjects = this->scenes[this->activeScene].getObjects();
+
+	FrameVector<std::pair<float, FrameObject>> candidates(sceneObjects.size(), this->frameArena);
+	FrameVector<char> visible(sceneObjects.size(), 0, this->frameArena);
+
+	JobSystem::Group group;
+
+	this->jobs.submitRange(group, 0, static_cast<int>(sceneObjects.size()), 1,
+		[this, &transformation, &frustumPlanes, &sceneObjects, &candidates, &visible](const int index, int)
+		{
+			const auto jobStart = std::chrono::high_resolution_clock::now();
+
+			RenderStatistics counters;
+			visible[index] = collectObject(*sceneObjects[index], transformation, frustumPlanes, candidates[index], counters) ? 1 : 0;
+
+			counters.meshTime = elapsedMilliseconds(jobStart);
+			addStatistics(counters);
+		});
+
+	this->jobs.wait(group);
+
+	FrameVector<unsigned int> order(this->frameArena);
+	order.reserve(candidates.size());
+
+	for (unsigned int index = 0; index < candidates.size(); ++index)
+	{
+		if (visible[index] != 0)
+		{
+			order.push_back(index);
+		}
+	}
+
+	// Sort the objects by the nearest point of their bounding spheres if requested,
+	// so that near objects fill the z-buffer first and hide the ones behind early;
+	// objects at the same distance keep their order, without the buffer std::stable_sort would allocate
+	if (this->frontToBack)
+	{
+		std::sort(order.begin(), order.end(), [&candidates](const unsigned int lhs, const unsigned int rhs)
+		{
+			return candidates[lhs].first < candidates[rhs].first || (candidates[lhs].first == candidates[rhs].first && lhs < rhs);
+		});
+	}
+
+	this->frameObjects.clear();
+
+	for (const auto index : order)
+	{
+		this->frameObjects.push_back(candidates[index].second);
+	}
+
+	this->statistics.frameTime = elapsedMilliseconds(start);
+	this->statistics.heapAllocations = getHeapAllocations() - allocations;
+}
+
+bool cg::Rasterizer::collectObject(const SceneObject& object, const mat4& transformation, const std::array<vec4, 6>& frustumPlanes,
+	std::pair<float, FrameObject>& result, RenderStatistics& counters) const
+{
+	if (!object.isVisible())
+	{
+		return false;
+	}
+
+	const auto global_trafo = transformation * object.getTransformation();
+	const auto sphere = transformBoundingSphere(object.getBoundingSphere(), global_trafo);
+
+	if (isOutside(sphere, frustumPlanes))
+	{
+		++counters.culledObjects;
+
+		return false;
+	}
+
+	// The mesh is only recalculated if the object changed, and instances capture the mesh they share;
+	// the captured mesh itself is never modified
+	auto mesh = object.getMesh();
+
+	// Spheres and their instances are tessellated just finely enough for their size on screen
+	if (this->levelOfDetail && object.hasLevelsOfDetail())
+	{
+		const auto screenRadius = this->frameCamera.getProjectedRadius(sphere, static_cast<float>(this->image.get_height()));
+		const auto level = Sphere::selectLevelOfDetail(screenRadius, maxLevelOfDetailError);
+
+		mesh = object.getLevelOfDetailMesh(level);
+
+		++counters.levelOfDetailSpheres[level];
+		counters.levelOfDetailTriangles[level] += mesh->indices.size() / 3;
+	}
+
+	counters.submittedTriangles += mesh->indices.size() / 3;
+
+	const auto distance = glm::length(sphere.center - this->frameCamera.getPosition()) - sphere.radius;
+	result = std::make_pair(distance, FrameObject{ mesh, global_trafo, object.getMeshColor(), object.isBackFaceCulled() });
+
+	return true;
+}
+
+void cg::Rasterizer::renderFrame()
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	const auto allocations = getHeapAllocations();
+
+	// Draw all objects at once: the vertex and assembly jobs of different objects overlap,
+	// and in the modes without binning, the triangles are rasterized right away
+	while (this->objectWork.size() < this->frameObjects.size())
+	{
+		this->objectWork.push_back(std::unique_ptr<ObjectWork>(new ObjectWork()));
+	}
+
+	JobSystem::Group group;
+
+	for (unsigned int index = 0; index < this->frameObjects.size(); ++index)
+	{
+		drawObject(index, group);
 	}
 
-	// Draw each object
-	for (const auto obj : this->scenes[this->activeScene].getObjects())
+	this->jobs.wait(group);
+
+	// Rasterize collected triangles tile by tile
+	if (this->frameMode == BINNED || this->frameMode == DEFERRED)
 	{
-		if (obj->isVisible())
+		rasterizeBins();
+	}
+
+	// Copy the tiled render target or the points into the linear image, and clear them for the next frame;
+	// each job resolves a band of whole depth pyramid regions
+	const auto resolveStart = std::chrono::high_resolution_clock::now();
+
+	std::atomic<unsigned long long> covered(0);
+	const auto points = this->frameMode == POINTS;
+
+	this->jobs.submitRange(group, 0, static_cast<int>(this->image.get_height()), resolveBandSize,
+		[this, points, &covered](const int first, const int last)
 		{
-			drawObject(obj, transformation);
+			const auto band = points
+				? this->points.resolve(this->image, { 0.0f, 0.0f, 0.0f, 0.0f }, first, last)
+				: this->target.resolve(this->image, { 0.0f, 0.0f, 0.0f, 0.0f }, std::numeric_limits<float>::max(), first, last);
+
+			covered.fetch_add(band, std::memory_order_relaxed);
+		});
+
+	this->jobs.wait(group);
+
+	this->statistics.coveredPixels = covered.load();
+	this->statistics.resolveTime = elapsedMilliseconds(resolveStart);
+
+	// The deferred mode only wrote depth and the G-buffer, the image is lit afterwards
+	if (this->frameMode == DEFERRED)
+	{
+		shadeDeferred();
+	}
+
+	this->statistics.frameTime += elapsedMilliseconds(start);
+	this->statistics.heapAllocations += getHeapAllocations() - allocations;
+	this->statistics.frameArenaBytes = this->frameArena.getUsedBytes();
+
+	// Append the statistics to the log file, which is only reopened if its path changed
+	if (this->frameStatisticsLog != this->statisticsStreamPath)
+	{
+		this->statisticsStream.close();
+		this->statisticsStream.clear();
+		this->statisticsStreamPath = this->frameStatisticsLog;
+
+		if (!this->statisticsStreamPath.empty())
+		{
+			this->statisticsStream.open(this->statisticsStreamPath, std::ios::app);
 		}
 	}
+
+	if (this->statisticsStream.is_open())
+	{
+		writeJson(this->statisticsStream, this->statistics);
+		this->statisticsStream << std::endl;
+	}
 }
 
 cg::Camera& cg::Rasterizer::accessCamera()
@@ -125,114 +376,329 @@ cg::vec3& cg::Rasterizer::accessRotationAxis()
 	return this->rotationAxis;
 }
 
-void cg::Rasterizer::drawObject(const std::shared_ptr<cg::SceneObject> object, const mat4& transformation)
+bool& cg::Rasterizer::accessHierarchicalZ()
+{
+	return this->hierarchicalZ;
+}
+
+bool& cg::Rasterizer::accessFrontToBack()
+{
+	return this->frontToBack;
+}
+
+bool& cg::Rasterizer::accessLevelOfDetail()
+{
+	return this->levelOfDetail;
+}
+
+unsigned int& cg::Rasterizer::accessThreadCount()
+{
+	return this->threadCount;
+}
+
+cg::JobSystem& cg::Rasterizer::accessJobSystem()
+{
+	return this->jobs;
+}
+
+std::string& cg::Rasterizer::accessStatisticsLog()
+{
+	return this->statisticsLog;
+}
+
+const cg::RenderStatistics& cg::Rasterizer::getStatistics() const
+{
+	return this->statistics;
+}
+
+void cg::Rasterizer::drawObject(const unsigned int index, JobSystem::Group& group)
 {
-	// Ger camera transformations
-	const auto viewProjection = this->camera.getViewProjection();
+	const auto& mesh = *this->frameObjects[index].mesh;
+	auto& work = *this->objectWork[index];
 
-	// Draw the mesh
-	const auto mesh = object->calculateMesh();
-	const auto model = object->getTransformation();
+	const int numVertices = static_cast<int>(mesh.vertices.size());
+	const int numTriangles = static_cast<int>(mesh.indices.size() / 3);
 
-	// Get lights
-	auto lights = this->scenes[this->activeScene].getLights();
+	// The vertex cache is only needed during the frame, and is constructed by the vertex jobs
+	work.transformedVertices = this->frameArena.allocateArray<Triangle::Point>(numVertices);
+	work.clipPositions = this->frameArena.allocateArray<vec4>(numVertices);
+	work.clipOutcodes = this->frameArena.allocateArray<unsigned int>(numVertices);
 
-	// For each triangle
-	#pragma omp parallel for schedule(dynamic)
-	for (int i = 0; i < mesh.size(); ++i)
+	work.numChunks = (numTriangles + assemblyChunkSize - 1) / assemblyChunkSize;
+
+	if (work.assembledTriangles.size() < static_cast<std::size_t>(work.numChunks))
+	{
+		work.assembledTriangles.resize(work.numChunks);
+	}
+
+	if (numVertices == 0)
+	{
+		work.numChunks = 0;
+
+		return;
+	}
+
+	// Transform and light each unique vertex only once, as it is shared by several triangles;
+	// the last vertex job to finish starts assembling the triangles, while other objects may still be busy with their vertices
+	work.pendingVertexJobs = (numVertices + vertexJobSize - 1) / vertexJobSize;
+
+	this->jobs.submitRange(group, 0, numVertices, vertexJobSize, [this, index, &group](const int first, const int last)
+	{
+		processVertices(index, first, last);
+
+		auto& work = *this->objectWork[index];
+
+		if (work.pendingVertexJobs.fetch_sub(1) == 1)
+		{
+			this->jobs.submitRange(group, 0, work.numChunks, 1, [this, index](const int chunk, int) { assembleTriangles(index, chunk); });
+		}
+	});
+}
+
+void cg::Rasterizer::processVertices(const unsigned int index, const int first, const int last)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	const auto& object = this->frameObjects[index];
+	const auto& mesh = *object.mesh;
+	auto& work = *this->objectWork[index];
+
+	// Transform and light the vertices in batches of one SIMD vector with the object's transformations and the lights prepared for this frame
+	using simd::float_v;
+
+	VertexTransform transform;
+	setupVertexTransform(object.transformation, this->frameCamera.getViewProjection(),
+		static_cast<float>(this->image.get_width()), static_cast<float>(this->image.get_height()), guardBand, transform);
+
+	const auto lit = this->frameMode != DEFERRED;
+
+	for (int batch = first; batch < last; batch += static_cast<int>(float_v::size))
 	{
-		auto triangle = mesh[i];
+		const auto lanes = std::min(static_cast<int>(float_v::size), last - batch);
 
-		// For each triangle corner point
-		for (auto& point : triangle.points)
+		// Gather positions and normals of a full batch, padding the last one
+		alignas(32) std::array<std::array<float, float_v::size>, 6> attributes = {};
+
+		for (int lane = 0; lane < lanes; ++lane)
 		{
-			const auto global_trafo = transformation * model;
+			const auto& point = mesh.vertices[batch + lane];
+
+			attributes[0][lane] = point.position.x;
+			attributes[1][lane] = point.position.y;
+			attributes[2][lane] = point.position.z;
+			attributes[3][lane] = point.normal.x;
+			attributes[4][lane] = point.normal.y;
+			attributes[5][lane] = point.normal.z;
+		}
 
-			vec4 point_world = zeroVec4();
-			vec3 normal_world = zeroVec3();
-			// Transform point's position and normal to world space.
-			vec4 temp = vec4(point.position, 1.0f);
-			point_world = global_trafo * temp;
-			temp = vec4(point.normal, 0.0f);
-			normal_world = vec3(temp.x, temp.y, temp.z);
+		VertexBatch transformed;
+		transformVertices(transform, { float_v::load(attributes[0].data()), float_v::load(attributes[1].data()), float_v::load(attributes[2].data()) },
+			transformed);
 
-			auto color = black();
+		// The lighting uses the positions in world space and the normals in object space;
+		// the deferred mode lights the pixels instead, and keeps the vertices' own colors
+		alignas(32) std::array<std::array<float, float_v::size>, 4> colors;
 
-			for (const auto& light : lights)
+		if (lit)
+		{
+			std::array<float_v, 4> light;
+
+			lightVertices(this->lightSetup, transformed.world,
+				{ float_v::load(attributes[3].data()), float_v::load(attributes[4].data()), float_v::load(attributes[5].data()) }, light);
+
+			for (unsigned int channel = 0; channel < 4; ++channel)
 			{
-				if (light->isVisible())
-				{
-					const auto colorInfo = light->getColor(Point3D(point_world));
+				light[channel].store(colors[channel].data());
+			}
+		}
 
-					if (colorInfo.ambient)
-					{
-						// Add ambient part
-						color += point.color * colorInfo.color * colorInfo.intensity;
-					}
-					else
-					{
-						// Calculate the illumination of the object according to Lambert's law,
-						// and add it to the color already calculated from previous light sources.
-						// All relevant information from the light source is stored in colorInfo.
-						// Hint: The direction of the ray is from the light source to the object.
-						float dot = (-colorInfo.ray.x*point.normal.x) + (-colorInfo.ray.y*point.normal.y) + (-colorInfo.ray.z*point.normal.z);
-						float lenSq1 = colorInfo.ray.x*colorInfo.ray.x + colorInfo.ray.y*colorInfo.ray.y + colorInfo.ray.z*colorInfo.ray.z;
-						float lenSq2 = point.normal.x*point.normal.x + point.normal.y*point.normal.y + point.normal.z*point.normal.z;
-						float cos_angle = dot / sqrt(lenSq1) * sqrt(lenSq2);
-						color += point.color * colorInfo.color * colorInfo.intensity * cos_angle * (1.0f/((0.001f + sqrt(lenSq1))*sqrt(lenSq1)));
-					}
-				}
+		alignas(32) std::array<std::array<float, float_v::size>, 4> clip;
+		alignas(32) std::array<std::array<float, float_v::size>, 3> screen;
+
+		for (unsigned int component = 0; component < 4; ++component)
+		{
+			transformed.clip[component].store(clip[component].data());
+		}
+
+		for (unsigned int component = 0; component < 3; ++component)
+		{
+			transformed.screen[component].store(screen[component].data());
+		}
+
+		for (int lane = 0; lane < lanes; ++lane)
+		{
+			auto point = mesh.vertices[batch + lane];
+
+			point.color = point.color * object.color;
+
+			if (lit)
+			{
+				point.color = point.color * Color(colors[0][lane], colors[1][lane], colors[2][lane], colors[3][lane]);
 			}
 
-			point.color = color;
+			point.position = Point3D(screen[0][lane], screen[1][lane], screen[2][lane]);
+			point.validXY = (transformed.validXY >> lane & 1u) != 0;
+			point.validZ = (transformed.validZ >> lane & 1u) != 0;
+
+			new (&work.transformedVertices[batch + lane]) Triangle::Point(point);
+			new (&work.clipPositions[batch + lane]) vec4(clip[0][lane], clip[1][lane], clip[2][lane], clip[3][lane]);
+			work.clipOutcodes[batch + lane] = transformed.outcodes[lane];
+		}
+	}
+
+	RenderStatistics counters;
+	counters.vertexTime = elapsedMilliseconds(start);
+
+	addStatistics(counters);
+}
+
+void cg::Rasterizer::assembleTriangles(const unsigned int index, const int chunk)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	const auto& object = this->frameObjects[index];
+	const auto& mesh = *object.mesh;
+	auto& work = *this->objectWork[index];
+
+	// Each chunk collects its output triangles, so that clipping and culling can change the number of triangles without changing their order
+	const auto cullBackFaces = object.backFaceCulling;
+	const auto clip = this->frameMode == FILLED || this->frameMode == BINNED || this->frameMode == DEFERRED;
+	const auto binned = this->frameMode == BINNED || this->frameMode == DEFERRED;
+
+	auto& output = work.assembledTriangles[chunk];
+	output.clear();
+
+	RenderStatistics counters;
+
+	// Draw triangle, or store it for binned rasterization
+	const auto emit = [this, cullBackFaces, binned, &output, &counters](const Triangle& triangle)
+	{
+		if (cullBackFaces && isBackFacing(triangle))
+		{
+			++counters.culledBackFaces;
+
+			return;
+		}
+
+		++counters.drawnTriangles;
+
+		if (binned)
+		{
+			output.push_back(triangle);
+		}
+		else
+		{
+			drawTriangle(triangle, counters);
+		}
+	};
+
+	const int numTriangles = static_cast<int>(mesh.indices.size() / 3);
+	const auto end = std::min((chunk + 1) * assemblyChunkSize, numTriangles);
+
+	for (int i = chunk * assemblyChunkSize; i < end; ++i)
+	{
+		const std::array<IndexedMesh::index_type, 3> indices = { mesh.indices[3 * i + 0], mesh.indices[3 * i + 1], mesh.indices[3 * i + 2] };
+		const std::array<unsigned int, 3> outcodes = { work.clipOutcodes[indices[0]], work.clipOutcodes[indices[1]], work.clipOutcodes[indices[2]] };
+
+		// Discard triangles completely outside of one plane
+		if ((outcodes[0] & outcodes[1] & outcodes[2]) != 0)
+		{
+			++counters.frustumCulledTriangles;
+
+			continue;
+		}
+
+		// Triangles within the depth range and the guard band need no clipping
+		if ((outcodes[0] | outcodes[1] | outcodes[2]) == 0 || !clip)
+		{
+			emit(Triangle{ std::array<Triangle::Point, 3> {
+				work.transformedVertices[indices[0]], work.transformedVertices[indices[1]], work.transformedVertices[indices[2]] } });
+
+			continue;
+		}
+
+		// Clip in homogeneous coordinates and draw the resulting polygon as triangle fan
+		const std::array<ClipVertex, 3> corners = {
+			ClipVertex{ work.clipPositions[indices[0]], work.transformedVertices[indices[0]] },
+			ClipVertex{ work.clipPositions[indices[1]], work.transformedVertices[indices[1]] },
+			ClipVertex{ work.clipPositions[indices[2]], work.transformedVertices[indices[2]] } };
 
-			// Transform to clip space
-			auto point_clip = viewProjection * point_world;
+		ClipPolygon polygon;
+		clipTriangle(corners, outcodes[0] | outcodes[1] | outcodes[2], guardBand, polygon);
 
-			point.validXY = point_clip.x > -point_clip.w && point_clip.x < point_clip.w && point_clip.y > -point_clip.w && point_clip.y < point_clip.w;
-			point.validZ = point_clip.z > -point_clip.w && point_clip.z < point_clip.w;
+		++counters.clippedTriangles;
 
-			// Transform to screen space
-			point_clip.x = point_clip.x / point_clip.w;
-			point_clip.y = point_clip.y / point_clip.w;
-			point_clip.z = point_clip.z / point_clip.w;
+		for (unsigned int k = 0; k < polygon.size; ++k)
+		{
+			projectToScreen(polygon.vertices[k].position, polygon.vertices[k].attributes);
 
-			point.position.x = (point_clip.x * 0.5f + 0.5f) * this->image.get_width();
-			point.position.y = (point_clip.y * -0.5f + 0.5f) * this->image.get_height();
-			point.position.z = point_clip.z;
+			// Vertices on the near or far plane may fail the strict range test due to rounding
+			polygon.vertices[k].attributes.validZ = true;
 		}
 
-		// Draw triangle
-		drawTriangle(triangle);
+		for (unsigned int k = 1; k + 1 < polygon.size; ++k)
+		{
+			emit(Triangle{ std::array<Triangle::Point, 3> {
+				polygon.vertices[0].attributes, polygon.vertices[k].attributes, polygon.vertices[k + 1].attributes } });
+		}
 	}
+
+	counters.rasterizationTime = elapsedMilliseconds(start);
+
+	addStatistics(counters);
 }
 
-void cg::Rasterizer::drawTriangle(const Triangle& triangle)
+void cg::Rasterizer::projectToScreen(const vec4& position, Triangle::Point& point) const
 {
-	switch (this->mode)
+	point.validXY = position.x > -position.w && position.x < position.w && position.y > -position.w && position.y < position.w;
+	point.validZ = position.z > -position.w && position.z < position.w;
+
+	// Transform to screen space
+	point.position.x = (position.x / position.w * 0.5f + 0.5f) * this->image.get_width();
+	point.position.y = (position.y / position.w * -0.5f + 0.5f) * this->image.get_height();
+	point.position.z = position.z / position.w;
+}
+
+void cg::Rasterizer::drawTriangle(const Triangle& triangle, RenderStatistics& counters)
+{
+	switch (this->frameMode)
 	{
 	case POINTS:
-		rasterizePoints(triangle);
+		rasterizePoints(triangle, counters);
 
 		break;
 	case WIREFRAME:
-		drawWireframe(triangle);
+		drawWireframe(triangle, counters);
 
 		break;
 	case FILLED:
-		rasterizeFilled(triangle);
+	case BINNED:
+	case DEFERRED:
+		rasterizeFilled(triangle, counters);
 	}
 }
 
-void cg::Rasterizer::rasterizePoints(const Triangle& triangle)
+void cg::Rasterizer::rasterizePoints(const Triangle& triangle, RenderStatistics& counters)
 {
-	// Draw pixels if they are in front of the camera
-	if (triangle.points[0].validXY && triangle.points[0].validZ) setPixel(triangle.points[0].position, triangle.points[0].color);
-	if (triangle.points[1].validXY && triangle.points[1].validZ) setPixel(triangle.points[1].position, triangle.points[1].color);
-	if (triangle.points[2].validXY && triangle.points[2].validZ) setPixel(triangle.points[2].position, triangle.points[2].color);
+	// Splat the points if they are in front of the camera, without locking, as the depth test is a single atomic operation
+	for (const auto& point : triangle.points)
+	{
+		const auto x = static_cast<int>(std::round(point.position.x));
+		const auto y = static_cast<int>(std::round(point.position.y));
+
+		if (point.validXY && point.validZ && x < static_cast<int>(this->image.get_width()) && y < static_cast<int>(this->image.get_height()))
+		{
+			++counters.testedFragments;
+
+			const auto stored = this->points.splat(x, y, point.position.z * 0.5f + 0.5f,
+				point_buffer::pack_color({ point.color.r, point.color.g, point.color.b, point.color.a }));
+
+			counters.fragments += stored ? 1 : 0;
+		}
+	}
 }
 
-void cg::Rasterizer::drawWireframe(const Triangle& triangle)
+void cg::Rasterizer::drawWireframe(const Triangle& triangle, RenderStatistics& counters)
 {
 	// Create lines
 	const std::array<std::pair<Triangle::Point, Triangle::Point>, 3> lines = {
@@ -245,51 +711,648 @@ void cg::Rasterizer::drawWireframe(const Triangle& triangle)
 		if ((line.first.validXY && line.first.validZ) || (line.second.validXY && line.second.validZ))
 		{
 			// Rasterize the line
-			rasterizeLine(line.first, line.second);
+			rasterizeLine(line.first, line.second, counters);
+		}
+	}
+}
+
+void cg::Rasterizer::rasterizeFilled(const Triangle& triangle, RenderStatistics& counters)
+{
+	rasterizeFilled(triangle, 0, 0, this->image.get_width() - 1, this->image.get_height() - 1, false, counters);
+}
+
+void cg::Rasterizer::rasterizeFilled(const Triangle& triangle, const unsigned int x_begin, const unsigned int y_begin,
+	const unsigned int x_end, const unsigned int y_end, const bool exclusive, RenderStatistics& counters, const unsigned int index)
+{
+	if (!triangle.points[0].validZ || !triangle.points[1].validZ || !triangle.points[2].validZ)
+	{
+		return;
+	}
+
+	// Calculate edge equations and attribute planes once per triangle
+	TriangleSetup setup;
+
+	if (!setupTriangle(triangle, setup))
+	{
+		return;
+	}
+
+	const auto x_min = std::max(setup.x_min, static_cast<int>(x_begin));
+	const auto x_max = std::min(setup.x_max, static_cast<int>(x_end));
+	const auto y_min = std::max(setup.y_min, static_cast<int>(y_begin));
+	const auto y_max = std::min(setup.y_max, static_cast<int>(y_end));
+
+	if (x_min > x_max || y_min > y_max)
+	{
+		return;
+	}
+
+	// Reject the whole triangle if it lies behind everything drawn so far within its bounding box
+	if (this->frameHierarchicalZ)
+	{
+		auto occluded = false;
+
+		if (exclusive)
+		{
+			occluded = this->target.is_occluded(x_min, y_min, x_max, y_max, setup.z_min - depthTolerance);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(this->imageMutex);
+			occluded = this->target.is_occluded(x_min, y_min, x_max, y_max, setup.z_min - depthTolerance);
+		}
+
+		++counters.hiZTestedTriangles;
+
+		if (occluded)
+		{
+			++counters.hiZRejectedTriangles;
+
+			return;
+		}
+	}
+
+	// Only if the whole triangle is within the camera's range, blocks may skip the per-pixel depth test
+	const auto inDepthRange = setup.z_min - depthTolerance > this->frameCamera.getNear() && setup.z_max + depthTolerance < this->frameCamera.getFar();
+
+	using simd::float_v;
+
+	constexpr auto block = static_cast<int>(blockSize);
+	constexpr auto groups = blockSize / float_v::size;
+
+	const auto ramp = float_v::ramp();
+	const float_v zero(0.0f);
+
+	alignas(32) std::array<std::array<float, float_v::size>, TriangleSetup::NUM_ATTRIBUTES> values;
+
+	// The deferred mode only needs the depth, and the barycentric weights from the edge functions instead of colors
+	const auto deferred = this->frameMode == DEFERRED;
+	const auto numAttributes = deferred ? 1u : static_cast<unsigned int>(TriangleSetup::NUM_ATTRIBUTES);
+	const float_v inverseArea(1.0f / setup.area);
+
+	alignas(32) std::array<std::array<float, float_v::size>, 2> barycentrics;
+
+	// Walk over the blocks of the (clamped) bounding box
+	for (auto block_y = (y_min / block) * block; block_y <= y_max; block_y += block)
+	{
+		const auto row_first = std::max(block_y, y_min);
+		const auto row_last = std::min(block_y + block - 1, y_max);
+
+		for (auto block_x = (x_min / block) * block; block_x <= x_max; block_x += block)
+		{
+			const auto column_first = std::max(block_x, x_min);
+			const auto column_last = std::min(block_x + block - 1, x_max);
+
+			// Coordinates relative to the triangle setup's origin
+			const auto fx_first = static_cast<float>(column_first - setup.x_min);
+			const auto fx_last = static_cast<float>(column_last - setup.x_min);
+			const auto fy_first = static_cast<float>(row_first - setup.y_min);
+			const auto fy_last = static_cast<float>(row_last - setup.y_min);
+
+			// Trivially reject the block if it is completely outside of an edge,
+			// and trivially accept it if it is completely inside of all edges
+			auto reject = false;
+			auto accept = true;
+
+			for (unsigned int edge = 0; edge < 3; ++edge)
+			{
+				const auto a = setup.edge_a[edge];
+				const auto b = setup.edge_b[edge];
+				const auto c = setup.edge_c[edge];
+
+				const auto e_max = a * (a > 0.0f ? fx_last : fx_first) + b * (b > 0.0f ? fy_last : fy_first) + c;
+				const auto e_min = a * (a > 0.0f ? fx_first : fx_last) + b * (b > 0.0f ? fy_first : fy_last) + c;
+
+				reject |= e_max < 0.0f;
+				accept &= e_min >= 0.0f;
+			}
+
+			if (reject)
+			{
+				continue;
+			}
+
+			// Compare the depth range of the triangle's plane within the block with the block's stored depths:
+			// reject the block if it is hidden, or skip the per-pixel depth test if it is in front of everything
+			auto depthAccept = false;
+
+			if (this->frameHierarchicalZ)
+			{
+				const auto dx = setup.plane_dx[TriangleSetup::DEPTH];
+				const auto dy = setup.plane_dy[TriangleSetup::DEPTH];
+				const auto offset = setup.plane_offset[TriangleSetup::DEPTH];
+
+				const auto block_z_min = std::max(setup.z_min, dx * (dx > 0.0f ? fx_first : fx_last) + dy * (dy > 0.0f ? fy_first : fy_last) + offset);
+				const auto block_z_max = std::min(setup.z_max, dx * (dx > 0.0f ? fx_last : fx_first) + dy * (dy > 0.0f ? fy_last : fy_first) + offset);
+
+				float stored_z_min, stored_z_max;
+
+				if (exclusive)
+				{
+					stored_z_min = this->target.tile_min_depth(block_x, block_y);
+					stored_z_max = this->target.tile_max_depth(block_x, block_y);
+				}
+				else
+				{
+					std::lock_guard<std::mutex> lock(this->imageMutex);
+
+					stored_z_min = this->target.tile_min_depth(block_x, block_y);
+					stored_z_max = this->target.tile_max_depth(block_x, block_y);
+				}
+
+				++counters.hiZTestedBlocks;
+
+				if (block_z_min - depthTolerance > stored_z_max)
+				{
+					++counters.hiZRejectedBlocks;
+
+					continue;
+				}
+
+				// Other threads may write to the block in between if it is not owned exclusively
+				depthAccept = exclusive && inDepthRange && block_z_max + depthTolerance < stored_z_min;
+
+				if (depthAccept)
+				{
+					++counters.hiZAcceptedBlocks;
+				}
+			}
+
+			auto written = false;
+
+			// Edge function values of the first row, stepped incrementally from row to row
+			std::array<std::array<float_v, groups>, 3> edges;
+
+			for (unsigned int edge = 0; edge < 3; ++edge)
+			{
+				for (unsigned int group = 0; group < groups; ++group)
+				{
+					const auto fx = float_v(fx_first + static_cast<float>(group * float_v::size)) + ramp;
+					edges[edge][group] = float_v(setup.edge_a[edge]) * fx + float_v(setup.edge_b[edge] * fy_first + setup.edge_c[edge]);
+				}
+			}
+
+			for (auto y = row_first; y <= row_last; ++y)
+			{
+				const auto fy = static_cast<float>(y - setup.y_min);
+
+				for (unsigned int group = 0; group < groups; ++group)
+				{
+					const auto x_group = column_first + static_cast<int>(group * float_v::size);
+
+					if (x_group > column_last)
+					{
+						break;
+					}
+
+					// Lanes within the bounding box and the triangle
+					const auto lanes = std::min(column_last - x_group + 1, static_cast<int>(float_v::size));
+					auto coverage = (1u << lanes) - 1u;
+
+					if (!accept)
+					{
+						coverage &= simd::greater_equal(edges[0][group], zero) & simd::greater_equal(edges[1][group], zero) & simd::greater_equal(edges[2][group], zero);
+					}
+
+					if (coverage == 0)
+					{
+						continue;
+					}
+
+					// Interpolate depth and color for all lanes
+					const auto fx = float_v(static_cast<float>(x_group - setup.x_min)) + ramp;
+
+					for (unsigned int attribute = 0; attribute < numAttributes; ++attribute)
+					{
+						const auto row_offset = setup.plane_dy[attribute] * fy + setup.plane_offset[attribute];
+						(float_v(setup.plane_dx[attribute]) * fx + float_v(row_offset)).store(values[attribute].data());
+					}
+
+					if (deferred)
+					{
+						(edges[1][group] * inverseArea).store(barycentrics[0].data());
+						(edges[2][group] * inverseArea).store(barycentrics[1].data());
+					}
+
+					for (unsigned int lane = 0; lane < float_v::size; ++lane)
+					{
+						if ((coverage & (1u << lane)) != 0)
+						{
+							const auto x = x_group + static_cast<int>(lane);
+							const auto z = values[TriangleSetup::DEPTH][lane];
+
+							++counters.testedFragments;
+
+							if (deferred)
+							{
+								const g_buffer::sample_type sample{ index, z, { barycentrics[0][lane], barycentrics[1][lane] } };
+								auto passed = true;
+
+								if (depthAccept)
+								{
+									this->geometry(x, y) = sample;
+									this->target.set_depth(x, y, z);
+								}
+								else
+								{
+									passed = writeSample(x, y, sample);
+								}
+
+								written |= passed;
+								counters.fragments += passed ? 1 : 0;
+
+								continue;
+							}
+
+							const Color color(values[TriangleSetup::RED][lane], values[TriangleSetup::GREEN][lane],
+								values[TriangleSetup::BLUE][lane], values[TriangleSetup::ALPHA][lane]);
+
+							auto passed = true;
+
+							if (depthAccept)
+							{
+								this->target.color(x, y) = { color.r, color.g, color.b, color.a };
+								this->target.set_depth(x, y, z);
+							}
+							else if (exclusive)
+							{
+								passed = writePixel(x, y, z, color);
+							}
+							else
+							{
+								passed = setPixel(Point3D(static_cast<float>(x), static_cast<float>(y), z), color);
+							}
+
+							written |= passed;
+							counters.fragments += passed ? 1 : 0;
+						}
+					}
+				}
+
+				for (unsigned int edge = 0; edge < 3; ++edge)
+				{
+					const float_v step(setup.edge_b[edge]);
+
+					for (unsigned int group = 0; group < groups; ++group)
+					{
+						edges[edge][group] = edges[edge][group] + step;
+					}
+				}
+			}
+
+			// Pixels got nearer, so update the block's farthest depth
+			if (written && this->frameHierarchicalZ)
+			{
+				if (exclusive)
+				{
+					this->target.update_max_depth(block_x, block_y);
+				}
+				else
+				{
+					std::lock_guard<std::mutex> lock(this->imageMutex);
+					this->target.update_max_depth(block_x, block_y);
+				}
+			}
 		}
 	}
 }
 
-void cg::Rasterizer::rasterizeFilled(const Triangle& triangle)
+void cg::Rasterizer::rasterizeBins()
 {
-	if (triangle.points[0].validZ && triangle.points[1].validZ && triangle.points[2].validZ)
+	const auto tilesX = (this->image.get_width() + tileSize - 1) / tileSize;
+	const auto tilesY = (this->image.get_height() + tileSize - 1) / tileSize;
+	const auto numTiles = tilesX * tilesY;
+
+	// Concatenate the assembled triangles in submission order, divided into binning jobs of whole chunks
+	FrameVector<std::pair<const std::vector<Triangle>*, std::size_t>> chunks(this->frameArena);
+	FrameVector<std::size_t> firstChunks(this->frameArena);
+	std::size_t numTriangles = 0, jobTriangles = binningJobSize;
+
+	for (unsigned int index = 0; index < this->frameObjects.size(); ++index)
 	{
-		// Line-wise fill triangle
-		const auto x_min = static_cast<unsigned int>(std::max(static_cast<int>(std::round(std::min(
-		{ triangle.points[0].position.x, triangle.points[1].position.x, triangle.points[2].position.x }))), 0));
-		const auto x_max = static_cast<unsigned int>(std::max(std::min(static_cast<int>(std::round(std::max(
-		{ triangle.points[0].position.x, triangle.points[1].position.x, triangle.points[2].position.x }))), static_cast<int>(this->image.get_width() - 1)), 0));
+		const auto& work = *this->objectWork[index];
 
-		const auto y_min = static_cast<unsigned int>(std::max(static_cast<int>(std::round(std::min(
-		{ triangle.points[0].position.y, triangle.points[1].position.y, triangle.points[2].position.y }))), 0));
-		const auto y_max = static_cast<unsigned int>(std::max(std::min(static_cast<int>(std::round(std::max(
-		{ triangle.points[0].position.y, triangle.points[1].position.y, triangle.points[2].position.y }))), static_cast<int>(this->image.get_height() - 1)), 0));
+		for (int chunk = 0; chunk < work.numChunks; ++chunk)
+		{
+			if (jobTriangles >= binningJobSize)
+			{
+				firstChunks.push_back(chunks.size());
+				jobTriangles = 0;
+			}
+
+			chunks.push_back(std::make_pair(&work.assembledTriangles[chunk], numTriangles));
+			numTriangles += work.assembledTriangles[chunk].size();
+			jobTriangles += work.assembledTriangles[chunk].size();
+		}
+	}
+
+	firstChunks.push_back(chunks.size());
+
+	this->binnedTriangles.resize(numTriangles);
+
+	const auto numJobs = static_cast<unsigned int>(firstChunks.size() - 1);
+	const auto width = static_cast<int>(this->image.get_width());
+	const auto height = static_cast<int>(this->image.get_height());
 
-		for (auto y = y_min; y <= y_max; ++y)
+	// Call a function with the index of each triangle of a binning job and each tile overlapped by its (clamped) bounding box
+	const auto forEachTile = [&](const int job, const auto& function)
+	{
+		for (auto chunk = firstChunks[job]; chunk < firstChunks[job + 1]; ++chunk)
 		{
-			for (auto x = x_min; x <= x_max; ++x)
+			const auto& triangles = *chunks[chunk].first;
+			const auto offset = chunks[chunk].second;
+
+			for (std::size_t k = 0; k < triangles.size(); ++k)
 			{
-				// Check whether the x, y coordinates are inside of the triangle
-				const Triangle2D triangle_2d(triangle);
-				const vec2 coords(x, y);
+				const auto& triangle = triangles[k];
 
-				if (pointInTriangle(triangle_2d, coords))
+				if (!triangle.points[0].validZ || !triangle.points[1].validZ || !triangle.points[2].validZ)
 				{
-					// Calculate interpolated z-value and color
-					const auto weights = calculateBarycentricCoords(triangle_2d, coords);
+					continue;
+				}
 
-					const auto z = weights[0] * triangle.points[0].position.z + weights[1] * triangle.points[1].position.z + weights[2] * triangle.points[2].position.z;
-					const auto color = weights[0] * triangle.points[0].color + weights[1] * triangle.points[1].color + weights[2] * triangle.points[2].color;
+				const auto x_min = static_cast<int>(std::round(std::min({ triangle.points[0].position.x, triangle.points[1].position.x, triangle.points[2].position.x })));
+				const auto x_max = static_cast<int>(std::round(std::max({ triangle.points[0].position.x, triangle.points[1].position.x, triangle.points[2].position.x })));
+				const auto y_min = static_cast<int>(std::round(std::min({ triangle.points[0].position.y, triangle.points[1].position.y, triangle.points[2].position.y })));
+				const auto y_max = static_cast<int>(std::round(std::max({ triangle.points[0].position.y, triangle.points[1].position.y, triangle.points[2].position.y })));
 
-					setPixel(Point3D(static_cast<float>(x), static_cast<float>(y), z), color);
+				if (x_max < 0 || y_max < 0 || x_min >= width || y_min >= height)
+				{
+					continue;
+				}
+
+				const auto tile_x_min = static_cast<unsigned int>(std::max(x_min, 0)) / tileSize;
+				const auto tile_x_max = static_cast<unsigned int>(std::min(x_max, width - 1)) / tileSize;
+				const auto tile_y_min = static_cast<unsigned int>(std::max(y_min, 0)) / tileSize;
+				const auto tile_y_max = static_cast<unsigned int>(std::min(y_max, height - 1)) / tileSize;
+
+				for (auto tile_y = tile_y_min; tile_y <= tile_y_max; ++tile_y)
+				{
+					for (auto tile_x = tile_x_min; tile_x <= tile_x_max; ++tile_x)
+					{
+						function(static_cast<unsigned int>(offset + k), tile_y * tilesX + tile_x);
+					}
 				}
 			}
 		}
+	};
+
+	// The tiles' lists of triangle indices are sorted in two passes, so that they fit into the frame arena, which is
+	// not thread-safe: each job first copies its triangles to their place and counts them per tile, and after the counts
+	// were turned into offsets, writes their indices; a tile's list holds the indices of one job after the other,
+	// and therefore keeps the submission order
+	FrameVector<unsigned int> counts(static_cast<std::size_t>(numJobs) * numTiles, 0, this->frameArena);
+
+	JobSystem::Group group;
+
+	this->jobs.submitRange(group, 0, static_cast<int>(numJobs), 1, [&](const int job, int)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (auto chunk = firstChunks[job]; chunk < firstChunks[job + 1]; ++chunk)
+		{
+			std::copy(chunks[chunk].first->begin(), chunks[chunk].first->end(), this->binnedTriangles.begin() + chunks[chunk].second);
+		}
+
+		auto* jobCounts = counts.data() + static_cast<std::size_t>(job) * numTiles;
+
+		forEachTile(job, [jobCounts](unsigned int, const unsigned int tile) { ++jobCounts[tile]; });
+
+		RenderStatistics counters;
+		counters.rasterizationTime = elapsedMilliseconds(start);
+
+		addStatistics(counters);
+	});
+
+	this->jobs.wait(group);
+
+	// Replace the counts by the positions where the jobs write their first index of each tile
+	auto* offsets = this->frameArena.allocateArray<unsigned int>(numTiles + 1);
+	unsigned int numIndices = 0;
+
+	for (unsigned int tile = 0; tile < numTiles; ++tile)
+	{
+		offsets[tile] = numIndices;
+
+		for (unsigned int job = 0; job < numJobs; ++job)
+		{
+			auto& count = counts[static_cast<std::size_t>(job) * numTiles + tile];
+			const auto jobIndices = count;
+
+			count = numIndices;
+			numIndices += jobIndices;
+		}
 	}
+
+	offsets[numTiles] = numIndices;
+
+	auto* indices = this->frameArena.allocateArray<unsigned int>(numIndices);
+
+	this->jobs.submitRange(group, 0, static_cast<int>(numJobs), 1, [&](const int job, int)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		auto* positions = counts.data() + static_cast<std::size_t>(job) * numTiles;
+
+		forEachTile(job, [positions, indices](const unsigned int index, const unsigned int tile) { indices[positions[tile]++] = index; });
+
+		RenderStatistics counters;
+		counters.rasterizationTime = elapsedMilliseconds(start);
+
+		addStatistics(counters);
+	});
+
+	this->binOffsets = offsets;
+	this->binnedIndices = indices;
+
+	this->jobs.wait(group);
+
+	// Each job owns a whole tile of the image and z-buffer, including the depth pyramid's regions, therefore no locking is needed
+	static_assert(tileSize % render_target::region_size == 0, "Binning tiles must consist of whole depth pyramid regions");
+
+	// How many of the tiles' jobs are queued at once depends on how fast the workers take them, so the queue must have
+	// room for all of them, or it might grow in any later frame
+	this->jobs.reserve(numTiles);
+	this->jobs.submitRange(group, 0, static_cast<int>(numTiles), 1, [this, tilesX](const int tile, int)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		const auto x_begin = (tile % tilesX) * tileSize;
+		const auto y_begin = (tile / tilesX) * tileSize;
+		const auto x_end = std::min(x_begin + tileSize, this->image.get_width()) - 1;
+		const auto y_end = std::min(y_begin + tileSize, this->image.get_height()) - 1;
+
+		RenderStatistics counters;
+
+		// Triangles are processed in submission order to get the same result as the serial rasterization
+		for (auto position = this->binOffsets[tile]; position < this->binOffsets[tile + 1]; ++position)
+		{
+			const auto index = this->binnedIndices[position];
+
+			rasterizeFilled(this->binnedTriangles[index], x_begin, y_begin, x_end, y_end, true, counters, index);
+		}
+
+		counters.rasterizationTime = elapsedMilliseconds(start);
+
+		addStatistics(counters);
+	});
+
+	this->jobs.wait(group);
+}
+
+bool cg::Rasterizer::isTileBinned(const unsigned int tile) const
+{
+	return this->binOffsets[tile] != this->binOffsets[tile + 1];
+}
+
+void cg::Rasterizer::shadeDeferred()
+{
+	using simd::float_v;
+
+	const auto width = static_cast<int>(this->image.get_width());
+	const auto height = static_cast<int>(this->image.get_height());
+
+	// Rows of the inverse view projection, to reconstruct the world space positions from the pixels' depths
+	const auto inverseViewProjection = glm::inverse(this->frameCamera.getViewProjection());
+
+	std::array<std::array<float_v, 4>, 4> rows;
+
+	for (unsigned int row = 0; row < 4; ++row)
+	{
+		for (unsigned int column = 0; column < 4; ++column)
+		{
+			rows[row][column] = float_v(inverseViewProjection[column][row]);
+		}
+	}
+
+	const auto ramp = float_v::ramp();
+	const float_v scale_x(2.0f / static_cast<float>(width));
+
+	// Shade the binning tiles in parallel, skipping the ones without triangles
+	const auto tilesX = (this->image.get_width() + tileSize - 1) / tileSize;
+	const auto tilesY = (this->image.get_height() + tileSize - 1) / tileSize;
+
+	JobSystem::Group group;
+
+	this->jobs.submitRange(group, 0, static_cast<int>(tilesX * tilesY), 1, [&](const int tile, int)
+	{
+		if (!isTileBinned(tile))
+		{
+			return;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		RenderStatistics counters;
+
+		const auto x_begin = static_cast<int>((tile % tilesX) * tileSize);
+		const auto y_begin = static_cast<int>((tile / tilesX) * tileSize);
+		const auto x_end = std::min(x_begin + static_cast<int>(tileSize), width);
+		const auto y_end = std::min(y_begin + static_cast<int>(tileSize), height);
+
+		for (int y = y_begin; y < y_end; ++y)
+		{
+			const float_v ndc_y(1.0f - 2.0f * static_cast<float>(y) / static_cast<float>(height));
+
+			for (int x_group = x_begin; x_group < x_end; x_group += static_cast<int>(float_v::size))
+			{
+				const auto lanes = std::min(static_cast<int>(float_v::size), x_end - x_group);
+
+				// Gather depth, and interpolated normal and color of the covered pixels
+				alignas(32) std::array<std::array<float, float_v::size>, 8> attributes = {};
+				unsigned int coverage = 0;
+
+				for (int lane = 0; lane < lanes; ++lane)
+				{
+					auto& sample = this->geometry(x_group + lane, y);
+
+					if (sample.triangle == g_buffer::no_triangle)
+					{
+						continue;
+					}
+
+					const auto& points = this->binnedTriangles[sample.triangle].points;
+					const std::array<float, 3> weights = { 1.0f - sample.barycentrics[0] - sample.barycentrics[1], sample.barycentrics[0], sample.barycentrics[1] };
+
+					const auto normal = weights[0] * points[0].normal + weights[1] * points[1].normal + weights[2] * points[2].normal;
+					const auto color = weights[0] * points[0].color + weights[1] * points[1].color + weights[2] * points[2].color;
+
+					attributes[0][lane] = sample.depth;
+					attributes[1][lane] = normal.x;
+					attributes[2][lane] = normal.y;
+					attributes[3][lane] = normal.z;
+					attributes[4][lane] = color.r;
+					attributes[5][lane] = color.g;
+					attributes[6][lane] = color.b;
+					attributes[7][lane] = color.a;
+
+					coverage |= 1u << lane;
+
+					// Clear the sample for the next frame
+					sample.triangle = g_buffer::no_triangle;
+				}
+
+				if (coverage == 0)
+				{
+					continue;
+				}
+
+				// Reconstruct the world space positions of all lanes, and light them at once
+				const auto ndc_x = (float_v(static_cast<float>(x_group)) + ramp) * scale_x - float_v(1.0f);
+				const auto ndc_z = float_v::load(attributes[0].data());
+
+				std::array<float_v, 4> position;
+
+				for (unsigned int row = 0; row < 4; ++row)
+				{
+					position[row] = rows[row][0] * ndc_x + rows[row][1] * ndc_y + rows[row][2] * ndc_z + rows[row][3];
+				}
+
+				std::array<float_v, 4> light;
+
+				lightVertices(this->lightSetup, { position[0] / position[3], position[1] / position[3], position[2] / position[3] },
+					{ float_v::load(attributes[1].data()), float_v::load(attributes[2].data()), float_v::load(attributes[3].data()) }, light);
+
+				alignas(32) std::array<std::array<float, float_v::size>, 4> colors;
+
+				for (unsigned int channel = 0; channel < 4; ++channel)
+				{
+					(float_v::load(attributes[4 + channel].data()) * light[channel]).store(colors[channel].data());
+				}
+
+				for (int lane = 0; lane < lanes; ++lane)
+				{
+					if ((coverage & (1u << lane)) != 0)
+					{
+						this->image(x_group + lane, y) = { colors[0][lane], colors[1][lane], colors[2][lane], colors[3][lane] };
+
+						++counters.shadedPixels;
+					}
+				}
+			}
+		}
+
+		counters.shadingTime = elapsedMilliseconds(start);
+
+		addStatistics(counters);
+	});
+
+	this->jobs.wait(group);
 }
 
-void cg::Rasterizer::rasterizeLine(const cg::Triangle::Point& point_start, const cg::Triangle::Point& point_end)
+void cg::Rasterizer::rasterizeLine(const cg::Triangle::Point& point_start, const cg::Triangle::Point& point_end, RenderStatistics& counters)
 {
+	// Count the pixels within the image, which are depth tested, and the ones written
+	const auto drawPixel = [this, &counters](const Point3D& point, const Color& color)
+	{
+		if (point.x >= 0.0f && point.x < this->image.get_width() && point.y >= 0.0f && point.y < this->image.get_height())
+		{
+			++counters.testedFragments;
+		}
+
+		counters.fragments += setPixel(point, color) ? 1 : 0;
+	};
+
 	///////
 	// TODO
 	// Implement Bresenham's line algorithm for rasterizing a single line.
@@ -340,7 +1403,7 @@ void cg::Rasterizer::rasterizeLine(const cg::Triangle::Point& point_start, const
 	c = point_start.color;
 	float interpolation;
 	float whole_length, dx, dy, dz,dxy, prozental;
-	setPixel(Point3D(x0,y0,z0), c);
+	drawPixel(Point3D(x0,y0,z0), c);
 
 	//Values for Color-Interpolation
 	dz = point_end.position.z - point_start.position.z;
@@ -380,43 +1443,98 @@ void cg::Rasterizer::rasterizeLine(const cg::Triangle::Point& point_start, const
 		//sqrt(pow(x1_end - x0_start, 2)+ pow(x1_end - y0_start, 2) + pow(z1_end - z0_start, 2));
 		//c = (1-interpolation) * point_start.color + interpolation * point_end.color;
 
-		setPixel(Point3D(x0,y0,z0), c);
+		drawPixel(Point3D(x0,y0,z0), c);
 	}
 }
 
-void cg::Rasterizer::setPixel(const Point3D& point, Color color)
+bool cg::Rasterizer::setPixel(const Point3D& point, Color color)
 {
 	const auto x = static_cast<int>(std::round(point.x));
 	const auto y = static_cast<int>(std::round(point.y));
 	const auto z = point.z;
 
-	#pragma omp critical(image_access)
+	std::lock_guard<std::mutex> lock(this->imageMutex);
+
+	return writePixel(x, y, z, color);
+}
+
+bool cg::Rasterizer::writePixel(const int x, const int y, const float z, Color color)
+{
+	// Only draw if:
+	//  - (x, y) coordinates are within the image
+	//  - z is within the camera's range [near, far]
+	//  - z is smaller than or equal to the one stored in the z-buffer
+	if (x >= 0 && x < static_cast<int>(this->image.get_width()) && y >= 0 && y < static_cast<int>(this->image.get_height())
+		&& z > this->frameCamera.getNear() && z < this->frameCamera.getFar() && this->target.depth(x, y) >= z)
 	{
-		// Only draw if:
-		//  - (x, y) coordinates are within the image
-		//  - z is within the camera's range [near, far]
-		//  - z is smaller than or equal to the one stored in the z-buffer
-		if (x >= 0 && x < static_cast<int>(this->image.get_width()) && y >= 0 && y < static_cast<int>(this->image.get_height())
-			&& z > this->camera.getNear() && z < this->camera.getFar() && this->zBuffer.at(x, y)[0] >= z)
+		auto& pixel = this->target.color(x, y);
+
+		// If z-buffer equals z-value, only draw pixel if it is lighter than the current one
+		if (this->target.depth(x, y) == z)
 		{
-			// If z-buffer equals z-value, only draw pixel if it is lighter than the current one
-			if (this->zBuffer.at(x, y)[0] == z)
-			{
-				const float r_weight = 0.2989f;
-				const float g_weight = 0.5870f;
-				const float b_weight = 0.1140f;
+			const float r_weight = 0.2989f;
+			const float g_weight = 0.5870f;
+			const float b_weight = 0.1140f;
 
-				const auto luminance_old = r_weight * this->image.at(x, y)[0] + g_weight * this->image.at(x, y)[1] + b_weight * this->image.at(x, y)[2];
-				const auto luminance_new = r_weight * color.r + g_weight * color.g + b_weight * color.b;
+			const auto luminance_old = r_weight * pixel[0] + g_weight * pixel[1] + b_weight * pixel[2];
+			const auto luminance_new = r_weight * color.r + g_weight * color.g + b_weight * color.b;
 
-				if (luminance_new < luminance_old)
-				{
-					color = vec4(this->image.at(x, y)[0], this->image.at(x, y)[1], this->image.at(x, y)[2], this->image.at(x, y)[3]);
-				}
+			if (luminance_new < luminance_old)
+			{
+				return false;
 			}
-
-			this->image.at(x, y) = { color.r, color.g, color.b, color.a };
-			this->zBuffer.at(x, y)[0] = z;
 		}
+
+		pixel = { color.r, color.g, color.b, color.a };
+		this->target.set_depth(x, y, z);
+
+		return true;
 	}
+
+	return false;
+}
+
+bool cg::Rasterizer::writeSample(const int x, const int y, const g_buffer::sample_type& sample)
+{
+	if (x >= 0 && x < static_cast<int>(this->image.get_width()) && y >= 0 && y < static_cast<int>(this->image.get_height())
+		&& sample.depth > this->frameCamera.getNear() && sample.depth < this->frameCamera.getFar() && this->target.depth(x, y) >= sample.depth)
+	{
+		this->geometry(x, y) = sample;
+		this->target.set_depth(x, y, sample.depth);
+
+		return true;
+	}
+
+	return false;
+}
+
+void cg::Rasterizer::addStatistics(const RenderStatistics& counters)
+{
+	std::lock_guard<std::mutex> lock(this->statisticsMutex);
+
+	this->statistics.culledObjects += counters.culledObjects;
+	this->statistics.submittedTriangles += counters.submittedTriangles;
+	this->statistics.frustumCulledTriangles += counters.frustumCulledTriangles;
+	this->statistics.culledBackFaces += counters.culledBackFaces;
+	this->statistics.clippedTriangles += counters.clippedTriangles;
+
+	for (unsigned int level = 0; level < Sphere::numLevelsOfDetail; ++level)
+	{
+		this->statistics.levelOfDetailSpheres[level] += counters.levelOfDetailSpheres[level];
+		this->statistics.levelOfDetailTriangles[level] += counters.levelOfDetailTriangles[level];
+	}
+
+	this->statistics.drawnTriangles += counters.drawnTriangles;
+	this->statistics.testedFragments += counters.testedFragments;
+	this->statistics.fragments += counters.fragments;
+	this->statistics.shadedPixels += counters.shadedPixels;
+	this->statistics.hiZTestedTriangles += counters.hiZTestedTriangles;
+	this->statistics.hiZRejectedTriangles += counters.hiZRejectedTriangles;
+	this->statistics.hiZTestedBlocks += counters.hiZTestedBlocks;
+	this->statistics.hiZRejectedBlocks += counters.hiZRejectedBlocks;
+	this->statistics.hiZAcceptedBlocks += counters.hiZAcceptedBlocks;
+	this->statistics.meshTime += counters.meshTime;
+	this->statistics.vertexTime += counters.vertexTime;
+	this->statistics.rasterizationTime += counters.rasterizationTime;
+	this->statistics.shadingTime += counters.shadingTime;
 }
\ No newline at end of file
@@ -1,12 +1,24 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <fstream>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "Scene/Camera.h"
+#include "FrameArena.h"
+#include "Image/GBuffer.h"
 #include "Image/Image.h"
+#include "Image/PointBuffer.h"
+#include "Image/RenderTarget.h"
+#include "JobSystem.h"
+#include "LightSetup.h"
+#include "RenderStatistics.h"
 #include "Scene/Scene.h"
 #include "Scene/Objects/SceneObject.h"
 
@@ -20,9 +32,37 @@ namespace cg
 	public:
 		enum rasterization_mode
 		{
-			POINTS, WIREFRAME, FILLED
+			POINTS, WIREFRAME, FILLED, BINNED, DEFERRED
 		};
 
+		/// Edge length of the screen tiles used for binned rasterization
+		static constexpr unsigned int tileSize = 64;
+
+		/// Edge length of the pixel blocks that are tested against a triangle at once
+		static constexpr unsigned int blockSize = 8;
+
+		/// Depth difference below which the hierarchical z-buffer does not reject or accept,
+		/// covering the rounding differences between block and per-pixel depth interpolation
+		static constexpr float depthTolerance = 1e-5f;
+
+		/// Extent of the guard band in multiples of the viewport's half size; triangles reaching beyond it are clipped
+		static constexpr float guardBand = 2.0f;
+
+		/// Largest deviation of a sphere's tessellation from the exact sphere in pixels, selecting its level of detail
+		static constexpr float maxLevelOfDetailError = 0.5f;
+
+		/// Number of vertices transformed by one job, a multiple of the SIMD width
+		static constexpr int vertexJobSize = 1024;
+
+		/// Number of triangles assembled by one job
+		static constexpr int assemblyChunkSize = 256;
+
+		/// Number of triangles after which a binning job is complete; jobs consist of whole assembly chunks
+		static constexpr std::size_t binningJobSize = 4096;
+
+		/// Number of rows copied into the image and cleared by one resolve job, whole regions of the depth pyramid
+		static constexpr int resolveBandSize = render_target::region_size;
+
 		/// <summary>
 		/// Constructor
 		/// </summary>
@@ -39,6 +79,26 @@ namespace cg
 		/// <param name="rotate">Animated rotation?</param>
 		void draw(bool rotate);
 
+		/// <summary>
+		/// Draw scene rotated by a fixed angle about the rotation axis, independent of the elapsed time
+		/// </summary>
+		/// <param name="angle">Rotation angle in degrees</param>
+		void drawRotated(float angle);
+
+		/// <summary>
+		/// First part of draw(): capture everything the frame depends on, i.e., camera, options, lights,
+		/// and the meshes and transformations of the visible objects, and resize the render target if necessary.
+		/// Afterwards, camera, options and scenes may be modified while the frame is rendered,
+		/// but the image must not be resized.
+		/// </summary>
+		/// <param name="rotate">Animated rotation?</param>
+		void prepareFrame(bool rotate);
+
+		/// <summary>
+		/// Second part of draw(): render the prepared frame into the image
+		/// </summary>
+		void renderFrame();
+
 		/// <summary>
 		/// Access camera
 		/// </summary>
@@ -93,51 +153,226 @@ namespace cg
 		/// <returns>Rotation axis</returns>
 		vec3& accessRotationAxis();
 
+		/// <summary>
+		/// Access hierarchical z-buffer option, i.e., reject hidden triangles and pixel blocks early
+		/// </summary>
+		/// <returns>Use hierarchical z-buffer?</returns>
+		bool& accessHierarchicalZ();
+
+		/// <summary>
+		/// Access front-to-back option, i.e., sort the objects by the distance of their bounding spheres
+		/// </summary>
+		/// <returns>Draw objects front to back?</returns>
+		bool& accessFrontToBack();
+
+		/// <summary>
+		/// Access level of detail option, i.e., tessellate spheres in the scene depending on their size on screen;
+		/// this applies to spheres and instances of them, but not to spheres within containers, which are part of
+		/// the container's single mesh
+		/// </summary>
+		/// <returns>Use levels of detail?</returns>
+		bool& accessLevelOfDetail();
+
+		/// <summary>
+		/// Access the path of the statistics log, to which the statistics of each frame are appended as a line of JSON
+		/// </summary>
+		/// <returns>Path of the log file, empty to disable logging</returns>
+		std::string& accessStatisticsLog();
+
+		/// <summary>
+		/// Access the number of threads executing the jobs of a frame, applied at the start of the next frame
+		/// </summary>
+		/// <returns>Number of threads, 0 for one per hardware thread</returns>
+		unsigned int& accessThreadCount();
+
+		/// <summary>
+		/// Access the thread pool executing the jobs of a frame, e.g., for processing the image on the same threads
+		/// after the frame; it must not be used while a frame is being prepared or rendered
+		/// </summary>
+		/// <returns>Job system</returns>
+		JobSystem& accessJobSystem();
+
+		/// <summary>
+		/// Get statistics of the last frame
+		/// </summary>
+		/// <returns>Statistics</returns>
+		const RenderStatistics& getStatistics() const;
+
 	private:
+		/// Visible object captured for the current frame
+		struct FrameObject
+		{
+			std::shared_ptr<const IndexedMesh> mesh;
+			mat4 transformation;
+			Color color;
+			bool backFaceCulling;
+		};
+
+		/// Intermediate results of drawing a captured object
+		struct ObjectWork
+		{
+			/// Post-transform vertex cache in the frame arena: the screen space vertices, their clip space positions
+			/// and the clip planes they are outside of
+			Triangle::Point* transformedVertices = nullptr;
+			vec4* clipPositions = nullptr;
+			unsigned int* clipOutcodes = nullptr;
+
+			/// Triangles assembled per chunk after clipping and culling, and the number of chunks of the current frame
+			std::vector<std::vector<Triangle>> assembledTriangles;
+			int numChunks = 0;
+
+			/// Vertex jobs which have not finished yet; the last one submits the assembly jobs
+			std::atomic<int> pendingVertexJobs;
+		};
+
+		/// <summary>
+		/// Capture the frame with the given additional transformation for objects (excluding lights)
+		/// </summary>
+		/// <param name="transformation">Additional transformation</param>
+		void prepareFrame(const mat4& transformation);
+
 		/// <summary>
-		/// Draw object
+		/// Check whether a scene object is visible and within the view frustum, and capture it together with its mesh
 		/// </summary>
-		/// <param name="object">Object</param>
-		/// <param name="transformation">Additional transformation for objects (excluding lights)</param>
-		void drawObject(const std::shared_ptr<SceneObject> object, const mat4& transformation);
+		/// <param name="object">Scene object</param>
+		/// <param name="transformation">Additional transformation</param>
+		/// <param name="frustumPlanes">Planes of the view frustum</param>
+		/// <param name="result">Distance of the nearest point of the object's bounding sphere, and the captured object</param>
+		/// <param name="counters">Statistics to add the culled object or its triangles to</param>
+		/// <returns>True if the object is drawn</returns>
+		bool collectObject(const SceneObject& object, const mat4& transformation, const std::array<vec4, 6>& frustumPlanes,
+			std::pair<float, FrameObject>& result, RenderStatistics& counters) const;
+
+		/// <summary>
+		/// Submit the jobs drawing a captured object: the vertex jobs, followed by the assembly jobs,
+		/// which rasterize the triangles right away or collect them for binning
+		/// </summary>
+		/// <param name="index">Index of the captured object</param>
+		/// <param name="group">Job group of the frame</param>
+		void drawObject(unsigned int index, JobSystem::Group& group);
+
+		/// <summary>
+		/// Transform and light a range of vertices of a captured object
+		/// </summary>
+		/// <param name="index">Index of the captured object</param>
+		/// <param name="first">First vertex, a multiple of the SIMD width</param>
+		/// <param name="last">Vertex after the last one</param>
+		void processVertices(unsigned int index, int first, int last);
+
+		/// <summary>
+		/// Assemble, clip and cull a chunk of triangles of a captured object
+		/// </summary>
+		/// <param name="index">Index of the captured object</param>
+		/// <param name="chunk">Chunk of assemblyChunkSize triangles</param>
+		void assembleTriangles(unsigned int index, int chunk);
+
+		/// <summary>
+		/// Transform a clip space position to screen space, and set the point's position and validity flags
+		/// </summary>
+		/// <param name="position">Position in clip space</param>
+		/// <param name="point">Point</param>
+		void projectToScreen(const vec4& position, Triangle::Point& point) const;
 
 		/// <summary>
 		/// Draw triangle
 		/// </summary>
 		/// <param name="triangle">Triangle</param>
-		void drawTriangle(const Triangle& triangle);
+		/// <param name="counters">Statistics of the calling assembly chunk, which are added to the frame's once per chunk</param>
+		void drawTriangle(const Triangle& triangle, RenderStatistics& counters);
 
 		/// <summary>
-		/// Draw triangle points
+		/// Draw triangle points by splatting them into the point buffer
 		/// </summary>
 		/// <param name="triangle">Triangle</param>
-		void rasterizePoints(const Triangle& triangle);
+		/// <param name="counters">Statistics to count the tested and written pixels in</param>
+		void rasterizePoints(const Triangle& triangle, RenderStatistics& counters);
 
 		/// <summary>
 		/// Draw triangle edges
 		/// </summary>
 		/// <param name="triangle">Triangle</param>
-		void drawWireframe(const Triangle& triangle);
+		/// <param name="counters">Statistics to count the tested and written pixels in</param>
+		void drawWireframe(const Triangle& triangle, RenderStatistics& counters);
 
 		/// <summary>
 		/// Draw filled triangle
 		/// </summary>
 		/// <param name="triangle">Triangle</param>
-		void rasterizeFilled(const Triangle& triangle);
+		/// <param name="counters">Statistics to count the tested and written pixels in</param>
+		void rasterizeFilled(const Triangle& triangle, RenderStatistics& counters);
+
+		/// <summary>
+		/// Draw the part of a filled triangle that lies within the given screen region
+		/// </summary>
+		/// <param name="triangle">Triangle</param>
+		/// <param name="x_begin">First column of the region</param>
+		/// <param name="y_begin">First row of the region</param>
+		/// <param name="x_end">Last column of the region</param>
+		/// <param name="y_end">Last row of the region</param>
+		/// <param name="exclusive">Is the region owned by the calling thread, i.e., no locking is necessary?</param>
+		/// <param name="counters">Statistics of the calling job, so that tile jobs count without locking</param>
+		/// <param name="index">Index of the triangle within the binned triangles, which is stored in the G-buffer in deferred mode</param>
+		void rasterizeFilled(const Triangle& triangle, unsigned int x_begin, unsigned int y_begin, unsigned int x_end, unsigned int y_end, bool exclusive,
+			RenderStatistics& counters, unsigned int index = 0);
+
+		/// <summary>
+		/// Sort the collected triangles into screen tiles and rasterize all tiles in parallel
+		/// </summary>
+		void rasterizeBins();
+
+		/// <summary>
+		/// Check whether any triangle was sorted into a screen tile
+		/// </summary>
+		/// <param name="tile">Tile index</param>
+		/// <returns>True if the tile is not empty</returns>
+		bool isTileBinned(unsigned int tile) const;
+
+		/// <summary>
+		/// Light each pixel covered in the G-buffer once, interpolating normal and color of its triangle,
+		/// write it to the image and clear the G-buffer for the next frame
+		/// </summary>
+		void shadeDeferred();
 
 		/// <summary>
 		/// Draw line
 		/// </summary>
 		/// <param name="point_start">Starting point of the line</param>
 		/// <param name="point_end">End point of the line</param>
-		void rasterizeLine(const Triangle::Point& point_start, const Triangle::Point& point_end);
+		/// <param name="counters">Statistics to count the tested and written pixels in</param>
+		void rasterizeLine(const Triangle::Point& point_start, const Triangle::Point& point_end, RenderStatistics& counters);
 
 		/// <summary>
 		/// Draw single pixel
 		/// </summary>
 		/// <param name="point">Point</param>
 		/// <param name="color">Color</param>
-		void setPixel(const Point3D& point, Color color);
+		/// <returns>True if the pixel passed the depth test and was written</returns>
+		bool setPixel(const Point3D& point, Color color);
+
+		/// <summary>
+		/// Draw single pixel without synchronization; the caller must own the pixel
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <param name="z">Depth</param>
+		/// <param name="color">Color</param>
+		/// <returns>True if the pixel passed the depth test and was written</returns>
+		bool writePixel(int x, int y, float z, Color color);
+
+		/// <summary>
+		/// Write a sample to the G-buffer if it passes the same tests as in writePixel, without locking
+		/// </summary>
+		/// <param name="x">Pixel column</param>
+		/// <param name="y">Pixel row</param>
+		/// <param name="sample">Triangle index, depth and barycentric weights</param>
+		/// <returns>True if the pixel passed the depth test and was written</returns>
+		bool writeSample(int x, int y, const g_buffer::sample_type& sample);
+
+		/// <summary>
+		/// Add counters and times to the frame statistics; thread-safe
+		/// </summary>
+		/// <param name="counters">Counters to add</param>
+		void addStatistics(const RenderStatistics& counters);
 
 		/// Camera
 		Camera camera;
@@ -149,11 +384,60 @@ namespace cg
 		/// Rasterization mode
 		rasterization_mode mode;
 
-		/// Rasterized image
+		/// Rasterized image, resolved from the render target after each frame
 		cg::image<cg::color_space_t::RGBA> image;
 
-		/// z-Buffer
-		cg::image<cg::color_space_t::Gray> zBuffer;
+		/// Tiled color and z-buffer
+		cg::render_target target;
+
+		/// Combined depth and color buffer of the points mode
+		cg::point_buffer points;
+
+		/// Visible triangles of the deferred mode, only allocated when used
+		cg::g_buffer geometry;
+
+		/// State captured for the current frame: camera, options, visible objects and lights
+		Camera frameCamera;
+		rasterization_mode frameMode;
+		bool frameHierarchicalZ;
+		std::string frameStatisticsLog;
+		std::vector<FrameObject> frameObjects;
+		LightSetup lightSetup;
+
+		/// Intermediate results per captured object, kept for reusing their memory
+		std::vector<std::unique_ptr<ObjectWork>> objectWork;
+
+		/// Memory for the temporaries of a frame, reset when the next frame is prepared
+		FrameArena frameArena;
+
+		/// Screen space triangles collected for binned rasterization, and the indices of the triangles overlapping each tile
+		/// in submission order, placed in the frame arena: the ones of tile t from binnedIndices[binOffsets[t]] to binnedIndices[binOffsets[t + 1] - 1]
+		std::vector<Triangle> binnedTriangles;
+		const unsigned int* binOffsets;
+		const unsigned int* binnedIndices;
+
+		/// Thread pool executing the jobs of a frame, the requested number of threads and the one it was started with
+		JobSystem jobs;
+		unsigned int threadCount;
+		unsigned int frameThreadCount;
+
+		/// Guards the render target in the modes without binning, and the statistics
+		std::mutex imageMutex;
+		std::mutex statisticsMutex;
+
+		/// Hierarchical z-buffer, front-to-back sorting and level of detail options
+		bool hierarchicalZ;
+		bool frontToBack;
+		bool levelOfDetail;
+
+		/// Statistics of the current or last frame, and number of frames prepared so far
+		RenderStatistics statistics;
+		unsigned long long frameCount;
+
+		/// Path of the statistics log, and the log file currently open with its path
+		std::string statisticsLog;
+		std::ofstream statisticsStream;
+		std::string statisticsStreamPath;
 
 		/// Last rotation time and rotation speed
 		std::chrono::milliseconds lastRotation;
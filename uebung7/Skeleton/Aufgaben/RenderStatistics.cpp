@@ -0,0 +1,58 @@
+#include "RenderStatistics.h"
+
+#include <sstream>
+
+double cg::getOverdraw(const RenderStatistics& statistics)
+{
+	return statistics.coveredPixels != 0 ? static_cast<double>(statistics.fragments) / static_cast<double>(statistics.coveredPixels) : 0.0;
+}
+
+void cg::writeJson(std::ostream& stream, const RenderStatistics& statistics)
+{
+	// Format independently of the flags set on the target stream
+	std::ostringstream json;
+
+	const auto writeArray = [&json](const std::array<unsigned long long, Sphere::numLevelsOfDetail>& values)
+	{
+		json << "[";
+
+		for (unsigned int level = 0; level < values.size(); ++level)
+		{
+			json << (level != 0 ? ", " : "") << values[level];
+		}
+
+		json << "]";
+	};
+
+	json << "{\"frame\": " << statistics.frame
+		<< ", \"culledObjects\": " << statistics.culledObjects
+		<< ", \"submittedTriangles\": " << statistics.submittedTriangles
+		<< ", \"frustumCulledTriangles\": " << statistics.frustumCulledTriangles
+		<< ", \"culledBackFaces\": " << statistics.culledBackFaces
+		<< ", \"clippedTriangles\": " << statistics.clippedTriangles
+		<< ", \"levelOfDetailSpheres\": ";
+	writeArray(statistics.levelOfDetailSpheres);
+	json << ", \"levelOfDetailTriangles\": ";
+	writeArray(statistics.levelOfDetailTriangles);
+	json << ", \"drawnTriangles\": " << statistics.drawnTriangles
+		<< ", \"testedFragments\": " << statistics.testedFragments
+		<< ", \"fragments\": " << statistics.fragments
+		<< ", \"coveredPixels\": " << statistics.coveredPixels
+		<< ", \"overdraw\": " << getOverdraw(statistics)
+		<< ", \"shadedPixels\": " << statistics.shadedPixels
+		<< ", \"hiZTestedTriangles\": " << statistics.hiZTestedTriangles
+		<< ", \"hiZRejectedTriangles\": " << statistics.hiZRejectedTriangles
+		<< ", \"hiZTestedBlocks\": " << statistics.hiZTestedBlocks
+		<< ", \"hiZRejectedBlocks\": " << statistics.hiZRejectedBlocks
+		<< ", \"hiZAcceptedBlocks\": " << statistics.hiZAcceptedBlocks
+		<< ", \"meshTime\": " << statistics.meshTime
+		<< ", \"vertexTime\": " << statistics.vertexTime
+		<< ", \"rasterizationTime\": " << statistics.rasterizationTime
+		<< ", \"shadingTime\": " << statistics.shadingTime
+		<< ", \"resolveTime\": " << statistics.resolveTime
+		<< ", \"frameTime\": " << statistics.frameTime
+		<< ", \"heapAllocations\": " << statistics.heapAllocations
+		<< ", \"frameArenaBytes\": " << statistics.frameArenaBytes << "}";
+
+	stream << json.str();
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Scene/Objects/Sphere.h"
+
+#include <array>
+#include <ostream>
+
+namespace cg
+{
+	/// <summary>
+	/// Counters collected by the rasterizer while drawing a frame
+	/// </summary>
+	struct RenderStatistics
+	{
+		/// Number of the frame, counted from 0 since the rasterizer was created
+		unsigned long long frame = 0;
+
+		/// Objects skipped, because their bounding sphere is outside of the view frustum
+		unsigned long long culledObjects = 0;
+
+		/// Triangles of the meshes of all objects within the view frustum, before culling and clipping
+		unsigned long long submittedTriangles = 0;
+
+		/// Triangles discarded, because they lie completely outside of one clip plane
+		unsigned long long frustumCulledTriangles = 0;
+
+		/// Triangles discarded, because they face away from the camera
+		unsigned long long culledBackFaces = 0;
+
+		/// Triangles clipped against the near or far plane or the guard band
+		unsigned long long clippedTriangles = 0;
+
+		/// Spheres drawn with each level of detail, and their triangles before culling
+		std::array<unsigned long long, Sphere::numLevelsOfDetail> levelOfDetailSpheres = {};
+		std::array<unsigned long long, Sphere::numLevelsOfDetail> levelOfDetailTriangles = {};
+
+		/// Triangles passed on to rasterization after culling and clipping
+		unsigned long long drawnTriangles = 0;
+
+		/// Pixels covered by filled triangles, lines or points, which were depth tested or accepted as part of a block
+		unsigned long long testedFragments = 0;
+
+		/// Pixels of filled triangles, lines or points, which passed the depth test and were written
+		unsigned long long fragments = 0;
+
+		/// Pixels covered by at least one filled triangle, line or point at the end of the frame
+		unsigned long long coveredPixels = 0;
+
+		/// Pixels lit in the deferred shading pass
+		unsigned long long shadedPixels = 0;
+
+		/// Triangles tested against the hierarchical z-buffer (once per tile in binned mode), and rejected ones
+		unsigned long long hiZTestedTriangles = 0;
+		unsigned long long hiZRejectedTriangles = 0;
+
+		/// Pixel blocks tested against the hierarchical z-buffer, rejected ones,
+		/// and accepted ones, which are drawn without per-pixel depth test
+		unsigned long long hiZTestedBlocks = 0;
+		unsigned long long hiZRejectedBlocks = 0;
+		unsigned long long hiZAcceptedBlocks = 0;
+
+		/// Time in milliseconds spent on collecting the visible objects and their meshes;
+		/// like the following stages, summed over all threads, as the jobs of different objects and stages overlap
+		double meshTime = 0.0;
+
+		/// Time in milliseconds spent on transforming and lighting the vertices
+		double vertexTime = 0.0;
+
+		/// Time in milliseconds spent on assembling, clipping, culling, binning and rasterizing the triangles
+		double rasterizationTime = 0.0;
+
+		/// Time in milliseconds spent on lighting the pixels in deferred mode
+		double shadingTime = 0.0;
+
+		/// Time in milliseconds spent on copying the render target into the image and clearing it for the next frame,
+		/// which is a separate pass
+		double resolveTime = 0.0;
+
+		/// Time in milliseconds of the whole frame, including the preparation
+		double frameTime = 0.0;
+
+		/// Heap allocations of the whole program while the frame was prepared and rendered,
+		/// which also include the ones of other threads, e.g., of the viewer's user interface
+		unsigned long long heapAllocations = 0;
+
+		/// Bytes of the frame's temporaries in the frame arena
+		unsigned long long frameArenaBytes = 0;
+	};
+
+	/// <summary>
+	/// Compute the overdraw factor, i.e., the average number of fragments written per covered pixel
+	/// </summary>
+	/// <param name="statistics">Statistics of a frame</param>
+	/// <returns>Overdraw factor, 0 if no pixel is covered</returns>
+	double getOverdraw(const RenderStatistics& statistics);
+
+	/// <summary>
+	/// Write the statistics of a frame as a JSON object on a single line
+	/// </summary>
+	/// <param name="stream">Output stream</param>
+	/// <param name="statistics">Statistics of a frame</param>
+	void writeJson(std::ostream& stream, const RenderStatistics& statistics);
+}
@@ -3,6 +3,9 @@
 #include "../glm/gtc/matrix_transform.hpp"
 #include "../glm/gtc/matrix_inverse.hpp"
 
+#include <cmath>
+#include <limits>
+
 cg::Camera::Camera(const float fov, const float aspect, const float near, const float far, const Point3D& position, const Point3D& lookat, const vec3& up)
 	: fov(fov), aspect(aspect), near(near), far(far), position(position), lookat(lookat), up(up)
 {
@@ -41,6 +44,39 @@ cg::mat4 cg::Camera::getViewProjection() const
 	return this->viewProjection;
 }
 
+std::array<cg::vec4, 6> cg::Camera::getFrustumPlanes() const
+{
+	// Extract the planes from the rows of the view projection matrix
+	const auto& m = this->viewProjection;
+
+	const vec4 row_x(m[0][0], m[1][0], m[2][0], m[3][0]);
+	const vec4 row_y(m[0][1], m[1][1], m[2][1], m[3][1]);
+	const vec4 row_z(m[0][2], m[1][2], m[2][2], m[3][2]);
+	const vec4 row_w(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	std::array<vec4, 6> planes = { row_w + row_x, row_w - row_x, row_w + row_y, row_w - row_y, row_w + row_z, row_w - row_z };
+
+	for (auto& plane : planes)
+	{
+		plane /= glm::length(vec3(plane));
+	}
+
+	return planes;
+}
+
+float cg::Camera::getProjectedRadius(const BoundingSphere& sphere, const float height) const
+{
+	const auto distance = glm::length(sphere.center - this->position);
+
+	if (distance <= sphere.radius)
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+
+	// The tangent cone of the sphere has the half angle asin(r / d), scaled by the focal length of the projection
+	return sphere.radius / std::sqrt(distance * distance - sphere.radius * sphere.radius) * this->projection[1][1] * 0.5f * height;
+}
+
 void cg::Camera::setFov(const float fov)
 {
 	this->fov = fov;
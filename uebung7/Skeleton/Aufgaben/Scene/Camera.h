@@ -26,6 +26,20 @@ namespace cg
 		mat4 getView() const;
 		mat4 getViewProjection() const;
 
+		/// <summary>
+		/// Get the planes of the view frustum in world space (left, right, bottom, top, near, far);
+		/// the normals are normalized and point inwards
+		/// </summary>
+		std::array<vec4, 6> getFrustumPlanes() const;
+
+		/// <summary>
+		/// Get the radius of a sphere in world space projected onto the image, which is infinite if the camera is inside
+		/// </summary>
+		/// <param name="sphere">Sphere in world space</param>
+		/// <param name="height">Image height in pixels</param>
+		/// <returns>Projected radius in pixels</returns>
+		float getProjectedRadius(const BoundingSphere& sphere, float height) const;
+
 		/// <summary>
 		/// Set or get camera parameters
 		/// </summary>
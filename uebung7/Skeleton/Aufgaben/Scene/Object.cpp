@@ -2,15 +2,16 @@
 
 #include "../glm/gtc/matrix_transform.hpp"
 
-cg::Object::Object() : transformation(unitMat4()), visible(true)
+cg::Object::Object() : transformation(unitMat4()), version(0), transformationVersion(0), visible(true)
 { }
 
-cg::Object::Object(const mat4& transformation) : transformation(transformation), visible(true)
+cg::Object::Object(const mat4& transformation) : transformation(transformation), version(0), transformationVersion(0), visible(true)
 { }
 
 void cg::Object::Transform(const mat4& transformation)
 {
 	this->transformation *= transformation;
+	++this->transformationVersion;
 }
 
 void cg::Object::Rotate(float alpha, float beta, float gamma)
@@ -18,16 +19,19 @@ void cg::Object::Rotate(float alpha, float beta, float gamma)
 	this->transformation = glm::gtc::matrix_transform::rotate(this->transformation, alpha, vec3(1.0f, 0.0f, 0.0f));
 	this->transformation = glm::gtc::matrix_transform::rotate(this->transformation, beta, vec3(0.0f, 1.0f, 0.0f));
 	this->transformation = glm::gtc::matrix_transform::rotate(this->transformation, gamma, vec3(0.0f, 0.0f, 1.0f));
+	++this->transformationVersion;
 }
 
 void cg::Object::Translate(const vec3& translation)
 {
 	this->transformation = glm::gtc::matrix_transform::translate(this->transformation, vec3(-translation[0], translation[1], translation[2]));
+	++this->transformationVersion;
 }
 
 void cg::Object::Scale(const vec3& scale)
 {
 	this->transformation = glm::gtc::matrix_transform::scale(this->transformation, scale);
+	++this->transformationVersion;
 }
 
 cg::mat4 cg::Object::getTransformation() const
@@ -35,6 +39,16 @@ cg::mat4 cg::Object::getTransformation() const
 	return this->transformation;
 }
 
+unsigned int cg::Object::getVersion() const
+{
+	return this->version;
+}
+
+unsigned int cg::Object::getTransformationVersion() const
+{
+	return this->transformationVersion;
+}
+
 bool& cg::Object::accessVisibility()
 {
 	return this->visible;
@@ -61,6 +61,19 @@ namespace cg
 		/// <returns>Model matrix</returns>
 		mat4 getTransformation() const;
 
+		/// <summary>
+		/// Get the version of the object, which is increased on every modification except of the transformation
+		/// </summary>
+		/// <returns>Version</returns>
+		unsigned int getVersion() const;
+
+		/// <summary>
+		/// Get the version of the model transform matrix, which is increased whenever it changes; it is tracked
+		/// separately, as the object's own transformation is applied while drawing and does not affect its mesh
+		/// </summary>
+		/// <returns>Transformation version</returns>
+		unsigned int getTransformationVersion() const;
+
 		/// <summary>
 		/// Access visibility property
 		/// </summary>
@@ -77,6 +90,10 @@ namespace cg
 		/// Model transform matrix
 		mat4 transformation;
 
+		/// Modification counters of the object and of its transformation
+		unsigned int version;
+		unsigned int transformationVersion;
+
 		/// Visibility
 		bool visible;
 	};
@@ -5,6 +5,7 @@
 void cg::Container::addObject(std::shared_ptr<SceneObject> object)
 {
 	this->objects.push_back(object);
+	++Object::version;
 }
 
 std::string cg::Container::getShapeName() const
@@ -12,31 +13,60 @@ std::string cg::Container::getShapeName() const
 	return "Container";
 }
 
-cg::TriangleMesh cg::Container::calculateMesh() const
+cg::IndexedMesh cg::Container::calculateIndexedMesh() const
 {
-	TriangleMesh mesh;
+	IndexedMesh mesh;
 
-	// Get objects' triangle meshes into container space and return them
+	// Get objects' meshes into container space and return them
 	for (const auto& object : this->objects)
 	{
 		const auto transformation = object->getTransformation();
 		const auto normalTransformation = glm::gtc::matrix_inverse::inverseTranspose(transformation);
 
-		auto objectMesh = object->calculateMesh();
+		const auto objectMesh = object->getMesh();
+		const auto offset = static_cast<IndexedMesh::index_type>(mesh.vertices.size());
 
-		for (auto& triangle : objectMesh)
+		for (auto vertex : objectMesh->vertices)
 		{
-			triangle.points[0].position = vec3(transformation * vec4(triangle.points[0].position, 1.0f));
-			triangle.points[1].position = vec3(transformation * vec4(triangle.points[1].position, 1.0f));
-			triangle.points[2].position = vec3(transformation * vec4(triangle.points[2].position, 1.0f));
+			vertex.position = vec3(transformation * vec4(vertex.position, 1.0f));
+			vertex.normal = vec3(normalTransformation * vec4(vertex.normal, 0.0f));
 
-			triangle.points[0].normal = vec3(normalTransformation * vec4(triangle.points[0].normal, 0.0f));
-			triangle.points[1].normal = vec3(normalTransformation * vec4(triangle.points[1].normal, 0.0f));
-			triangle.points[2].normal = vec3(normalTransformation * vec4(triangle.points[2].normal, 0.0f));
+			mesh.vertices.push_back(vertex);
 		}
 
-		mesh.insert(mesh.end(), objectMesh.begin(), objectMesh.end());
+		for (const auto index : objectMesh->indices)
+		{
+			mesh.indices.push_back(offset + index);
+		}
 	}
 
 	return mesh;
+}
+
+cg::BoundingSphere cg::Container::calculateBoundingSphere() const
+{
+	std::vector<BoundingSphere> spheres;
+	spheres.reserve(this->objects.size());
+
+	// Get objects' bounding spheres in container space and enclose them
+	for (const auto& object : this->objects)
+	{
+		spheres.push_back(transformBoundingSphere(object->getBoundingSphere(), object->getTransformation()));
+	}
+
+	return mergeBoundingSpheres(spheres);
+}
+
+unsigned int cg::Container::getMeshVersion() const
+{
+	// Contained objects' versions only increase, so any modification changes the sum; their transformations
+	// are part of the container's mesh, unlike the container's own one
+	auto version = Object::version;
+
+	for (const auto& object : this->objects)
+	{
+		version += object->getMeshVersion() + object->getTransformationVersion();
+	}
+
+	return version;
 }
\ No newline at end of file
@@ -22,10 +22,22 @@ namespace cg
 		virtual std::string getShapeName() const;
 
 		/// <summary>
-		/// Calculate and return a triangle mesh representing the object
+		/// Calculate and return an indexed mesh representing the object
 		/// </summary>
-		/// <returns>Triangle mesh</returns>
-		virtual TriangleMesh calculateMesh() const;
+		/// <returns>Indexed mesh</returns>
+		virtual IndexedMesh calculateIndexedMesh() const;
+
+		/// <summary>
+		/// Calculate the bounding sphere enclosing the bounding spheres of all contained objects
+		/// </summary>
+		/// <returns>Bounding sphere</returns>
+		virtual BoundingSphere calculateBoundingSphere() const;
+
+		/// <summary>
+		/// Get the version of the container's mesh, which also changes if any contained object or its transformation is modified
+		/// </summary>
+		/// <returns>Mesh version</returns>
+		virtual unsigned int getMeshVersion() const;
 
 	private:
 		/// Scene objects
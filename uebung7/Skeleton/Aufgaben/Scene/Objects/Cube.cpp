@@ -3,16 +3,24 @@
 #include <cmath>
 
 cg::Cube::Cube(const float edgeLength, const Color& color) : SceneObject(color), edgeLength(std::abs(edgeLength))
-{ }
+{
+	// Closed surface, the back faces are always hidden
+	SceneObject::backFaceCulling = true;
+}
 
 std::string cg::Cube::getShapeName() const
 {
 	return "Cube";
 }
 
-cg::TriangleMesh cg::Cube::calculateMesh() const
+cg::BoundingSphere cg::Cube::calculateBoundingSphere() const
+{
+	return BoundingSphere{ zeroVec3(), this->edgeLength * std::sqrt(3.0f) / 2.0f };
+}
+
+cg::IndexedMesh cg::Cube::calculateIndexedMesh() const
 {
-	cg::TriangleMesh mesh;
+	cg::IndexedMesh mesh;
 
 	if (this->edgeLength != 0.0f)
 	{
@@ -28,97 +36,38 @@ cg::TriangleMesh cg::Cube::calculateMesh() const
 		const Point3D right_top_front(edgeLengthHalf, edgeLengthHalf, -edgeLengthHalf);
 		const Point3D right_top_back(edgeLengthHalf, edgeLengthHalf, edgeLengthHalf);
 
+		// Each face has its own four vertices, because the normals differ per face,
+		// and consists of the triangles (0, 1, 2) and (0, 2, 3); the corners are given
+		// counter-clockwise when looking at the face from outside
+		const auto addFace = [this, &mesh](const Point3D& corner_0, const Point3D& corner_1, const Point3D& corner_2, const Point3D& corner_3, const Point3D& normal)
+		{
+			const auto first = static_cast<IndexedMesh::index_type>(mesh.vertices.size());
+
+			mesh.vertices.push_back(Triangle::Point{ corner_0, normal, SceneObject::color });
+			mesh.vertices.push_back(Triangle::Point{ corner_1, normal, SceneObject::color });
+			mesh.vertices.push_back(Triangle::Point{ corner_2, normal, SceneObject::color });
+			mesh.vertices.push_back(Triangle::Point{ corner_3, normal, SceneObject::color });
+
+			mesh.indices.insert(mesh.indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+		};
+
 		// Create front triangles
-		const Triangle front_1 = { 
-			std::array<Triangle::Point, 3> {
-				Triangle::Point { left_bottom_front, Point3D(0.0f, 0.0f, -1.0f), SceneObject::color },
-				Triangle::Point { left_top_front, Point3D(0.0f, 0.0f, -1.0f), SceneObject::color },
-				Triangle::Point { right_top_front, Point3D(0.0f, 0.0f, -1.0f), SceneObject::color } } };
-
-		const Triangle front_2 = {
-			std::array<Triangle::Point, 3> {
-				Triangle::Point{ left_bottom_front, Point3D(0.0f, 0.0f, -1.0f), SceneObject::color },
-				Triangle::Point{ right_top_front, Point3D(0.0f, 0.0f, -1.0f), SceneObject::color },
-				Triangle::Point{ right_bottom_front, Point3D(0.0f, 0.0f, -1.0f), SceneObject::color } } };
+		addFace(left_bottom_front, left_top_front, right_top_front, right_bottom_front, Point3D(0.0f, 0.0f, -1.0f));
 
 		// Create back triangles
-		const Triangle back_1 = {
-			std::array<Triangle::Point, 3> {
-				Triangle::Point{ left_bottom_back, Point3D(0.0f, 0.0f, 1.0f), SceneObject::color },
-				Triangle::Point{ right_bottom_back, Point3D(0.0f, 0.0f, 1.0f), SceneObject::color },
-				Triangle::Point{ right_top_back, Point3D(0.0f, 0.0f, 1.0f), SceneObject::color } } };
-
-		const Triangle back_2 = {
-			std::array<Triangle::Point, 3> {
-				Triangle::Point{ left_bottom_back, Point3D(0.0f, 0.0f, 1.0f), SceneObject::color },
-				Triangle::Point{ right_top_back, Point3D(0.0f, 0.0f, 1.0f), SceneObject::color },
-				Triangle::Point{ left_top_back, Point3D(0.0f, 0.0f, 1.0f), SceneObject::color } } };
+		addFace(left_bottom_back, right_bottom_back, right_top_back, left_top_back, Point3D(0.0f, 0.0f, 1.0f));
 
 		// Create bottom triangles
-		const Triangle bottom_1 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ left_bottom_front, Point3D(0.0f, -1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_bottom_front, Point3D(0.0f, -1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_bottom_back, Point3D(0.0f, -1.0f, 0.0f), SceneObject::color } } };
-
-		const Triangle bottom_2 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ left_bottom_front, Point3D(0.0f, -1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_bottom_back, Point3D(0.0f, -1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ left_bottom_back, Point3D(0.0f, -1.0f, 0.0f), SceneObject::color } } };
+		addFace(left_bottom_front, right_bottom_front, right_bottom_back, left_bottom_back, Point3D(0.0f, -1.0f, 0.0f));
 
 		// Create top triangles
-		const Triangle top_1 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ left_top_front, Point3D(0.0f, 1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ left_top_back, Point3D(0.0f, 1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_top_back, Point3D(0.0f, 1.0f, 0.0f), SceneObject::color } } };
-
-		const Triangle top_2 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ left_top_front, Point3D(0.0f, 1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_top_back, Point3D(0.0f, 1.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_top_front, Point3D(0.0f, 1.0f, 0.0f), SceneObject::color } } };
+		addFace(left_top_front, left_top_back, right_top_back, right_top_front, Point3D(0.0f, 1.0f, 0.0f));
 
 		// Create left triangles
-		const Triangle left_1 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ left_bottom_front, Point3D(-1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ left_top_front, Point3D(-1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ left_top_back, Point3D(-1.0f, 0.0f, 0.0f), SceneObject::color } } };
-
-		const Triangle left_2 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ left_bottom_front, Point3D(-1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ left_top_back, Point3D(-1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ left_bottom_back, Point3D(-1.0f, 0.0f, 0.0f), SceneObject::color } } };
+		addFace(left_bottom_front, left_bottom_back, left_top_back, left_top_front, Point3D(-1.0f, 0.0f, 0.0f));
 
 		// Create right triangles
-		const Triangle right_1 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ right_bottom_front, Point3D(1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_bottom_back, Point3D(1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_top_back, Point3D(1.0f, 0.0f, 0.0f), SceneObject::color } } };
-
-		const Triangle right_2 = {
-			std::array<Triangle::Point, 3> {
-			Triangle::Point{ right_bottom_front, Point3D(1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_top_back, Point3D(1.0f, 0.0f, 0.0f), SceneObject::color },
-				Triangle::Point{ right_top_front, Point3D(1.0f, 0.0f, 0.0f), SceneObject::color } } };
-
-		// Add triangles to mesh
-		mesh.push_back(front_1);
-		mesh.push_back(front_2);
-		mesh.push_back(back_1);
-		mesh.push_back(back_2);
-		mesh.push_back(bottom_1);
-		mesh.push_back(bottom_2);
-		mesh.push_back(top_1);
-		mesh.push_back(top_2);
-		mesh.push_back(left_1);
-		mesh.push_back(left_2);
-		mesh.push_back(right_1);
-		mesh.push_back(right_2);
+		addFace(right_bottom_front, right_top_front, right_top_back, right_bottom_back, Point3D(1.0f, 0.0f, 0.0f));
 	}
 
 	return mesh;
@@ -24,10 +24,16 @@ namespace cg
 		virtual std::string getShapeName() const;
 
 		/// <summary>
-		/// Calculate and return a triangle mesh representing the object
+		/// Calculate and return an indexed mesh representing the object
 		/// </summary>
-		/// <returns>Triangle mesh</returns>
-		virtual TriangleMesh calculateMesh() const;
+		/// <returns>Indexed mesh</returns>
+		virtual IndexedMesh calculateIndexedMesh() const;
+
+		/// <summary>
+		/// Calculate the bounding sphere through the cube's corners
+		/// </summary>
+		/// <returns>Bounding sphere</returns>
+		virtual BoundingSphere calculateBoundingSphere() const;
 
 	private:
 		/// Edge length
@@ -0,0 +1,52 @@
+#include "Instance.h"
+
+cg::Instance::Instance(std::shared_ptr<const SceneObject> object, const Color& color) : SceneObject(color), object(object)
+{
+	SceneObject::backFaceCulling = object->isBackFaceCulled();
+}
+
+std::string cg::Instance::getShapeName() const
+{
+	return "Instance of " + this->object->getShapeName();
+}
+
+cg::IndexedMesh cg::Instance::calculateIndexedMesh() const
+{
+	return *this->object->getMesh();
+}
+
+std::shared_ptr<const cg::IndexedMesh> cg::Instance::getMesh() const
+{
+	return this->object->getMesh();
+}
+
+bool cg::Instance::hasLevelsOfDetail() const
+{
+	return this->object->hasLevelsOfDetail();
+}
+
+std::shared_ptr<const cg::IndexedMesh> cg::Instance::getLevelOfDetailMesh(const unsigned int level) const
+{
+	return this->object->getLevelOfDetailMesh(level);
+}
+
+cg::BoundingSphere cg::Instance::calculateBoundingSphere() const
+{
+	return this->object->getBoundingSphere();
+}
+
+unsigned int cg::Instance::getMeshVersion() const
+{
+	// Both versions only increase, so any modification changes the sum
+	return Object::version + this->object->getMeshVersion();
+}
+
+cg::Color cg::Instance::getMeshColor() const
+{
+	return this->color;
+}
+
+std::shared_ptr<const cg::SceneObject> cg::Instance::getObject() const
+{
+	return this->object;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "SceneObject.h"
+
+#include <memory>
+
+namespace cg
+{
+	/// <summary>
+	/// Instance of another scene object, sharing its geometry but having an own transformation and color
+	/// </summary>
+	class Instance : public SceneObject
+	{
+	public:
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="object">Shared object, whose mesh is used in its object space</param>
+		/// <param name="color">Color the shared mesh's vertex colors are multiplied with</param>
+		Instance(std::shared_ptr<const SceneObject> object, const Color& color = white());
+
+		/// <summary>
+		/// Return the name of the shape
+		/// </summary>
+		/// <returns>Shape name</returns>
+		virtual std::string getShapeName() const;
+
+		/// <summary>
+		/// Calculate and return a copy of the shared object's indexed mesh
+		/// </summary>
+		/// <returns>Indexed mesh</returns>
+		virtual IndexedMesh calculateIndexedMesh() const;
+
+		/// <summary>
+		/// Return the shared object's cached mesh without copying it
+		/// </summary>
+		/// <returns>Shared, read-only indexed mesh</returns>
+		virtual std::shared_ptr<const IndexedMesh> getMesh() const;
+
+		/// <summary>
+		/// Is the shared object tessellated in levels of detail?
+		/// </summary>
+		/// <returns>Levels of detail?</returns>
+		virtual bool hasLevelsOfDetail() const;
+
+		/// <summary>
+		/// Return the shared object's cached mesh for a level of detail
+		/// </summary>
+		/// <param name="level">Level of detail</param>
+		/// <returns>Shared, read-only indexed mesh</returns>
+		virtual std::shared_ptr<const IndexedMesh> getLevelOfDetailMesh(unsigned int level) const;
+
+		/// <summary>
+		/// Return the shared object's bounding sphere
+		/// </summary>
+		/// <returns>Bounding sphere</returns>
+		virtual BoundingSphere calculateBoundingSphere() const;
+
+		/// <summary>
+		/// Get the version of the instance, which also changes if the shared object is modified
+		/// </summary>
+		/// <returns>Mesh version</returns>
+		virtual unsigned int getMeshVersion() const;
+
+		/// <summary>
+		/// Return the instance color, which is applied while drawing instead of being part of the mesh
+		/// </summary>
+		/// <returns>Instance color</returns>
+		virtual Color getMeshColor() const;
+
+		/// <summary>
+		/// Get the shared object
+		/// </summary>
+		/// <returns>Shared object</returns>
+		std::shared_ptr<const SceneObject> getObject() const;
+
+	private:
+		/// Shared object
+		std::shared_ptr<const SceneObject> object;
+	};
+}
\ No newline at end of file
@@ -1,14 +1,132 @@
 #include "SceneObject.h"
 
-cg::SceneObject::SceneObject(const Color& color) : color(color)
+cg::SceneObject::SceneObject(const Color& color)
+	: color(color), backFaceCulling(false), boundingSphere{ zeroVec3(), 0.0f }, meshVersion(0), boundingSphereVersion(0), hasBoundingSphere(false)
 { }
 
-cg::Color& cg::SceneObject::accessColor()
+cg::SceneObject::SceneObject(const SceneObject& other) : Object(other), color(other.color), backFaceCulling(other.backFaceCulling)
 {
-	return this->color;
+	std::lock_guard<std::mutex> lock(other.meshMutex);
+
+	this->mesh = other.mesh;
+	this->boundingSphere = other.boundingSphere;
+	this->meshVersion = other.meshVersion;
+	this->boundingSphereVersion = other.boundingSphereVersion;
+	this->hasBoundingSphere = other.hasBoundingSphere;
+}
+
+cg::SceneObject& cg::SceneObject::operator=(const SceneObject& other)
+{
+	if (this != &other)
+	{
+		Object::operator=(other);
+		this->color = other.color;
+		this->backFaceCulling = other.backFaceCulling;
+
+		std::lock(this->meshMutex, other.meshMutex);
+		std::lock_guard<std::mutex> lock(this->meshMutex, std::adopt_lock);
+		std::lock_guard<std::mutex> other_lock(other.meshMutex, std::adopt_lock);
+
+		this->mesh = other.mesh;
+		this->boundingSphere = other.boundingSphere;
+		this->meshVersion = other.meshVersion;
+		this->boundingSphereVersion = other.boundingSphereVersion;
+		this->hasBoundingSphere = other.hasBoundingSphere;
+	}
+
+	return *this;
+}
+
+cg::TriangleMesh cg::SceneObject::calculateMesh() const
+{
+	return expandMesh(calculateIndexedMesh());
+}
+
+std::shared_ptr<const cg::IndexedMesh> cg::SceneObject::getMesh() const
+{
+	std::lock_guard<std::mutex> lock(this->meshMutex);
+
+	const auto version = getMeshVersion();
+
+	if (this->mesh == nullptr || this->meshVersion != version)
+	{
+		this->mesh = std::make_shared<const IndexedMesh>(calculateIndexedMesh());
+		this->meshVersion = version;
+	}
+
+	return this->mesh;
+}
+
+bool cg::SceneObject::hasLevelsOfDetail() const
+{
+	return false;
+}
+
+std::shared_ptr<const cg::IndexedMesh> cg::SceneObject::getLevelOfDetailMesh(unsigned int) const
+{
+	return getMesh();
+}
+
+cg::BoundingSphere cg::SceneObject::calculateBoundingSphere() const
+{
+	return cg::calculateBoundingSphere(*getMesh());
+}
+
+cg::BoundingSphere cg::SceneObject::getBoundingSphere() const
+{
+	const auto version = getMeshVersion();
+
+	{
+		std::lock_guard<std::mutex> lock(this->meshMutex);
+
+		if (this->hasBoundingSphere && this->boundingSphereVersion == version)
+		{
+			return this->boundingSphere;
+		}
+	}
+
+	// Calculate without holding the lock, as the calculation may need the mesh
+	const auto sphere = calculateBoundingSphere();
+
+	std::lock_guard<std::mutex> lock(this->meshMutex);
+
+	this->boundingSphere = sphere;
+	this->boundingSphereVersion = version;
+	this->hasBoundingSphere = true;
+
+	return sphere;
+}
+
+unsigned int cg::SceneObject::getMeshVersion() const
+{
+	return Object::version;
+}
+
+cg::Color cg::SceneObject::getMeshColor() const
+{
+	return white();
 }
 
 cg::Color cg::SceneObject::getColor() const
 {
 	return this->color;
+}
+
+void cg::SceneObject::setColor(const Color& color)
+{
+	if (this->color != color)
+	{
+		this->color = color;
+		++Object::version;
+	}
+}
+
+bool& cg::SceneObject::accessBackFaceCulling()
+{
+	return this->backFaceCulling;
+}
+
+bool cg::SceneObject::isBackFaceCulled() const
+{
+	return this->backFaceCulling;
 }
\ No newline at end of file
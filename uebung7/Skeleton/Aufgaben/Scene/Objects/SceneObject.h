@@ -3,6 +3,9 @@
 #include "../../Math.h"
 #include "../Object.h"
 
+#include <memory>
+#include <mutex>
+
 namespace cg
 {
 	/// <summary>
@@ -17,17 +20,68 @@ namespace cg
 		/// <param name="color">Object color</param>
 		SceneObject(const Color& color = white());
 
+		/// <summary>
+		/// Copy constructor and assignment (the copy shares the cached mesh)
+		/// </summary>
+		/// <param name="other">Object to copy</param>
+		SceneObject(const SceneObject& other);
+		SceneObject& operator=(const SceneObject& other);
+
+		/// <summary>
+		/// Calculate and return an indexed mesh representing the object
+		/// </summary>
+		/// <returns>Indexed mesh</returns>
+		virtual IndexedMesh calculateIndexedMesh() const = 0;
+
 		/// <summary>
 		/// Calculate and return a triangle mesh representing the object
 		/// </summary>
 		/// <returns>Triangle mesh</returns>
-		virtual TriangleMesh calculateMesh() const = 0;
+		virtual TriangleMesh calculateMesh() const;
 
 		/// <summary>
-		/// Access object's color
+		/// Return the cached indexed mesh, which is only recalculated if the object was modified
 		/// </summary>
-		/// <returns>Object color</returns>
-		Color& accessColor();
+		/// <returns>Shared, read-only indexed mesh</returns>
+		virtual std::shared_ptr<const IndexedMesh> getMesh() const;
+
+		/// <summary>
+		/// Is the object tessellated in levels of detail, which are selected with Sphere::selectLevelOfDetail?
+		/// </summary>
+		/// <returns>Levels of detail?</returns>
+		virtual bool hasLevelsOfDetail() const;
+
+		/// <summary>
+		/// Return the cached indexed mesh for a level of detail, by default the object's only mesh
+		/// </summary>
+		/// <param name="level">Level of detail</param>
+		/// <returns>Shared, read-only indexed mesh</returns>
+		virtual std::shared_ptr<const IndexedMesh> getLevelOfDetailMesh(unsigned int level) const;
+
+		/// <summary>
+		/// Calculate the bounding sphere in object space, by default from the mesh
+		/// </summary>
+		/// <returns>Bounding sphere</returns>
+		virtual BoundingSphere calculateBoundingSphere() const;
+
+		/// <summary>
+		/// Return the cached bounding sphere, which is only recalculated if the object was modified
+		/// </summary>
+		/// <returns>Bounding sphere</returns>
+		BoundingSphere getBoundingSphere() const;
+
+		/// <summary>
+		/// Get the version of the object's mesh, which changes whenever the mesh has to be recalculated
+		/// </summary>
+		/// <returns>Mesh version</returns>
+		virtual unsigned int getMeshVersion() const;
+
+		/// <summary>
+		/// Return the color the mesh's vertex colors are multiplied with while drawing,
+		/// which is white for objects whose color is already part of their mesh
+		/// </summary>
+		/// <returns>Mesh color</returns>
+		virtual Color getMeshColor() const;
 
 		/// <summary>
 		/// Return the object's color
@@ -35,8 +89,38 @@ namespace cg
 		/// <returns>Object color</returns>
 		Color getColor() const;
 
+		/// <summary>
+		/// Set the object's color; there is no mutable accessor, as the color may be part of the cached mesh
+		/// </summary>
+		/// <param name="color">Object color</param>
+		void setColor(const Color& color);
+
+		/// <summary>
+		/// Access back-face culling property, i.e., whether triangles facing away from the camera are discarded
+		/// </summary>
+		/// <returns>Back-face culling</returns>
+		bool& accessBackFaceCulling();
+
+		/// <summary>
+		/// Are back-facing triangles discarded?
+		/// </summary>
+		/// <returns>Back-face culling?</returns>
+		bool isBackFaceCulled() const;
+
 	protected:
 		/// Object color
 		Color color;
+
+		/// Back-face culling
+		bool backFaceCulling;
+
+	private:
+		/// Cached mesh and bounding sphere, and the mesh versions they were calculated for
+		mutable std::shared_ptr<const IndexedMesh> mesh;
+		mutable BoundingSphere boundingSphere;
+		mutable unsigned int meshVersion;
+		mutable unsigned int boundingSphereVersion;
+		mutable bool hasBoundingSphere;
+		mutable std::mutex meshMutex;
 	};
 }
\ No newline at end of file
@@ -1,64 +1,146 @@
 #include "Sphere.h"
 
+#include <cmath>
+
 cg::Sphere::Sphere(const float radius, const unsigned int tetaResolution, const unsigned int phiResolution, const Color& color)
 	: SceneObject(color), radius(radius), tetaResolution(tetaResolution), phiResolution(phiResolution)
+{
+	// Closed surface, the back faces are always hidden
+	SceneObject::backFaceCulling = true;
+}
+
+cg::Sphere::Sphere(const Sphere& other)
+	: SceneObject(other), radius(other.radius), tetaResolution(other.tetaResolution), phiResolution(other.phiResolution)
 { }
 
+cg::Sphere& cg::Sphere::operator=(const Sphere& other)
+{
+	if (this != &other)
+	{
+		SceneObject::operator=(other);
+		this->radius = other.radius;
+		this->tetaResolution = other.tetaResolution;
+		this->phiResolution = other.phiResolution;
+
+		std::lock_guard<std::mutex> lock(this->levelMutex);
+
+		this->levelMeshes.fill(nullptr);
+	}
+
+	return *this;
+}
+
 std::string cg::Sphere::getShapeName() const
 {
 	return "Sphere";
 }
 
-cg::TriangleMesh cg::Sphere::calculateMesh() const
+cg::BoundingSphere cg::Sphere::calculateBoundingSphere() const
+{
+	return BoundingSphere{ zeroVec3(), std::abs(this->radius) };
+}
+
+unsigned int cg::Sphere::selectLevelOfDetail(const float screenRadius, const float maxError)
+{
+	// The largest deviation of a polygon with n segments from its circle is r * (1 - cos(pi / n)),
+	// so use the first level, whose segments are fine enough
+	for (unsigned int level = 0; level < numLevelsOfDetail - 1; ++level)
+	{
+		const auto segments = static_cast<float>(8u << level);
+
+		if (screenRadius * (1.0f - std::cos(pi() / segments)) <= maxError)
+		{
+			return level;
+		}
+	}
+
+	return numLevelsOfDetail - 1;
+}
+
+bool cg::Sphere::hasLevelsOfDetail() const
+{
+	return true;
+}
+
+std::shared_ptr<const cg::IndexedMesh> cg::Sphere::getLevelOfDetailMesh(const unsigned int level) const
 {
-	TriangleMesh mesh;
+	std::lock_guard<std::mutex> lock(this->levelMutex);
 
-	const float tetaStep = pi() / this->tetaResolution;
-	const float phiStep = 2.0f * pi() / this->phiResolution;
+	const auto version = getMeshVersion();
 
-	for (unsigned int phiIndex = 0; phiIndex < this->phiResolution; ++phiIndex)
+	auto& mesh = this->levelMeshes[level];
+
+	if (mesh == nullptr || this->levelVersions[level] != version)
 	{
-		const float phiLeft = phiIndex * phiStep;
-		const float phiRight = ((phiIndex + 1) % this->phiResolution) * phiStep;
+		const auto phiResolution = 8u << level;
 
-		const vec3 triangleNormal_1 = sphericalToCartesian(1.0f, tetaStep, phiLeft);
-		const vec3 triangleNormal_2 = sphericalToCartesian(1.0f, tetaStep, phiRight);
-		const vec3 triangleNormal_3 = sphericalToCartesian(1.0f, 0.0f, 0.0f);
+		mesh = std::make_shared<const IndexedMesh>(calculateIndexedMesh(phiResolution / 2, phiResolution));
+		this->levelVersions[level] = version;
+	}
 
-		const Triangle::Point trianglePoint_1 = { triangleNormal_1 * this->radius, triangleNormal_1, SceneObject::color };
-		const Triangle::Point trianglePoint_2 = { triangleNormal_2 * this->radius, triangleNormal_2, SceneObject::color };
-		const Triangle::Point trianglePoint_3 = { triangleNormal_3 * this->radius, triangleNormal_3, SceneObject::color };
+	return mesh;
+}
 
-		mesh.push_back(Triangle{ trianglePoint_1, trianglePoint_2, trianglePoint_3 });
+cg::IndexedMesh cg::Sphere::calculateIndexedMesh() const
+{
+	return calculateIndexedMesh(this->tetaResolution, this->phiResolution);
+}
 
-		for (unsigned int tetaIndex = 1; tetaIndex < this->tetaResolution - 1; ++tetaIndex)
-		{
-			const float tetaTop = tetaIndex * tetaStep;
-			const float tetaBottom = ((tetaIndex + 1) % this->tetaResolution) * tetaStep;
+cg::IndexedMesh cg::Sphere::calculateIndexedMesh(const unsigned int tetaResolution, const unsigned int phiResolution) const
+{
+	IndexedMesh mesh;
+
+	const float tetaStep = pi() / tetaResolution;
+	const float phiStep = 2.0f * pi() / phiResolution;
+
+	// Create the vertices: north pole, rings of constant teta, south pole
+	const auto addVertex = [this, &mesh](const float teta, const float phi)
+	{
+		const vec3 normal = sphericalToCartesian(1.0f, teta, phi);
+		mesh.vertices.push_back(Triangle::Point{ normal * this->radius, normal, SceneObject::color });
+	};
 
-			const vec3 quadNormal_1 = sphericalToCartesian(1.0f, tetaTop, phiLeft);
-			const vec3 quadNormal_2 = sphericalToCartesian(1.0f, tetaTop, phiRight);
-			const vec3 quadNormal_3 = sphericalToCartesian(1.0f, tetaBottom, phiLeft);
-			const vec3 quadNormal_4 = sphericalToCartesian(1.0f, tetaBottom, phiRight);
+	mesh.vertices.reserve(2 + (tetaResolution - 1) * phiResolution);
 
-			const Triangle::Point quadPoint_1 = { quadNormal_1 * this->radius, quadNormal_1, SceneObject::color };
-			const Triangle::Point quadPoint_2 = { quadNormal_2 * this->radius, quadNormal_2, SceneObject::color };
-			const Triangle::Point quadPoint_3 = { quadNormal_3 * this->radius, quadNormal_3, SceneObject::color };
-			const Triangle::Point quadPoint_4 = { quadNormal_4 * this->radius, quadNormal_4, SceneObject::color };
+	addVertex(0.0f, 0.0f);
 
-			mesh.push_back(Triangle{ quadPoint_1, quadPoint_3, quadPoint_2 });
-			mesh.push_back(Triangle{ quadPoint_3, quadPoint_4, quadPoint_2 });
+	for (unsigned int tetaIndex = 1; tetaIndex < tetaResolution; ++tetaIndex)
+	{
+		for (unsigned int phiIndex = 0; phiIndex < phiResolution; ++phiIndex)
+		{
+			addVertex(tetaIndex * tetaStep, phiIndex * phiStep);
 		}
+	}
+
+	addVertex(pi(), 0.0f);
+
+	const unsigned int northPole = 0;
+	const unsigned int southPole = static_cast<unsigned int>(mesh.vertices.size() - 1);
+
+	const auto ringVertex = [phiResolution](const unsigned int tetaIndex, const unsigned int phiIndex)
+	{
+		return 1 + (tetaIndex - 1) * phiResolution + phiIndex % phiResolution;
+	};
+
+	// Create the triangles, counter-clockwise when looking from outside
+	mesh.indices.reserve(6 * (tetaResolution - 1) * phiResolution);
+
+	for (unsigned int phiIndex = 0; phiIndex < phiResolution; ++phiIndex)
+	{
+		mesh.indices.insert(mesh.indices.end(), { ringVertex(1, phiIndex), ringVertex(1, phiIndex + 1), northPole });
 
-		const vec3 triangleNormal_4 = sphericalToCartesian(1.0f, pi() - tetaStep, phiLeft);
-		const vec3 triangleNormal_5 = sphericalToCartesian(1.0f, pi() - tetaStep, phiRight);
-		const vec3 triangleNormal_6 = sphericalToCartesian(1.0f, pi(), 0.0f);
+		for (unsigned int tetaIndex = 1; tetaIndex < tetaResolution - 1; ++tetaIndex)
+		{
+			const auto quad_1 = ringVertex(tetaIndex, phiIndex);
+			const auto quad_2 = ringVertex(tetaIndex, phiIndex + 1);
+			const auto quad_3 = ringVertex(tetaIndex + 1, phiIndex);
+			const auto quad_4 = ringVertex(tetaIndex + 1, phiIndex + 1);
 
-		const Triangle::Point trianglePoint_4 = { triangleNormal_4 * this->radius, triangleNormal_4, SceneObject::color };
-		const Triangle::Point trianglePoint_5 = { triangleNormal_5 * this->radius, triangleNormal_5, SceneObject::color };
-		const Triangle::Point trianglePoint_6 = { triangleNormal_6 * this->radius, triangleNormal_6, SceneObject::color };
+			mesh.indices.insert(mesh.indices.end(), { quad_1, quad_3, quad_2 });
+			mesh.indices.insert(mesh.indices.end(), { quad_3, quad_4, quad_2 });
+		}
 
-		mesh.push_back(Triangle{ trianglePoint_4, trianglePoint_5, trianglePoint_6 });
+		mesh.indices.insert(mesh.indices.end(), { ringVertex(tetaResolution - 1, phiIndex + 1), ringVertex(tetaResolution - 1, phiIndex), southPole });
 	}
 
 	return mesh;
@@ -2,6 +2,10 @@
 
 #include "SceneObject.h"
 
+#include <array>
+#include <memory>
+#include <mutex>
+
 namespace cg
 {
 	/// <summary>
@@ -19,6 +23,13 @@ namespace cg
 		/// <param name="color">Color of the cube</param>
 		Sphere(float radius = 1.0f, unsigned int tetaResolution = 25, unsigned int phiResolution = 50, const Color& color = oneVec4());
 
+		/// <summary>
+		/// Copy constructor and assignment (the copy calculates its own levels of detail)
+		/// </summary>
+		/// <param name="other">Sphere to copy</param>
+		Sphere(const Sphere& other);
+		Sphere& operator=(const Sphere& other);
+
 		/// <summary>
 		/// Return the name of the shape
 		/// </summary>
@@ -26,17 +37,60 @@ namespace cg
 		virtual std::string getShapeName() const;
 
 		/// <summary>
-		/// Calculate and return a triangle mesh representing the object
+		/// Calculate and return an indexed mesh representing the object
+		/// </summary>
+		/// <returns>Indexed mesh</returns>
+		virtual IndexedMesh calculateIndexedMesh() const;
+
+		/// <summary>
+		/// Calculate the bounding sphere, which is the sphere itself
+		/// </summary>
+		/// <returns>Bounding sphere</returns>
+		virtual BoundingSphere calculateBoundingSphere() const;
+
+		/// <summary>
+		/// Select the coarsest level of detail, whose deviation from the exact sphere is within the given error
 		/// </summary>
-		/// <returns>Triangle mesh</returns>
-		virtual TriangleMesh calculateMesh() const;
+		/// <param name="screenRadius">Projected radius in pixels</param>
+		/// <param name="maxError">Maximum deviation in pixels</param>
+		/// <returns>Level of detail</returns>
+		static unsigned int selectLevelOfDetail(float screenRadius, float maxError);
+
+		/// <summary>
+		/// Is the sphere tessellated in levels of detail? Always true
+		/// </summary>
+		/// <returns>Levels of detail?</returns>
+		virtual bool hasLevelsOfDetail() const;
+
+		/// <summary>
+		/// Return the cached indexed mesh for a level of detail, which is only recalculated if the sphere was modified
+		/// </summary>
+		/// <param name="level">Level of detail</param>
+		/// <returns>Shared, read-only indexed mesh</returns>
+		virtual std::shared_ptr<const IndexedMesh> getLevelOfDetailMesh(unsigned int level) const;
+
+		/// Number of levels of detail, of which level l has 8 * 2^l segments around the sphere
+		static const unsigned int numLevelsOfDetail = 6;
 
 	private:
+		/// <summary>
+		/// Calculate and return an indexed mesh with the given resolution
+		/// </summary>
+		/// <param name="tetaResolution">Resolution for spherical coordinate teta</param>
+		/// <param name="phiResolution">Resolution for spherical coordinate phi</param>
+		/// <returns>Indexed mesh</returns>
+		IndexedMesh calculateIndexedMesh(unsigned int tetaResolution, unsigned int phiResolution) const;
+
 		/// Radius
 		float radius;
 
 		/// Resolution for creating the mesh
 		unsigned int tetaResolution;
 		unsigned int phiResolution;
+
+		/// Cached meshes of the levels of detail, and the mesh versions they were calculated for
+		mutable std::array<std::shared_ptr<const IndexedMesh>, numLevelsOfDetail> levelMeshes;
+		mutable std::array<unsigned int, numLevelsOfDetail> levelVersions;
+		mutable std::mutex levelMutex;
 	};
 }
\ No newline at end of file
@@ -14,9 +14,9 @@ namespace cg
 		virtual std::string getShapeName() const;
 
 		/// <summary>
-		/// Create the mesh for the triangle
+		/// Create the indexed mesh for the triangle
 		/// </summary>
-		/// <returns></returns>
-		cg::TriangleMesh calculateMesh() const;
+		/// <returns>Indexed mesh</returns>
+		virtual cg::IndexedMesh calculateIndexedMesh() const;
 	};
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ void cg::Scene::addObject(std::shared_ptr<SceneObject> object)
 	this->objects.push_back(object);
 }
 
-std::vector<std::shared_ptr<cg::SceneObject>> cg::Scene::getObjects()
+const std::vector<std::shared_ptr<cg::SceneObject>>& cg::Scene::getObjects() const
 {
 	return this->objects;
 }
@@ -18,7 +18,7 @@ void cg::Scene::addLight(std::shared_ptr<LightObject> light)
 	this->lights.push_back(light);
 }
 
-std::vector<std::shared_ptr<cg::LightObject>> cg::Scene::getLights()
+const std::vector<std::shared_ptr<cg::LightObject>>& cg::Scene::getLights() const
 {
 	return this->lights;
 }
@@ -31,7 +31,7 @@ namespace cg
 		/// Get objects
 		/// </summary>
 		/// <returns>Scene objects</returns>
-		std::vector<std::shared_ptr<SceneObject>> getObjects();
+		const std::vector<std::shared_ptr<SceneObject>>& getObjects() const;
 
 		/// <summary>
 		/// Add light source to the scene
@@ -43,7 +43,7 @@ namespace cg
 		/// Get light sources
 		/// </summary>
 		/// <returns>Light sources</returns>
-		std::vector<std::shared_ptr<LightObject>> getLights();
+		const std::vector<std::shared_ptr<LightObject>>& getLights() const;
 
 		/// <summary>
 		/// Get scene name
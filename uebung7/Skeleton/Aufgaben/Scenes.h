@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Scene/Scene.h"
+
+#include <vector>
+
+namespace cg
+{
+	/// <summary>
+	/// Create test scene with a single triangle
+	/// </summary>
+	/// <returns>Scene</returns>
+	Scene createTriangle();
+
+	/// <summary>
+	/// Create test scene with a cube
+	/// </summary>
+	/// <returns>Scene</returns>
+	Scene createCube();
+
+	/// <summary>
+	/// Create test scene with a sphere
+	/// </summary>
+	/// <returns>Scene</returns>
+	Scene createSphere();
+
+	/// <summary>
+	/// Create scene with three objects, each composed of a cube and two spheres
+	/// </summary>
+	/// <returns>Scene</returns>
+	Scene createComplexScene();
+
+	/// <summary>
+	/// Create own scene
+	/// </summary>
+	/// <returns>Scene</returns>
+	Scene createOwnScene();
+
+	/// <summary>
+	/// Create all scenes, shared by the interactive viewer and the headless renderer
+	/// </summary>
+	/// <returns>Scenes</returns>
+	std::vector<Scene> createScenes();
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+#pragma once
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CG_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CG_SIMD_SSE
+#endif
+
+#include <array>
+#include <cmath>
+
+namespace cg
+{
+	namespace simd
+	{
+		/// <summary>
+		/// Vector of floats using the widest instruction set available at compile time
+		/// (AVX: 8 lanes, SSE: 4 lanes, otherwise a scalar fallback with 4 lanes)
+		/// </summary>
+		struct float_v
+		{
+#if defined(CG_SIMD_AVX)
+			static constexpr unsigned int size = 8;
+			using native_type = __m256;
+#elif defined(CG_SIMD_SSE)
+			static constexpr unsigned int size = 4;
+			using native_type = __m128;
+#else
+			static constexpr unsigned int size = 4;
+			using native_type = std::array<float, size>;
+#endif
+
+			native_type value;
+
+			float_v() = default;
+			float_v(native_type value) : value(value) { }
+			float_v(float scalar);
+
+			/// <summary>
+			/// Load from or store to (unaligned) memory
+			/// </summary>
+			static float_v load(const float* memory);
+			void store(float* memory) const;
+
+			/// <summary>
+			/// Return the vector (0, 1, 2, ..., size - 1)
+			/// </summary>
+			static float_v ramp();
+		};
+
+		float_v operator+(const float_v& lhs, const float_v& rhs);
+		float_v operator-(const float_v& lhs, const float_v& rhs);
+		float_v operator*(const float_v& lhs, const float_v& rhs);
+		float_v operator/(const float_v& lhs, const float_v& rhs);
+
+		float_v min(const float_v& lhs, const float_v& rhs);
+		float_v max(const float_v& lhs, const float_v& rhs);
+		float_v sqrt(const float_v& vector);
+
+		/// <summary>
+		/// Compare lane-wise and return one bit per lane (lowest bit for lane 0)
+		/// </summary>
+		unsigned int greater_equal(const float_v& lhs, const float_v& rhs);
+		unsigned int greater(const float_v& lhs, const float_v& rhs);
+		unsigned int less(const float_v& lhs, const float_v& rhs);
+	}
+}
+
+#if defined(CG_SIMD_AVX)
+
+inline cg::simd::float_v::float_v(const float scalar) : value(_mm256_set1_ps(scalar)) { }
+inline cg::simd::float_v cg::simd::float_v::load(const float* memory) { return _mm256_loadu_ps(memory); }
+inline void cg::simd::float_v::store(float* memory) const { _mm256_storeu_ps(memory, this->value); }
+inline cg::simd::float_v cg::simd::float_v::ramp() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+
+inline cg::simd::float_v cg::simd::operator+(const float_v& lhs, const float_v& rhs) { return _mm256_add_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::operator-(const float_v& lhs, const float_v& rhs) { return _mm256_sub_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::operator*(const float_v& lhs, const float_v& rhs) { return _mm256_mul_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::operator/(const float_v& lhs, const float_v& rhs) { return _mm256_div_ps(lhs.value, rhs.value); }
+
+inline cg::simd::float_v cg::simd::min(const float_v& lhs, const float_v& rhs) { return _mm256_min_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::max(const float_v& lhs, const float_v& rhs) { return _mm256_max_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::sqrt(const float_v& vector) { return _mm256_sqrt_ps(vector.value); }
+
+inline unsigned int cg::simd::greater_equal(const float_v& lhs, const float_v& rhs)
+{
+	return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(lhs.value, rhs.value, _CMP_GE_OQ)));
+}
+
+inline unsigned int cg::simd::greater(const float_v& lhs, const float_v& rhs)
+{
+	return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(lhs.value, rhs.value, _CMP_GT_OQ)));
+}
+
+inline unsigned int cg::simd::less(const float_v& lhs, const float_v& rhs)
+{
+	return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(lhs.value, rhs.value, _CMP_LT_OQ)));
+}
+
+#elif defined(CG_SIMD_SSE)
+
+inline cg::simd::float_v::float_v(const float scalar) : value(_mm_set1_ps(scalar)) { }
+inline cg::simd::float_v cg::simd::float_v::load(const float* memory) { return _mm_loadu_ps(memory); }
+inline void cg::simd::float_v::store(float* memory) const { _mm_storeu_ps(memory, this->value); }
+inline cg::simd::float_v cg::simd::float_v::ramp() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+
+inline cg::simd::float_v cg::simd::operator+(const float_v& lhs, const float_v& rhs) { return _mm_add_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::operator-(const float_v& lhs, const float_v& rhs) { return _mm_sub_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::operator*(const float_v& lhs, const float_v& rhs) { return _mm_mul_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::operator/(const float_v& lhs, const float_v& rhs) { return _mm_div_ps(lhs.value, rhs.value); }
+
+inline cg::simd::float_v cg::simd::min(const float_v& lhs, const float_v& rhs) { return _mm_min_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::max(const float_v& lhs, const float_v& rhs) { return _mm_max_ps(lhs.value, rhs.value); }
+inline cg::simd::float_v cg::simd::sqrt(const float_v& vector) { return _mm_sqrt_ps(vector.value); }
+
+inline unsigned int cg::simd::greater_equal(const float_v& lhs, const float_v& rhs)
+{
+	return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpge_ps(lhs.value, rhs.value)));
+}
+
+inline unsigned int cg::simd::greater(const float_v& lhs, const float_v& rhs)
+{
+	return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpgt_ps(lhs.value, rhs.value)));
+}
+
+inline unsigned int cg::simd::less(const float_v& lhs, const float_v& rhs)
+{
+	return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmplt_ps(lhs.value, rhs.value)));
+}
+
+#else
+
+inline cg::simd::float_v::float_v(const float scalar) { this->value.fill(scalar); }
+inline cg::simd::float_v cg::simd::float_v::ramp() { return native_type{ 0.0f, 1.0f, 2.0f, 3.0f }; }
+
+inline cg::simd::float_v cg::simd::float_v::load(const float* memory)
+{
+	float_v vector;
+	for (unsigned int i = 0; i < size; ++i) vector.value[i] = memory[i];
+	return vector;
+}
+
+inline void cg::simd::float_v::store(float* memory) const
+{
+	for (unsigned int i = 0; i < size; ++i) memory[i] = this->value[i];
+}
+
+namespace cg
+{
+	namespace simd
+	{
+		namespace detail
+		{
+			template <typename operation_type>
+			inline float_v apply(const float_v& lhs, const float_v& rhs, operation_type operation)
+			{
+				float_v result;
+				for (unsigned int i = 0; i < float_v::size; ++i) result.value[i] = operation(lhs.value[i], rhs.value[i]);
+				return result;
+			}
+		}
+	}
+}
+
+inline cg::simd::float_v cg::simd::operator+(const float_v& lhs, const float_v& rhs) { return detail::apply(lhs, rhs, [](float a, float b) { return a + b; }); }
+inline cg::simd::float_v cg::simd::operator-(const float_v& lhs, const float_v& rhs) { return detail::apply(lhs, rhs, [](float a, float b) { return a - b; }); }
+inline cg::simd::float_v cg::simd::operator*(const float_v& lhs, const float_v& rhs) { return detail::apply(lhs, rhs, [](float a, float b) { return a * b; }); }
+inline cg::simd::float_v cg::simd::operator/(const float_v& lhs, const float_v& rhs) { return detail::apply(lhs, rhs, [](float a, float b) { return a / b; }); }
+
+inline cg::simd::float_v cg::simd::min(const float_v& lhs, const float_v& rhs) { return detail::apply(lhs, rhs, [](float a, float b) { return a < b ? a : b; }); }
+inline cg::simd::float_v cg::simd::max(const float_v& lhs, const float_v& rhs) { return detail::apply(lhs, rhs, [](float a, float b) { return a > b ? a : b; }); }
+inline cg::simd::float_v cg::simd::sqrt(const float_v& vector) { return detail::apply(vector, vector, [](float a, float) { return std::sqrt(a); }); }
+
+inline unsigned int cg::simd::greater_equal(const float_v& lhs, const float_v& rhs)
+{
+	unsigned int bits = 0;
+	for (unsigned int i = 0; i < float_v::size; ++i) bits |= (lhs.value[i] >= rhs.value[i]) ? (1u << i) : 0u;
+	return bits;
+}
+
+inline unsigned int cg::simd::greater(const float_v& lhs, const float_v& rhs)
+{
+	unsigned int bits = 0;
+	for (unsigned int i = 0; i < float_v::size; ++i) bits |= (lhs.value[i] > rhs.value[i]) ? (1u << i) : 0u;
+	return bits;
+}
+
+inline unsigned int cg::simd::less(const float_v& lhs, const float_v& rhs)
+{
+	unsigned int bits = 0;
+	for (unsigned int i = 0; i < float_v::size; ++i) bits |= (lhs.value[i] < rhs.value[i]) ? (1u << i) : 0u;
+	return bits;
+}
+
+#endif
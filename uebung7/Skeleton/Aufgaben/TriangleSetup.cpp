@@ -0,0 +1,79 @@
+#include "TriangleSetup.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool cg::setupTriangle(const Triangle& triangle, TriangleSetup& setup)
+{
+	const auto& p0 = triangle.points[0].position;
+	const auto& p1 = triangle.points[1].position;
+	const auto& p2 = triangle.points[2].position;
+
+	setup.x_min = static_cast<int>(std::round(std::min({ p0.x, p1.x, p2.x })));
+	setup.x_max = static_cast<int>(std::round(std::max({ p0.x, p1.x, p2.x })));
+	setup.y_min = static_cast<int>(std::round(std::min({ p0.y, p1.y, p2.y })));
+	setup.y_max = static_cast<int>(std::round(std::max({ p0.y, p1.y, p2.y })));
+
+	setup.z_min = std::min({ p0.z, p1.z, p2.z });
+	setup.z_max = std::max({ p0.z, p1.z, p2.z });
+
+	// Use the bounding box corner as origin to keep the edge function values small
+	const double origin_x = setup.x_min;
+	const double origin_y = setup.y_min;
+
+	const std::array<const Point3D*, 3> corners = { &p0, &p1, &p2 };
+
+	std::array<double, 3> a, b, c;
+
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		const auto& start = *corners[(i + 1) % 3];
+		const auto& end = *corners[(i + 2) % 3];
+
+		a[i] = static_cast<double>(start.y) - static_cast<double>(end.y);
+		b[i] = static_cast<double>(end.x) - static_cast<double>(start.x);
+		c[i] = -(a[i] * (start.x - origin_x) + b[i] * (start.y - origin_y));
+	}
+
+	// Twice the signed area; flip the edges of clockwise triangles, so that the inside is always positive
+	auto area = a[0] * (p0.x - origin_x) + b[0] * (p0.y - origin_y) + c[0];
+
+	if (area == 0.0)
+	{
+		return false;
+	}
+
+	const double sign = (area < 0.0) ? -1.0 : 1.0;
+	area *= sign;
+
+	setup.area = static_cast<float>(area);
+
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		setup.edge_a[i] = static_cast<float>(sign * a[i]);
+		setup.edge_b[i] = static_cast<float>(sign * b[i]);
+		setup.edge_c[i] = static_cast<float>(sign * c[i]);
+	}
+
+	// Barycentric weight i is edge function i divided by the area, which makes each attribute a plane
+	for (unsigned int attribute = 0; attribute < TriangleSetup::NUM_ATTRIBUTES; ++attribute)
+	{
+		double dx = 0.0, dy = 0.0, offset = 0.0;
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			const auto& point = triangle.points[i];
+			const double value = (attribute == TriangleSetup::DEPTH) ? point.position.z : point.color[attribute - TriangleSetup::RED];
+
+			dx += sign * a[i] * value;
+			dy += sign * b[i] * value;
+			offset += sign * c[i] * value;
+		}
+
+		setup.plane_dx[attribute] = static_cast<float>(dx / area);
+		setup.plane_dy[attribute] = static_cast<float>(dy / area);
+		setup.plane_offset[attribute] = static_cast<float>(offset / area);
+	}
+
+	return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Math.h"
+
+#include <array>
+
+namespace cg
+{
+	/// <summary>
+	/// Per-triangle data for edge function rasterization, computed once per triangle
+	/// </summary>
+	struct TriangleSetup
+	{
+		/// Interpolated attributes: depth and the four color channels
+		enum attribute_t
+		{
+			DEPTH, RED, GREEN, BLUE, ALPHA, NUM_ATTRIBUTES
+		};
+
+		/// Bounding box of the triangle in pixels (not clamped to the image)
+		int x_min, y_min, x_max, y_max;
+
+		/// Edge functions e(x, y) = a * (x - x_min) + b * (y - y_min) + c,
+		/// non-negative inside the triangle; edge i is opposite to corner i
+		std::array<float, 3> edge_a, edge_b, edge_c;
+
+		/// Twice the area of the triangle; edge function i divided by it is the barycentric weight of corner i
+		float area;
+
+		/// Attribute planes v(x, y) = dx * (x - x_min) + dy * (y - y_min) + offset
+		std::array<float, NUM_ATTRIBUTES> plane_dx, plane_dy, plane_offset;
+
+		/// Depth range of the triangle
+		float z_min, z_max;
+	};
+
+	/// <summary>
+	/// Compute edge equations and attribute planes of a screen space triangle
+	/// </summary>
+	/// <param name="triangle">Triangle in screen space</param>
+	/// <param name="setup">Resulting triangle setup</param>
+	/// <returns>False if the triangle is degenerate, i.e., does not cover any area</returns>
+	bool setupTriangle(const Triangle& triangle, TriangleSetup& setup);
+}
@@ -0,0 +1,98 @@
+#include "VertexTransform.h"
+#include "Clipping.h"
+
+namespace
+{
+	/// <summary>
+	/// Broadcast the rows of a matrix, so that each transformed component is a dot product with the position
+	/// </summary>
+	void broadcastRows(const cg::mat4& matrix, std::array<std::array<cg::simd::float_v, 4>, 4>& rows)
+	{
+		for (unsigned int row = 0; row < 4; ++row)
+		{
+			for (unsigned int column = 0; column < 4; ++column)
+			{
+				rows[row][column] = cg::simd::float_v(matrix[column][row]);
+			}
+		}
+	}
+}
+
+void cg::setupVertexTransform(const mat4& model, const mat4& viewProjection, const float width, const float height, const float guardBand,
+	VertexTransform& transform)
+{
+	// Combine the transformations once per object instead of transforming each vertex twice
+	broadcastRows(model, transform.model);
+	broadcastRows(viewProjection * model, transform.modelViewProjection);
+
+	transform.width = simd::float_v(width);
+	transform.height = simd::float_v(height);
+	transform.guardBand = simd::float_v(guardBand);
+}
+
+void cg::transformVertices(const VertexTransform& transform, const std::array<simd::float_v, 3>& position, VertexBatch& batch)
+{
+	using simd::float_v;
+
+	const auto& x = position[0];
+	const auto& y = position[1];
+	const auto& z = position[2];
+
+	for (unsigned int row = 0; row < 3; ++row)
+	{
+		const auto& model = transform.model[row];
+
+		batch.world[row] = model[0] * x + model[1] * y + model[2] * z + model[3];
+	}
+
+	for (unsigned int row = 0; row < 4; ++row)
+	{
+		const auto& modelViewProjection = transform.modelViewProjection[row];
+
+		batch.clip[row] = modelViewProjection[0] * x + modelViewProjection[1] * y + modelViewProjection[2] * z + modelViewProjection[3];
+	}
+
+	const auto& clip_x = batch.clip[0];
+	const auto& clip_y = batch.clip[1];
+	const auto& clip_z = batch.clip[2];
+	const auto& clip_w = batch.clip[3];
+
+	const auto zero = float_v(0.0f);
+	const auto negative_w = zero - clip_w;
+
+	batch.validXY = greater(clip_x, negative_w) & less(clip_x, clip_w) & greater(clip_y, negative_w) & less(clip_y, clip_w);
+	batch.validZ = greater(clip_z, negative_w) & less(clip_z, clip_w);
+
+	// Per plane the lanes outside of it, transposed into per lane outcodes
+	const auto guard_w = transform.guardBand * clip_w;
+
+	const std::array<unsigned int, 6> outside =
+	{
+		less(clip_z + clip_w, zero), less(clip_w - clip_z, zero),
+		less(clip_x + guard_w, zero), less(guard_w - clip_x, zero),
+		less(clip_y + guard_w, zero), less(guard_w - clip_y, zero)
+	};
+
+	const std::array<unsigned int, 6> planes = { CLIP_NEAR, CLIP_FAR, CLIP_LEFT, CLIP_RIGHT, CLIP_BOTTOM, CLIP_TOP };
+
+	for (unsigned int lane = 0; lane < float_v::size; ++lane)
+	{
+		unsigned int outcode = 0;
+
+		for (unsigned int plane = 0; plane < planes.size(); ++plane)
+		{
+			outcode |= (outside[plane] >> lane & 1u) ? planes[plane] : 0u;
+		}
+
+		batch.outcodes[lane] = outcode;
+	}
+
+	// Perspective divide and viewport mapping
+	const auto half = float_v(0.5f);
+	const auto x_ndc = clip_x / clip_w;
+	const auto y_ndc = clip_y / clip_w;
+
+	batch.screen[0] = (x_ndc * half + half) * transform.width;
+	batch.screen[1] = (y_ndc * float_v(-0.5f) + half) * transform.height;
+	batch.screen[2] = clip_z / clip_w;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Math.h"
+#include "Simd.h"
+
+#include <array>
+
+namespace cg
+{
+	/// <summary>
+	/// Transformations of an object, prepared once per object, so that its vertices can be transformed
+	/// for several vertices at once; each matrix is stored as its rows broadcast to SIMD vectors
+	/// </summary>
+	struct VertexTransform
+	{
+		/// Rows of the transformation from object to world space, and from object to clip space
+		std::array<std::array<simd::float_v, 4>, 4> model, modelViewProjection;
+
+		/// Viewport size in pixels
+		simd::float_v width, height;
+
+		/// Extent of the guard band in multiples of the viewport's half size
+		simd::float_v guardBand;
+	};
+
+	/// <summary>
+	/// Batch of transformed vertices, stored in one SIMD vector per component
+	/// </summary>
+	struct VertexBatch
+	{
+		/// World space positions (x, y, z)
+		std::array<simd::float_v, 3> world;
+
+		/// Clip space positions (x, y, z, w)
+		std::array<simd::float_v, 4> clip;
+
+		/// Screen space positions (x, y in pixels, z in [-1, 1])
+		std::array<simd::float_v, 3> screen;
+
+		/// One bit per lane: lies within the view frustum in x and y, and in z
+		unsigned int validXY, validZ;
+
+		/// Per lane the clip planes it lies outside of (see computeOutcode)
+		std::array<unsigned int, simd::float_v::size> outcodes;
+	};
+
+	/// <summary>
+	/// Prepare the transformations of an object
+	/// </summary>
+	/// <param name="model">Transformation from object to world space</param>
+	/// <param name="viewProjection">Transformation from world to clip space</param>
+	/// <param name="width">Viewport width in pixels</param>
+	/// <param name="height">Viewport height in pixels</param>
+	/// <param name="guardBand">Extent of the guard band in multiples of the viewport's half size</param>
+	/// <param name="transform">Resulting vertex transformation</param>
+	void setupVertexTransform(const mat4& model, const mat4& viewProjection, float width, float height, float guardBand, VertexTransform& transform);
+
+	/// <summary>
+	/// Transform a batch of object space positions to world, clip and screen space, and classify them against the clip planes
+	/// </summary>
+	/// <param name="transform">Vertex transformation</param>
+	/// <param name="position">Object space positions (x, y, z)</param>
+	/// <param name="batch">Resulting transformed vertices</param>
+	void transformVertices(const VertexTransform& transform, const std::array<simd::float_v, 3>& position, VertexBatch& batch);
+}
\ No newline at end of file